@@ -0,0 +1,59 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    benchserver.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_BENCHSERVER_H_
+#define JSONRPC_CPP_BENCHSERVER_H_
+
+#include <jsonrpccpp/server.h>
+
+namespace jsonrpc
+{
+    /**
+     * The procedures the load generator calls:
+     *  - echo returns its string parameter data.
+     *  - sum returns the sum of the integers in its array parameter values.
+     *  - notify is a notification that ignores its string parameter data.
+     * With a cache ttl, echo and sum are cacheable, see Procedure::SetCacheTtl.
+     */
+    class BenchServer : public AbstractServer<BenchServer>
+    {
+        public:
+            BenchServer(AbstractServerConnector &connector, unsigned int cacheTtl = 0) :
+                AbstractServer<BenchServer>(connector)
+            {
+                Procedure echo("echo", PARAMS_BY_NAME, JSON_STRING, "data", JSON_STRING, NULL);
+                Procedure sum("sum", PARAMS_BY_NAME, JSON_INTEGER, "values", JSON_ARRAY, NULL);
+                echo.SetCacheTtl(cacheTtl);
+                sum.SetCacheTtl(cacheTtl);
+                this->bindAndAddMethod(echo, &BenchServer::Echo);
+                this->bindAndAddMethod(sum, &BenchServer::Sum);
+                this->bindAndAddNotification(Procedure("notify", PARAMS_BY_NAME, "data", JSON_STRING, NULL), &BenchServer::Notify);
+            }
+
+            void Echo(const Json::Value &parameter, Json::Value &result)
+            {
+                result = parameter["data"];
+            }
+
+            void Sum(const Json::Value &parameter, Json::Value &result)
+            {
+                const Json::Value &values = parameter["values"];
+                Json::Int64 sum = 0;
+                for (Json::ArrayIndex i = 0; i < values.size(); i++)
+                    sum += values[i].asInt64();
+                result = sum;
+            }
+
+            void Notify(const Json::Value &parameter)
+            {
+                (void)parameter;
+            }
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_BENCHSERVER_H_ */
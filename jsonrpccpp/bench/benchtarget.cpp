@@ -0,0 +1,256 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    benchtarget.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "benchtarget.h"
+
+#include <sstream>
+#include <unistd.h>
+#include <string.h>
+
+#include <jsonrpccpp/server/connectors/linuxtcpsocketserver.h>
+#include <jsonrpccpp/server/connectors/unixdomainsocketserver.h>
+#include <jsonrpccpp/server/connectors/filedescriptorserver.h>
+#include <jsonrpccpp/client/connectors/linuxtcpsocketclient.h>
+#include <jsonrpccpp/client/connectors/unixdomainsocketclient.h>
+#include <jsonrpccpp/client/connectors/filedescriptorclient.h>
+#ifdef JSONRPCCPP_BENCH_HTTP
+#include <jsonrpccpp/server/connectors/httpserver.h>
+#include <jsonrpccpp/client/connectors/httpclient.h>
+#include <jsonrpccpp/client/connectors/httpclientpool.h>
+#endif
+
+using namespace jsonrpc;
+using namespace std;
+
+static const char* CONNECTOR_NAMES[] = {"tcp", "tcp-reactor", "unix", "fd", "http"};
+
+TargetOptions::TargetOptions() :
+    connector(BENCH_TCP),
+    port(18200),
+    path("/tmp/jsonrpccpp_bench.sock"),
+    keepAlive(true),
+    binary(false),
+    workers(4),
+    loops(1),
+    reusePort(false),
+    httpPool(false),
+    cacheTtl(0),
+    maxRequests(0)
+{
+}
+
+bool TargetOptions::GetConnector(const string &name, benchConnector_t &connector)
+{
+    for (int i = BENCH_TCP; i <= BENCH_HTTP; i++)
+    {
+        if (name == CONNECTOR_NAMES[i])
+        {
+            connector = static_cast<benchConnector_t>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* TargetOptions::GetConnectorName(benchConnector_t connector)
+{
+    return CONNECTOR_NAMES[connector];
+}
+
+BenchTarget::BenchTarget(const TargetOptions &options) :
+    options(options),
+    shared(NULL),
+    listening(false)
+{
+}
+
+BenchTarget::~BenchTarget()
+{
+    this->Stop();
+}
+
+bool BenchTarget::Start(unsigned int clients, RpcMetrics *metrics)
+{
+    switch (this->options.connector)
+    {
+        case BENCH_TCP:
+        case BENCH_TCP_REACTOR:
+        {
+            LinuxTcpSocketServer *server = new LinuxTcpSocketServer("127.0.0.1", this->options.port);
+            server->SetKeepAlive(this->options.keepAlive);
+            server->SetBinaryFraming(this->options.binary);
+            if (this->options.connector == BENCH_TCP_REACTOR)
+            {
+                server->SetReactorMode(this->options.loops, this->options.workers, 4 * clients);
+                server->SetReusePort(this->options.reusePort);
+            }
+            if (!this->AddServer(server, metrics))
+                return false;
+            break;
+        }
+        case BENCH_UNIX:
+        {
+            UnixDomainSocketServer *server = new UnixDomainSocketServer(this->options.path);
+            server->SetKeepAlive(this->options.keepAlive);
+            if (!this->AddServer(server, metrics))
+                return false;
+            break;
+        }
+        case BENCH_FD:
+        {
+            //A FileDescriptorServer reads a single stream, so each client gets its own server.
+            for (unsigned int i = 0; i < clients; i++)
+            {
+                int requests[2], responses[2];
+                if (pipe(requests) != 0)
+                    return false;
+                if (pipe(responses) != 0)
+                {
+                    close(requests[0]);
+                    close(requests[1]);
+                    return false;
+                }
+                this->pipes.push_back(requests[0]);
+                this->pipes.push_back(requests[1]);
+                this->pipes.push_back(responses[0]);
+                this->pipes.push_back(responses[1]);
+                if (!this->AddServer(new FileDescriptorServer(requests[0], responses[1]), metrics))
+                    return false;
+                this->clients.push_back(new FileDescriptorClient(responses[0], requests[1]));
+            }
+            return true;
+        }
+        case BENCH_HTTP:
+        {
+#ifdef JSONRPCCPP_BENCH_HTTP
+            if (!this->AddServer(new HttpServer(this->options.port, "", "", this->options.workers), metrics))
+                return false;
+            if (this->options.httpPool)
+                this->shared = new HttpClientPool(this->GetUrl(), clients);
+            break;
+#else
+            return false;
+#endif
+        }
+    }
+
+    for (unsigned int i = 0; i < clients; i++)
+        this->clients.push_back(this->CreateClient());
+    return true;
+}
+
+void BenchTarget::Stop()
+{
+    if (this->listening)
+    {
+        for (size_t i = 0; i < this->servers.size(); i++)
+            this->servers[i]->StopListening();
+        this->listening = false;
+    }
+    for (size_t i = 0; i < this->clients.size(); i++)
+    {
+        if (this->clients[i] != this->shared)
+            delete this->clients[i];
+    }
+    delete this->shared;
+    this->shared = NULL;
+    for (size_t i = 0; i < this->servers.size(); i++)
+        delete this->servers[i];
+    for (size_t i = 0; i < this->connectors.size(); i++)
+        delete this->connectors[i];
+    for (size_t i = 0; i < this->pipes.size(); i++)
+        close(this->pipes[i]);
+    this->cache.Clear();
+    this->clients.clear();
+    this->servers.clear();
+    this->connectors.clear();
+    this->pipes.clear();
+}
+
+IClientConnector& BenchTarget::GetConnector(unsigned int client)
+{
+    return *this->clients[client];
+}
+
+bool BenchTarget::GetCacheStatistics(CacheStatistics &statistics)
+{
+    if (this->options.cacheTtl == 0)
+        return false;
+    this->cache.GetStatistics(statistics);
+    return true;
+}
+
+bool BenchTarget::GetAdmissionStatistics(AdmissionStatistics &statistics)
+{
+    if (this->options.maxRequests == 0)
+        return false;
+    memset(&statistics, 0, sizeof(statistics));
+    for (size_t i = 0; i < this->connectors.size(); i++)
+    {
+        AdmissionStatistics server;
+        this->connectors[i]->GetAdmissionStatistics(server);
+        statistics.refusedConnections += server.refusedConnections;
+        statistics.shedRequests += server.shedRequests;
+        if (server.acceptQueuePeak > statistics.acceptQueuePeak)
+            statistics.acceptQueuePeak = server.acceptQueuePeak;
+        statistics.acceptQueueFull += server.acceptQueueFull;
+    }
+    return true;
+}
+
+bool BenchTarget::AddServer(AbstractServerConnector *connector, RpcMetrics *metrics)
+{
+    this->connectors.push_back(connector);
+    if (this->options.maxRequests != 0)
+        connector->SetAdmissionLimits(0, this->options.maxRequests, 0);
+    BenchServer *server = new BenchServer(*connector, this->options.cacheTtl);
+    this->servers.push_back(server);
+    if (metrics != NULL)
+        server->SetMetrics(metrics);
+    if (this->options.cacheTtl != 0)
+        server->SetResponseCache(&(this->cache));
+    if (!server->StartListening())
+        return false;
+    this->listening = true;
+    return true;
+}
+
+string BenchTarget::GetUrl() const
+{
+    stringstream url;
+    url << "http://127.0.0.1:" << this->options.port;
+    return url.str();
+}
+
+IClientConnector* BenchTarget::CreateClient()
+{
+    switch (this->options.connector)
+    {
+        case BENCH_UNIX:
+        {
+            UnixDomainSocketClient *client = new UnixDomainSocketClient(this->options.path);
+            client->SetKeepAlive(this->options.keepAlive);
+            return client;
+        }
+#ifdef JSONRPCCPP_BENCH_HTTP
+        case BENCH_HTTP:
+        {
+            if (this->shared != NULL)
+                return this->shared;
+            return new HttpClient(this->GetUrl());
+        }
+#endif
+        default:
+        {
+            LinuxTcpSocketClient *client = new LinuxTcpSocketClient("127.0.0.1", this->options.port);
+            client->SetKeepAlive(this->options.keepAlive);
+            client->SetBinaryFraming(this->options.binary);
+            return client;
+        }
+    }
+}
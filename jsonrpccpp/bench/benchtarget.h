@@ -0,0 +1,102 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    benchtarget.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_BENCHTARGET_H_
+#define JSONRPC_CPP_BENCHTARGET_H_
+
+#include <string>
+#include <vector>
+#include <jsonrpccpp/client/iclientconnector.h>
+#include <jsonrpccpp/server/rpcmetrics.h>
+#include <jsonrpccpp/server/responsecache.h>
+#include "benchserver.h"
+
+namespace jsonrpc
+{
+    typedef enum
+    {
+        BENCH_TCP,          /*!< LinuxTcpSocketServer with a thread per connection*/
+        BENCH_TCP_REACTOR,  /*!< LinuxTcpSocketServer in reactor mode*/
+        BENCH_UNIX,         /*!< UnixDomainSocketServer*/
+        BENCH_FD,           /*!< A FileDescriptorServer per client, connected by two pipes*/
+        BENCH_HTTP          /*!< HttpServer, only if built with JSONRPCCPP_BENCH_HTTP*/
+    } benchConnector_t;
+
+    struct TargetOptions
+    {
+        TargetOptions();
+
+        benchConnector_t    connector;
+        unsigned int        port;
+        std::string         path;           /*!< The socket path of BENCH_UNIX*/
+        bool                keepAlive;      /*!< Clients of BENCH_TCP, BENCH_TCP_REACTOR and BENCH_UNIX keep their connection*/
+        bool                binary;         /*!< TCP clients switch to CBOR framing, needs keepAlive*/
+        unsigned int        workers;        /*!< The worker threads of BENCH_TCP_REACTOR and BENCH_HTTP*/
+        unsigned int        loops;          /*!< The event loops of BENCH_TCP_REACTOR*/
+        bool                reusePort;      /*!< Each event loop of BENCH_TCP_REACTOR accepts on its own SO_REUSEPORT socket, pinned to a CPU*/
+        bool                httpPool;       /*!< HTTP clients share one HttpClientPool with a handle per client instead of an HttpClient each*/
+        unsigned int        cacheTtl;       /*!< Milliseconds the servers answer echo and sum from a ResponseCache, 0 for no cache*/
+        unsigned int        maxRequests;    /*!< In-flight requests a server admits before it sheds them, 0 for no limit*/
+
+        static bool GetConnector(const std::string& name, benchConnector_t& connector);
+        static const char* GetConnectorName(benchConnector_t connector);
+    };
+
+    /**
+     * Runs BenchServer in process on one of the server connectors and creates the matching client connectors.
+     */
+    class BenchTarget
+    {
+        public:
+            BenchTarget(const TargetOptions& options);
+            ~BenchTarget();
+
+            /**
+             * @brief Starts listening and creates a client connector for each of the clients.
+             * @param metrics - recorded by the servers if not NULL.
+             * @return false if a server could not start listening or the connector is not built in.
+             */
+            bool Start(unsigned int clients, RpcMetrics* metrics);
+            void Stop();
+
+            /**
+             * @return the connector of a client, owned by the target. A connector is used by one thread at a time.
+             */
+            IClientConnector& GetConnector(unsigned int client);
+
+            /**
+             * @return false if the servers run without a cache.
+             */
+            bool GetCacheStatistics(CacheStatistics& statistics);
+
+            /**
+             * @brief Sums up the admission statistics of all servers, call it before Stop().
+             * @return false if the servers run without admission limits.
+             */
+            bool GetAdmissionStatistics(AdmissionStatistics& statistics);
+
+        private:
+            TargetOptions                           options;
+            std::vector<AbstractServerConnector*>   connectors;
+            std::vector<BenchServer*>               servers;
+            std::vector<IClientConnector*>          clients;
+            std::vector<int>                        pipes;
+            IClientConnector*                       shared;
+            ResponseCache                           cache;      /*!< Shared by all servers*/
+            bool                                    listening;
+
+            bool AddServer(AbstractServerConnector* connector, RpcMetrics* metrics);
+            IClientConnector* CreateClient();
+            std::string GetUrl() const;
+
+            BenchTarget(const BenchTarget&);
+            BenchTarget& operator=(const BenchTarget&);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_BENCHTARGET_H_ */
@@ -0,0 +1,276 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    loadgenerator.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "loadgenerator.h"
+
+#include <cstdlib>
+#include <sstream>
+
+using namespace jsonrpc;
+using namespace std;
+
+static const char* CALL_NAMES[BENCH_CALLS] = {"echo", "sum", "notify"};
+
+/**
+ * The state of a client thread, only that thread touches it until it is joined.
+ */
+struct LoadGenerator::Worker
+{
+    LoadGenerator       *generator;
+    unsigned int        index;
+    size_t              position;       /*!< The next call in the schedule*/
+    Json::Value         parameters[BENCH_CALLS];
+    Json::Int64         sum;            /*!< The expected result of sum*/
+    unsigned long long  requests;
+    unsigned long long  calls;
+    unsigned long long  errors;
+    LatencyHistogram    latency;
+    pthread_t           thread;
+};
+
+LoadProfile::LoadProfile() :
+    concurrency(4),
+    requests(10000),
+    warmup(100),
+    payload(64),
+    batch(1)
+{
+    this->weights[BENCH_ECHO] = 1;
+    this->weights[BENCH_SUM] = 0;
+    this->weights[BENCH_NOTIFY] = 0;
+}
+
+bool LoadProfile::SetMix(const string &mix)
+{
+    unsigned int parsed[BENCH_CALLS] = {0, 0, 0};
+    unsigned int total = 0;
+    stringstream entries(mix);
+    string entry;
+    while (getline(entries, entry, ','))
+    {
+        size_t colon = entry.find(':');
+        if (colon == string::npos || colon + 1 == entry.size())
+            return false;
+        string name = entry.substr(0, colon);
+        char *end = NULL;
+        unsigned long weight = strtoul(entry.c_str() + colon + 1, &end, 10);
+        if (*end != '\0' || weight > 1000)
+            return false;
+        int call = 0;
+        while (call < BENCH_CALLS && name != CALL_NAMES[call])
+            call++;
+        if (call == BENCH_CALLS)
+            return false;
+        parsed[call] = weight;
+        total += weight;
+    }
+    if (total == 0)
+        return false;
+    for (int i = 0; i < BENCH_CALLS; i++)
+        this->weights[i] = parsed[i];
+    return true;
+}
+
+string LoadProfile::GetMix() const
+{
+    stringstream mix;
+    for (int i = 0; i < BENCH_CALLS; i++)
+    {
+        if (this->weights[i] == 0)
+            continue;
+        if (!mix.str().empty())
+            mix << ",";
+        mix << CALL_NAMES[i] << ":" << this->weights[i];
+    }
+    return mix.str();
+}
+
+void LoadResult::ToJson(Json::Value &target) const
+{
+    target["requests"] = Json::UInt64(this->requests);
+    target["calls"] = Json::UInt64(this->calls);
+    target["errors"] = Json::UInt64(this->errors);
+    target["seconds"] = this->seconds;
+    target["requests_per_second"] = this->seconds > 0 ? this->requests / this->seconds : 0.0;
+    target["calls_per_second"] = this->seconds > 0 ? this->calls / this->seconds : 0.0;
+    this->latency.ToJson(target["latency"]);
+}
+
+LoadGenerator::LoadGenerator(BenchTarget &target, const LoadProfile &profile) :
+    target(target),
+    profile(profile)
+{
+    //Smooth weighted round robin, so e.g. echo:2,sum:1 becomes echo sum echo and not echo echo sum.
+    unsigned int total = 0;
+    int current[BENCH_CALLS] = {0, 0, 0};
+    for (int i = 0; i < BENCH_CALLS; i++)
+        total += profile.weights[i];
+    for (unsigned int n = 0; n < total; n++)
+    {
+        int best = 0;
+        for (int i = 0; i < BENCH_CALLS; i++)
+        {
+            current[i] += profile.weights[i];
+            if (current[i] > current[best])
+                best = i;
+        }
+        current[best] -= total;
+        this->schedule.push_back(static_cast<benchCall_t>(best));
+    }
+}
+
+void LoadGenerator::Run(LoadResult &result)
+{
+    vector<Worker> workers(this->profile.concurrency);
+    pthread_barrier_init(&(this->barrier), NULL, this->profile.concurrency + 1);
+
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+        Worker &worker = workers[i];
+        worker.generator = this;
+        worker.index = i;
+        worker.position = i % this->schedule.size();
+        worker.requests = 0;
+        worker.calls = 0;
+        worker.errors = 0;
+        pthread_create(&(worker.thread), NULL, LoadGenerator::LaunchWorker, &worker);
+    }
+
+    pthread_barrier_wait(&(this->barrier));
+    unsigned long long started = RpcMetrics::Now();
+
+    result.requests = 0;
+    result.calls = 0;
+    result.errors = 0;
+    result.latency = LatencyHistogram();
+    for (unsigned int i = 0; i < workers.size(); i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+        result.requests += workers[i].requests;
+        result.calls += workers[i].calls;
+        result.errors += workers[i].errors;
+        result.latency.Add(workers[i].latency);
+    }
+    result.seconds = (RpcMetrics::Now() - started) / 1e9;
+    pthread_barrier_destroy(&(this->barrier));
+}
+
+void* LoadGenerator::LaunchWorker(void *p_data)
+{
+    Worker *worker = reinterpret_cast<Worker*>(p_data);
+    worker->generator->RunWorker(*worker);
+    return NULL;
+}
+
+void LoadGenerator::RunWorker(Worker &worker)
+{
+    Client client(this->target.GetConnector(worker.index));
+
+    string data(this->profile.payload, 'x');
+    worker.parameters[BENCH_ECHO]["data"] = data;
+    worker.parameters[BENCH_NOTIFY]["data"] = data;
+    //Each value takes about 4 bytes in the request.
+    Json::Value &values = worker.parameters[BENCH_SUM]["values"];
+    values = Json::Value(Json::arrayValue);
+    worker.sum = 0;
+    for (unsigned int i = 0; i == 0 || i < this->profile.payload / 4; i++)
+    {
+        values.append(i % 1000);
+        worker.sum += i % 1000;
+    }
+
+    for (unsigned int i = 0; i < this->profile.warmup; i++)
+        this->Send(worker, client, NULL);
+    worker.requests = 0;
+    worker.calls = 0;
+    worker.errors = 0;
+
+    pthread_barrier_wait(&(this->barrier));
+    for (unsigned int i = 0; i < this->profile.requests; i++)
+        this->Send(worker, client, &(worker.latency));
+}
+
+void LoadGenerator::Send(Worker &worker, Client &client, LatencyHistogram *latency)
+{
+    unsigned long long started = RpcMetrics::Now();
+    if (this->profile.batch > 1)
+    {
+        this->CallBatch(worker, client);
+    }
+    else
+    {
+        benchCall_t call = this->schedule[worker.position];
+        worker.position = (worker.position + 1) % this->schedule.size();
+        worker.calls++;
+        if (!this->Call(worker, client, call))
+            worker.errors++;
+    }
+    if (latency != NULL)
+        latency->Record(RpcMetrics::Now() - started);
+    worker.requests++;
+}
+
+bool LoadGenerator::Call(Worker &worker, Client &client, benchCall_t call)
+{
+    try
+    {
+        if (call == BENCH_NOTIFY)
+        {
+            client.CallNotification(CALL_NAMES[call], worker.parameters[call]);
+            return true;
+        }
+        Json::Value result = client.CallMethod(CALL_NAMES[call], worker.parameters[call]);
+        if (call == BENCH_SUM)
+            return result.isIntegral() && result.asInt64() == worker.sum;
+        return result == worker.parameters[BENCH_ECHO]["data"];
+    }
+    catch (const JsonRpcException&)
+    {
+        return false;
+    }
+}
+
+void LoadGenerator::CallBatch(Worker &worker, Client &client)
+{
+    BatchCall batch;
+    vector<int> ids;
+    vector<benchCall_t> calls;
+    for (unsigned int i = 0; i < this->profile.batch; i++)
+    {
+        benchCall_t call = this->schedule[worker.position];
+        worker.position = (worker.position + 1) % this->schedule.size();
+        //A batch of notifications is not answered, so the last call is a method if no other one is.
+        while (call == BENCH_NOTIFY && i + 1 == this->profile.batch && ids.empty())
+        {
+            call = this->schedule[worker.position];
+            worker.position = (worker.position + 1) % this->schedule.size();
+        }
+        int id = batch.addCall(CALL_NAMES[call], worker.parameters[call], call == BENCH_NOTIFY);
+        if (call != BENCH_NOTIFY)
+        {
+            ids.push_back(id);
+            calls.push_back(call);
+        }
+    }
+    worker.calls += this->profile.batch;
+
+    try
+    {
+        BatchResponse response = client.CallProcedures(batch);
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            Json::Value result = response.getResult(ids[i]);
+            if (calls[i] == BENCH_SUM ? !(result.isIntegral() && result.asInt64() == worker.sum) : result != worker.parameters[BENCH_ECHO]["data"])
+                worker.errors++;
+        }
+    }
+    catch (const JsonRpcException&)
+    {
+        worker.errors += this->profile.batch;
+    }
+}
@@ -0,0 +1,87 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    loadgenerator.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_LOADGENERATOR_H_
+#define JSONRPC_CPP_LOADGENERATOR_H_
+
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <jsonrpccpp/client.h>
+#include "benchtarget.h"
+
+namespace jsonrpc
+{
+    typedef enum
+    {
+        BENCH_ECHO,
+        BENCH_SUM,
+        BENCH_NOTIFY,
+        BENCH_CALLS
+    } benchCall_t;
+
+    struct LoadProfile
+    {
+        LoadProfile();
+
+        unsigned int    concurrency;            /*!< Client threads, each with a connector of its own*/
+        unsigned int    requests;               /*!< Measured round trips per client*/
+        unsigned int    warmup;                 /*!< Round trips per client before the measurement starts*/
+        unsigned int    payload;                /*!< Approximate size of the parameters of a call in bytes*/
+        unsigned int    batch;                  /*!< Calls per round trip, more than 1 sends JSON-RPC 2.0 batches*/
+        unsigned int    weights[BENCH_CALLS];   /*!< Relative frequency of the procedures*/
+
+        /**
+         * @brief Parses a mix like "echo:8,sum:1,notify:1", procedures that are not listed are not called.
+         */
+        bool SetMix(const std::string& mix);
+        std::string GetMix() const;
+    };
+
+    struct LoadResult
+    {
+        unsigned long long  requests;       /*!< Round trips, a batch counts once*/
+        unsigned long long  calls;
+        unsigned long long  errors;         /*!< Calls that failed or returned a wrong result*/
+        double              seconds;
+        LatencyHistogram    latency;        /*!< Round trip times as seen by the clients*/
+
+        void ToJson(Json::Value& target) const;
+    };
+
+    /**
+     * Drives a BenchTarget from concurrent client threads. Each client sends its next round trip as soon as the
+     * previous one is answered, the procedures are interleaved according to the weights of the profile.
+     */
+    class LoadGenerator
+    {
+        public:
+            LoadGenerator(BenchTarget& target, const LoadProfile& profile);
+
+            /**
+             * @brief Runs the warmup of all clients, then measures their requests.
+             */
+            void Run(LoadResult& result);
+
+        private:
+            struct Worker;
+
+            BenchTarget&                target;
+            const LoadProfile&          profile;
+            std::vector<benchCall_t>    schedule;
+            pthread_barrier_t           barrier;    /*!< Starts the measurement when all clients are warm*/
+
+            static void* LaunchWorker(void* p_data);
+            void RunWorker(Worker& worker);
+            void Send(Worker& worker, Client& client, LatencyHistogram* latency);
+            bool Call(Worker& worker, Client& client, benchCall_t call);
+            void CallBatch(Worker& worker, Client& client);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_LOADGENERATOR_H_ */
@@ -0,0 +1,320 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    main.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "loadgenerator.h"
+#include "microbench.h"
+
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+
+using namespace jsonrpc;
+using namespace std;
+
+static void PrintUsage()
+{
+    cerr << "Usage: jsonrpccpp_bench [--connector=tcp|tcp-reactor|unix|fd|http] [--concurrency=<clients>]" << endl;
+    cerr << "                        [--requests=<per client>] [--warmup=<per client>] [--payload=<bytes>] [--batch=<calls>]" << endl;
+    cerr << "                        [--mix=echo:<weight>,sum:<weight>,notify:<weight>] [--workers=<threads>]" << endl;
+    cerr << "                        [--port=<port>] [--path=<socket>] [--no-keep-alive] [--binary] [--http-pool] [--cache=<ttl ms>]" << endl;
+    cerr << "                        [--max-requests=<in flight>] [--loops=<event loops>] [--reuse-port] [--scale] [--metrics] [--json]" << endl;
+    cerr << "       jsonrpccpp_bench [--dispatch=<procedures>] [--validator] [--alloc] [--payload=<bytes>] [--iterations=<per path>] [--json]" << endl;
+    cerr << endl;
+    cerr << "Runs a server in process and reports the throughput and latency percentiles of concurrent clients." << endl;
+    cerr << "--binary switches TCP clients to CBOR framing, --http-pool shares an HttpClientPool between HTTP clients." << endl;
+    cerr << "--cache answers echo and sum from a ResponseCache, every client repeats the same parameters." << endl;
+    cerr << "--max-requests sets the admission limit of the servers, shed requests count as errors." << endl;
+    cerr << "--loops and --reuse-port configure the tcp-reactor event loops, --reuse-port gives each its own listening socket" << endl;
+    cerr << "and pins it to a CPU. --scale repeats the run with 1 up to --loops event loops, with --workers workers per loop." << endl;
+    cerr << "--metrics records server side phase latencies, --json prints the report as JSON." << endl;
+    cerr << "--dispatch measures in process how long finding the procedure of a request takes among that many procedures," << endl;
+    cerr << "with the DispatchTable of the server and with a std::map as before." << endl;
+    cerr << "--validator measures the compiled parameter check against Procedure::ValdiateParameters for 5 to 20 named parameters." << endl;
+    cerr << "--alloc counts the allocations and copies of receiving and parsing a request through a RequestBuffer and through" << endl;
+    cerr << "the std::string the connectors used before." << endl;
+    cerr << "Exits with 1 if the server could not be started or a call failed." << endl;
+}
+
+static bool GetOption(const string &argument, const string &name, string &value)
+{
+    string prefix = "--" + name + "=";
+    if (argument.compare(0, prefix.size(), prefix) != 0)
+        return false;
+    value = argument.substr(prefix.size());
+    return true;
+}
+
+static bool ParseNumber(const string &text, unsigned int &value, unsigned long minimum = 1)
+{
+    char *end = NULL;
+    unsigned long number = strtoul(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || number < minimum || number > 1000000000)
+        return false;
+    value = number;
+    return true;
+}
+
+static void PrintLatency(const string &name, const LatencyHistogram &latency)
+{
+    printf("%-18s p50 %9.1f us  p90 %9.1f us  p99 %9.1f us  p99.9 %9.1f us  max %9.1f us\n", name.c_str(),
+           latency.GetPercentile(50) / 1e3, latency.GetPercentile(90) / 1e3, latency.GetPercentile(99) / 1e3,
+           latency.GetPercentile(99.9) / 1e3, latency.GetMax() / 1e3);
+}
+
+static void RunMicroBench(unsigned int iterations, unsigned int dispatch, bool validator, bool allocations, unsigned int payload, bool json)
+{
+    MicroBench bench(iterations);
+    if (dispatch > 0)
+        bench.RunDispatch(dispatch);
+    for (unsigned int parameters = 5; validator && parameters <= 20; parameters += 5)
+        bench.RunValidator(parameters);
+    if (allocations)
+        bench.RunAllocations(payload);
+    if (json)
+    {
+        Json::Value report;
+        report["iterations"] = iterations;
+        bench.ToJson(report["steps"]);
+        cout << report.toStyledString();
+    }
+    else
+    {
+        bench.Print();
+    }
+}
+
+static bool RunScaling(TargetOptions options, const LoadProfile &profile, bool json)
+{
+    unsigned int loops = options.loops, workers = options.workers;
+    Json::Value report(Json::arrayValue);
+    if (!json)
+        printf("%-6s %-8s %14s %10s %12s %12s\n", "loops", "workers", "requests/s", "errors", "p50 us", "p99 us");
+    for (unsigned int i = 1; i <= loops; i++)
+    {
+        options.loops = i;
+        options.workers = i * workers;
+        BenchTarget target(options);
+        if (!target.Start(profile.concurrency, NULL))
+        {
+            cerr << "jsonrpccpp_bench: could not start the server with " << i << " event loops" << endl;
+            return false;
+        }
+        LoadResult result;
+        LoadGenerator generator(target, profile);
+        generator.Run(result);
+        target.Stop();
+
+        double throughput = result.seconds > 0 ? result.requests / result.seconds : 0.0;
+        if (json)
+        {
+            Json::Value &row = report.append(Json::Value());
+            row["loops"] = i;
+            row["workers"] = options.workers;
+            result.ToJson(row["result"]);
+        }
+        else
+        {
+            printf("%-6u %-8u %14.0f %10llu %12.1f %12.1f\n", i, options.workers, throughput, result.errors,
+                   result.latency.GetPercentile(50) / 1e3, result.latency.GetPercentile(99) / 1e3);
+        }
+        if (result.errors != 0)
+            return false;
+    }
+    if (json)
+    {
+        Json::Value scaling;
+        scaling["connector"] = TargetOptions::GetConnectorName(options.connector);
+        scaling["reuse_port"] = options.reusePort;
+        scaling["concurrency"] = profile.concurrency;
+        scaling["payload"] = profile.payload;
+        scaling["mix"] = profile.GetMix();
+        scaling["runs"] = report;
+        cout << scaling.toStyledString();
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    TargetOptions options;
+    LoadProfile profile;
+    bool metrics = false, json = false, scale = false, validator = false, allocations = false;
+    unsigned int iterations = 1000000, dispatch = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        string argument = argv[i];
+        string text;
+        bool valid = true;
+        if (GetOption(argument, "connector", text))
+            valid = TargetOptions::GetConnector(text, options.connector);
+        else if (GetOption(argument, "mix", text))
+            valid = profile.SetMix(text);
+        else if (GetOption(argument, "path", text))
+            options.path = text;
+        else if (GetOption(argument, "concurrency", text))
+            valid = ParseNumber(text, profile.concurrency);
+        else if (GetOption(argument, "requests", text))
+            valid = ParseNumber(text, profile.requests);
+        else if (GetOption(argument, "warmup", text))
+            valid = ParseNumber(text, profile.warmup, 0);
+        else if (GetOption(argument, "payload", text))
+            valid = ParseNumber(text, profile.payload);
+        else if (GetOption(argument, "batch", text))
+            valid = ParseNumber(text, profile.batch);
+        else if (GetOption(argument, "workers", text))
+            valid = ParseNumber(text, options.workers);
+        else if (GetOption(argument, "port", text))
+            valid = ParseNumber(text, options.port) && options.port <= 65535;
+        else if (GetOption(argument, "cache", text))
+            valid = ParseNumber(text, options.cacheTtl);
+        else if (GetOption(argument, "max-requests", text))
+            valid = ParseNumber(text, options.maxRequests);
+        else if (GetOption(argument, "loops", text))
+            valid = ParseNumber(text, options.loops);
+        else if (GetOption(argument, "iterations", text))
+            valid = ParseNumber(text, iterations);
+        else if (GetOption(argument, "dispatch", text))
+            valid = ParseNumber(text, dispatch);
+        else if (argument == "--reuse-port")
+            options.reusePort = true;
+        else if (argument == "--validator")
+            validator = true;
+        else if (argument == "--alloc")
+            allocations = true;
+        else if (argument == "--scale")
+            scale = true;
+        else if (argument == "--no-keep-alive")
+            options.keepAlive = false;
+        else if (argument == "--binary")
+            options.binary = true;
+        else if (argument == "--http-pool")
+            options.httpPool = true;
+        else if (argument == "--metrics")
+            metrics = true;
+        else if (argument == "--json")
+            json = true;
+        else
+            valid = false;
+        if (!valid)
+        {
+            cerr << "jsonrpccpp_bench: invalid argument " << argument << endl;
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (dispatch > 0 || validator || allocations)
+    {
+        RunMicroBench(iterations, dispatch, validator, allocations, profile.payload, json);
+        return 0;
+    }
+#ifndef JSONRPCCPP_BENCH_HTTP
+    if (options.connector == BENCH_HTTP)
+    {
+        cerr << "jsonrpccpp_bench: built without the HTTP connectors, configure with JSONRPCCPP_BENCH_HTTP=ON" << endl;
+        return 1;
+    }
+#endif
+    if (options.binary && (!options.keepAlive || (options.connector != BENCH_TCP && options.connector != BENCH_TCP_REACTOR)))
+    {
+        cerr << "jsonrpccpp_bench: --binary needs a tcp connector with keep-alive" << endl;
+        return 1;
+    }
+    if ((options.loops > 1 || options.reusePort || scale) && options.connector != BENCH_TCP_REACTOR)
+    {
+        cerr << "jsonrpccpp_bench: --loops, --reuse-port and --scale need the tcp-reactor connector" << endl;
+        return 1;
+    }
+    if (profile.batch > 1 && profile.weights[BENCH_ECHO] == 0 && profile.weights[BENCH_SUM] == 0)
+    {
+        cerr << "jsonrpccpp_bench: a batch needs a method in the mix, notifications are not answered" << endl;
+        return 1;
+    }
+    if (scale)
+        return RunScaling(options, profile, json) ? 0 : 1;
+
+    RpcMetrics serverMetrics;
+    BenchTarget target(options);
+    if (!target.Start(profile.concurrency, metrics ? &serverMetrics : NULL))
+    {
+        cerr << "jsonrpccpp_bench: could not start the " << TargetOptions::GetConnectorName(options.connector) << " server" << endl;
+        return 1;
+    }
+    LoadResult result;
+    LoadGenerator generator(target, profile);
+    generator.Run(result);
+    CacheStatistics cache;
+    bool cached = target.GetCacheStatistics(cache);
+    AdmissionStatistics admission;
+    bool limited = target.GetAdmissionStatistics(admission);
+    target.Stop();
+
+    MetricsSnapshot snapshot;
+    if (metrics)
+        serverMetrics.GetSnapshot(snapshot);
+    unsigned long long lookups = cached ? cache.hits + cache.misses : 0;
+
+    if (json)
+    {
+        Json::Value report;
+        report["connector"] = TargetOptions::GetConnectorName(options.connector);
+        report["keep_alive"] = options.keepAlive;
+        report["binary"] = options.binary;
+        report["concurrency"] = profile.concurrency;
+        report["payload"] = profile.payload;
+        report["batch"] = profile.batch;
+        report["mix"] = profile.GetMix();
+        result.ToJson(report["result"]);
+        if (metrics)
+            snapshot.ToJson(report["server"]);
+        if (cached)
+        {
+            report["cache"]["hits"] = Json::UInt64(cache.hits);
+            report["cache"]["misses"] = Json::UInt64(cache.misses);
+            report["cache"]["hit_rate"] = lookups > 0 ? double(cache.hits) / lookups : 0.0;
+            report["cache"]["entries"] = Json::UInt64(cache.entries);
+            report["cache"]["bytes"] = Json::UInt64(cache.bytes);
+        }
+        if (limited)
+        {
+            report["admission"]["max_requests"] = options.maxRequests;
+            report["admission"]["shed_requests"] = Json::UInt64(admission.shedRequests);
+            report["admission"]["refused_connections"] = Json::UInt64(admission.refusedConnections);
+            report["admission"]["accept_queue_peak"] = admission.acceptQueuePeak;
+            report["admission"]["accept_queue_full"] = Json::UInt64(admission.acceptQueueFull);
+        }
+        cout << report.toStyledString();
+    }
+    else
+    {
+        printf("connector          %s%s%s\n", TargetOptions::GetConnectorName(options.connector),
+               options.keepAlive ? "" : ", a connection per request", options.binary ? ", CBOR framing" : "");
+        printf("clients            %u, payload %u bytes, batch %u, mix %s\n", profile.concurrency, profile.payload, profile.batch, profile.GetMix().c_str());
+        printf("requests           %llu in %.3f s, %.0f requests/s, %.0f calls/s\n", result.requests, result.seconds,
+               result.seconds > 0 ? result.requests / result.seconds : 0.0, result.seconds > 0 ? result.calls / result.seconds : 0.0);
+        printf("errors             %llu\n", result.errors);
+        PrintLatency("round trip", result.latency);
+        if (cached)
+            printf("cache              %llu hits, %llu misses, hit rate %.1f%%, %llu entries, %llu bytes\n", cache.hits, cache.misses,
+                   lookups > 0 ? 100.0 * cache.hits / lookups : 0.0, cache.entries, cache.bytes);
+        if (limited)
+            printf("admission          %u in flight, %llu requests shed, %llu connections refused, accept queue peak %u, full %llu times\n",
+                   options.maxRequests, admission.shedRequests, admission.refusedConnections, admission.acceptQueuePeak, admission.acceptQueueFull);
+        if (metrics)
+        {
+            for (int i = 0; i < METRICS_PHASES; i++)
+                PrintLatency(string("server ") + MetricsSnapshot::GetPhaseName(static_cast<metricsPhase_t>(i)), snapshot.phases[i]);
+            //Requests only wait in a queue when the connector has workers, e.g. tcp-reactor.
+            for (int i = 0; i < PRIORITY_CLASSES; i++)
+            {
+                if (snapshot.queues[i].GetCount() > 0)
+                    PrintLatency(string("server queue ") + MetricsSnapshot::GetQueueName(static_cast<priority_t>(i)), snapshot.queues[i]);
+            }
+        }
+    }
+    return result.errors == 0 ? 0 : 1;
+}
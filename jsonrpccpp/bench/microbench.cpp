@@ -0,0 +1,324 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    microbench.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "microbench.h"
+
+#include <jsonrpccpp/server/abstractprotocolhandler.h>
+#include <jsonrpccpp/server/dispatchtable.h>
+#include <jsonrpccpp/server/parametervalidator.h>
+#include <jsonrpccpp/server/requestbuffer.h>
+#include <jsonrpccpp/server/rpcmetrics.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <sstream>
+
+#define LOOKUP_ORDER_SIZE   4096
+#define READ_SIZE           1024
+#define STREAM_REQUESTS     1000
+
+using namespace jsonrpc;
+using namespace std;
+
+/**
+ * Counts what operator new hands out while counting is set, only RunAllocations sets it from a single thread.
+ * Json::Value strings and RequestBuffer are allocated with malloc and are not counted.
+ */
+static bool counting = false;
+static unsigned long long allocations = 0;
+static unsigned long long allocated = 0;
+
+void* operator new(size_t size)
+{
+    if (counting)
+    {
+        allocations++;
+        allocated += size;
+    }
+    void *p = malloc(size > 0 ? size : 1);
+    if (p == NULL)
+        throw bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+    free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    free(p);
+}
+
+/**
+ * Indices below count in a fixed pseudo random order, so that consecutive lookups do not hit the same entries.
+ */
+static void GetOrder(unsigned int count, vector<unsigned int> &order)
+{
+    unsigned int state = 12345;
+    order.resize(LOOKUP_ORDER_SIZE);
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        state = state * 1103515245 + 12345;
+        order[i] = (state >> 8) % count;
+    }
+}
+
+MicroBench::MicroBench(unsigned int iterations) :
+    iterations(iterations)
+{
+}
+
+void MicroBench::RunDispatch(unsigned int procedures)
+{
+    DispatchTable table;
+    map<string, Procedure> names;
+    vector<Json::Value> requests(procedures);
+    vector<const Json::Value*> methods(procedures);
+    for (unsigned int i = 0; i < procedures; i++)
+    {
+        //Dotted names of a few services share long prefixes, like the procedures of a larger server do.
+        ostringstream name;
+        name << "service" << i % 16 << ".procedure" << i;
+        Procedure procedure(name.str(), PARAMS_BY_NAME, JSON_STRING, "data", JSON_STRING, NULL);
+        table.Add(procedure, i);
+        names[name.str()] = procedure;
+        requests[i]["jsonrpc"] = "2.0";
+        requests[i]["id"] = i;
+        requests[i]["method"] = name.str();
+        //Both paths start from the parsed name, finding the member of the request is not measured.
+        methods[i] = &requests[i]["method"];
+    }
+    vector<unsigned int> order;
+    GetOrder(procedures, order);
+
+    unsigned long long found = 0;
+    unsigned long long started = RpcMetrics::Now();
+    for (unsigned int i = 0; i < this->iterations; i++)
+    {
+        const char *begin = NULL;
+        const char *end = NULL;
+        methods[order[i % LOOKUP_ORDER_SIZE]]->getString(&begin, &end);
+        found += table.Find(begin, end - begin) != NULL;
+    }
+    unsigned long long current = RpcMetrics::Now() - started;
+
+    started = RpcMetrics::Now();
+    for (unsigned int i = 0; i < this->iterations; i++)
+    {
+        found += names.find(methods[order[i % LOOKUP_ORDER_SIZE]]->asString()) != names.end();
+    }
+    unsigned long long previous = RpcMetrics::Now() - started;
+
+    if (found != 2ULL * this->iterations)
+        fprintf(stderr, "jsonrpccpp_bench: a dispatch lookup missed a registered procedure\n");
+    ostringstream name;
+    name << "dispatch " << procedures << " procedures";
+    this->AddResult(name.str(), "ns/lookup", double(current) / this->iterations, double(previous) / this->iterations);
+}
+
+void MicroBench::RunValidator(unsigned int parameters)
+{
+    static const jsontype_t TYPES[] = {JSON_STRING, JSON_INTEGER, JSON_BOOLEAN, JSON_REAL, JSON_ARRAY, JSON_OBJECT};
+    Procedure procedure("validate", PARAMS_BY_NAME, JSON_BOOLEAN, NULL);
+    Json::Value values;
+    for (unsigned int i = 0; i < parameters; i++)
+    {
+        ostringstream name;
+        name << "parameter" << i;
+        jsontype_t type = TYPES[i % (sizeof(TYPES) / sizeof(TYPES[0]))];
+        procedure.AddParameter(name.str(), type);
+        Json::Value &value = values[name.str()];
+        switch (type)
+        {
+            case JSON_STRING: value = "text"; break;
+            case JSON_INTEGER: value = i; break;
+            case JSON_BOOLEAN: value = true; break;
+            case JSON_REAL: value = 0.5 * i; break;
+            case JSON_ARRAY: value.append(i); break;
+            default: value["member"] = i; break;
+        }
+    }
+    ParameterValidator validator;
+    validator.Compile(procedure);
+
+    unsigned long long valid = 0;
+    unsigned long long started = RpcMetrics::Now();
+    for (unsigned int i = 0; i < this->iterations; i++)
+    {
+        valid += validator.Validate(values);
+    }
+    unsigned long long current = RpcMetrics::Now() - started;
+
+    started = RpcMetrics::Now();
+    for (unsigned int i = 0; i < this->iterations; i++)
+    {
+        valid += procedure.ValdiateParameters(values);
+    }
+    unsigned long long previous = RpcMetrics::Now() - started;
+
+    if (valid != 2ULL * this->iterations)
+        fprintf(stderr, "jsonrpccpp_bench: valid parameters failed validation\n");
+    ostringstream name;
+    name << "validate " << parameters << " named parameters";
+    this->AddResult(name.str(), "ns/call", double(current) / this->iterations, double(previous) / this->iterations);
+}
+
+void MicroBench::RunAllocations(unsigned int payload)
+{
+    string stream;
+    for (unsigned int i = 0; i < STREAM_REQUESTS; i++)
+    {
+        ostringstream request;
+        request << "{\"jsonrpc\":\"2.0\",\"id\":" << i << ",\"method\":\"echo\",\"params\":{\"data\":\"" << string(payload, 'x') << "\"}}\n";
+        stream += request.str();
+    }
+    unsigned int passes = (this->iterations + STREAM_REQUESTS - 1) / STREAM_REQUESTS;
+    unsigned long long requests = 0ULL + passes * STREAM_REQUESTS;
+    unsigned long long parsed = 0;
+
+    //The connectors now read into the buffer of the connection and parse the requests where they are.
+    unsigned long long copied = 0;
+    allocations = allocated = 0;
+    counting = true;
+    unsigned long long started = RpcMetrics::Now();
+    {
+        RequestBuffer buffer('\n');
+        for (unsigned int pass = 0; pass < passes; pass++)
+        {
+            for (size_t position = 0; position < stream.size();)
+            {
+                const char *begin, *end;
+                if (buffer.Next(begin, end))
+                {
+                    Json::Value request;
+                    parsed += AbstractProtocolHandler::ParseRequest(begin, end, request);
+                    continue;
+                }
+                //Reserve() moves what is left to the front or grows the buffer, which copies it either way.
+                size_t capacity = buffer.Capacity();
+                if (buffer.Available() < READ_SIZE)
+                    copied += buffer.Size();
+                char *space = buffer.Reserve(READ_SIZE);
+                if (buffer.Capacity() != capacity)
+                {
+                    allocations++;
+                    allocated += buffer.Capacity();
+                }
+                size_t length = min(buffer.Available(), min(size_t(READ_SIZE), stream.size() - position));
+                memcpy(space, stream.data() + position, length);
+                buffer.Commit(length);
+                position += length;
+            }
+            const char *begin, *end;
+            while (buffer.Next(begin, end))
+            {
+                Json::Value request;
+                parsed += AbstractProtocolHandler::ParseRequest(begin, end, request);
+            }
+        }
+    }
+    unsigned long long current = RpcMetrics::Now() - started;
+    counting = false;
+    unsigned long long currentAllocations = allocations, currentAllocated = allocated, currentCopied = copied;
+
+    //Before, the data was appended to a string, each request was cut out as a string of its own and parsed by a new
+    //Json::Reader, which copies the document once more.
+    copied = 0;
+    allocations = allocated = 0;
+    counting = true;
+    started = RpcMetrics::Now();
+    {
+        string received;
+        size_t scanned = 0;
+        char chunk[READ_SIZE];
+        for (unsigned int pass = 0; pass < passes; pass++)
+        {
+            for (size_t position = 0; position < stream.size() || received.find('\n', scanned) != string::npos;)
+            {
+                size_t found = received.find('\n', scanned);
+                if (found == string::npos)
+                {
+                    scanned = received.size();
+                    size_t length = min(size_t(READ_SIZE), stream.size() - position);
+                    memcpy(chunk, stream.data() + position, length);
+                    position += length;
+                    size_t capacity = received.capacity();
+                    received.append(chunk, length);
+                    copied += length + (received.capacity() != capacity ? received.size() - length : 0);
+                    continue;
+                }
+                string request = received.substr(0, found + 1);
+                received.erase(0, found + 1);
+                scanned = 0;
+                copied += request.size() + received.size();
+                Json::Reader reader;
+                Json::Value value;
+                parsed += reader.parse(request, value, false);
+                copied += request.capacity();
+            }
+        }
+    }
+    unsigned long long previous = RpcMetrics::Now() - started;
+    counting = false;
+
+    if (parsed != 2 * requests)
+        fprintf(stderr, "jsonrpccpp_bench: a request of the stream was not parsed\n");
+    ostringstream name;
+    name << "receive " << payload << " byte payloads";
+    this->AddResult(name.str(), "ns/request", double(current) / requests, double(previous) / requests);
+    this->AddResult(name.str(), "allocations/request", double(currentAllocations) / requests, double(allocations) / requests);
+    this->AddResult(name.str(), "bytes allocated/request", double(currentAllocated) / requests, double(allocated) / requests);
+    this->AddResult(name.str(), "bytes copied/request", double(currentCopied) / requests, double(copied) / requests);
+}
+
+void MicroBench::Print() const
+{
+    printf("%-36s %12s %12s %9s  %s\n", "step", "current", "previous", "ratio", "unit");
+    for (size_t i = 0; i < this->results.size(); i++)
+    {
+        const MicroResult &result = this->results[i];
+        if (result.current > 0)
+            printf("%-36s %12.1f %12.1f %8.2fx  %s\n", result.name.c_str(), result.current, result.previous,
+                   result.previous / result.current, result.unit.c_str());
+        else
+            printf("%-36s %12.1f %12.1f %9s  %s\n", result.name.c_str(), result.current, result.previous, "-", result.unit.c_str());
+    }
+}
+
+void MicroBench::ToJson(Json::Value &target) const
+{
+    target = Json::Value(Json::arrayValue);
+    for (size_t i = 0; i < this->results.size(); i++)
+    {
+        const MicroResult &result = this->results[i];
+        Json::Value &row = target.append(Json::Value());
+        row["name"] = result.name;
+        row["unit"] = result.unit;
+        row["current"] = result.current;
+        row["previous"] = result.previous;
+    }
+}
+
+void MicroBench::AddResult(const string &name, const string &unit, double current, double previous)
+{
+    MicroResult result;
+    result.name = name;
+    result.unit = unit;
+    result.current = current;
+    result.previous = previous;
+    this->results.push_back(result);
+}
@@ -0,0 +1,72 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    microbench.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_MICROBENCH_H_
+#define JSONRPC_CPP_MICROBENCH_H_
+
+#include <string>
+#include <vector>
+#include <jsonrpccpp/common/jsonparser.h>
+
+namespace jsonrpc
+{
+    /**
+     * The cost of one step of the server in the code it runs and in the code it replaced.
+     */
+    struct MicroResult
+    {
+        std::string     name;
+        std::string     unit;           /*!< What current and previous count per operation*/
+        double          current;
+        double          previous;
+    };
+
+    /**
+     * Measures single steps of request handling in process, without connectors or threads, so that the difference
+     * between a step and the code it replaced is not lost in the noise of a round trip.
+     */
+    class MicroBench
+    {
+        public:
+            /**
+             * @param iterations - operations each path runs for a result.
+             */
+            MicroBench(unsigned int iterations);
+
+            /**
+             * @brief Looks up the method names of parsed requests among procedures registered procedures, with a
+             * DispatchTable on the raw name bytes and with a std::map on a copy of the name as dispatch did before.
+             */
+            void RunDispatch(unsigned int procedures);
+
+            /**
+             * @brief Validates valid params objects of a procedure with that many named parameters of mixed types, with the
+             * compiled ParameterValidator and with Procedure::ValdiateParameters as before.
+             */
+            void RunValidator(unsigned int parameters);
+
+            /**
+             * @brief Receives pipelined echo requests with payload bytes of data from a stream in reads of 1024 bytes and
+             * parses them, once through a RequestBuffer as the socket connectors do and once through a std::string with the
+             * copies and the Json::Reader the connectors used before. Reports the time, the allocations and the bytes copied
+             * per request, reading from the stream is not counted as a copy.
+             */
+            void RunAllocations(unsigned int payload);
+
+            void Print() const;
+            void ToJson(Json::Value& target) const;
+
+        private:
+            unsigned int                iterations;
+            std::vector<MicroResult>    results;
+
+            void AddResult(const std::string& name, const std::string& unit, double current, double previous);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_MICROBENCH_H_ */
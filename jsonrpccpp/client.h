@@ -11,6 +11,8 @@
 #define JSONRPCCPP_CLIENT_H_
 
 #include <jsonrpccpp/client/client.h>
+#include <jsonrpccpp/client/asyncclient.h>
+#include <jsonrpccpp/client/coalescingclient.h>
 #include <jsonrpccpp/common/exception.h>
 
 
@@ -0,0 +1,409 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    asyncclient.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "asyncclient.h"
+#include "rpcprotocolclient.h"
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#define BUFFER_SIZE 4096
+#ifndef DELIMITER_CHAR
+#define DELIMITER_CHAR char(0x0A)
+#endif //DELIMITER_CHAR
+
+using namespace jsonrpc;
+using namespace std;
+
+AsyncCall::AsyncCall() :
+    done(false),
+    failed(false),
+    error(0)
+{
+    pthread_mutex_init(&this->lock, NULL);
+    pthread_cond_init(&this->finished, NULL);
+}
+
+AsyncCall::~AsyncCall()
+{
+    pthread_cond_destroy(&this->finished);
+    pthread_mutex_destroy(&this->lock);
+}
+
+void AsyncCall::OnResult(const Json::Value &result)
+{
+    pthread_mutex_lock(&this->lock);
+    this->result = result;
+    this->done = true;
+    pthread_cond_broadcast(&this->finished);
+    pthread_mutex_unlock(&this->lock);
+}
+
+void AsyncCall::OnError(const JsonRpcException &error)
+{
+    pthread_mutex_lock(&this->lock);
+    this->error = error;
+    this->failed = true;
+    this->done = true;
+    pthread_cond_broadcast(&this->finished);
+    pthread_mutex_unlock(&this->lock);
+}
+
+bool AsyncCall::IsDone()
+{
+    pthread_mutex_lock(&this->lock);
+    bool result = this->done;
+    pthread_mutex_unlock(&this->lock);
+    return result;
+}
+
+bool AsyncCall::Wait(int timeoutMs)
+{
+    struct timespec deadline;
+    if (timeoutMs >= 0)
+    {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeoutMs / 1000;
+        deadline.tv_nsec += (timeoutMs % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&this->lock);
+    while (!this->done)
+    {
+        if (timeoutMs < 0)
+            pthread_cond_wait(&this->finished, &this->lock);
+        else if (pthread_cond_timedwait(&this->finished, &this->lock, &deadline) == ETIMEDOUT)
+            break;
+    }
+    bool result = this->done;
+    pthread_mutex_unlock(&this->lock);
+    return result;
+}
+
+void AsyncCall::GetResult(Json::Value &result) throw (JsonRpcException)
+{
+    this->Wait();
+    if (this->failed)
+        throw this->error;
+    result = this->result;
+}
+
+Json::Value AsyncCall::GetResult() throw (JsonRpcException)
+{
+    Json::Value result;
+    this->GetResult(result);
+    return result;
+}
+
+AsyncClient::AsyncClient(IClientStreamConnector &connector, clientVersion_t version) :
+    connector(connector),
+    protocol(new RpcProtocolClient(version)),
+    fd(-1),
+    reading(false),
+    broken(false),
+    nextId(1),
+    dispatching(0),
+    notificationHandler(NULL)
+{
+    pthread_mutex_init(&this->writeLock, NULL);
+    pthread_mutex_init(&this->lock, NULL);
+    pthread_cond_init(&this->dispatched, NULL);
+}
+
+AsyncClient::~AsyncClient()
+{
+    this->Disconnect();
+    pthread_cond_destroy(&this->dispatched);
+    pthread_mutex_destroy(&this->lock);
+    pthread_mutex_destroy(&this->writeLock);
+    delete this->protocol;
+}
+
+int AsyncClient::CallMethod(const std::string &name, const Json::Value &parameter, IAsyncCallHandler &handler) throw (JsonRpcException)
+{
+    pthread_mutex_lock(&this->writeLock);
+    try
+    {
+        this->Connect();
+    }
+    catch (const JsonRpcException&)
+    {
+        pthread_mutex_unlock(&this->writeLock);
+        throw;
+    }
+
+    int id = this->nextId;
+    this->nextId = (this->nextId == INT_MAX) ? 1 : this->nextId + 1;
+    string request;
+    this->protocol->BuildRequest(id, name, parameter, request, false);
+
+    //Registered before it is sent, the response may arrive before send() returns.
+    pthread_mutex_lock(&this->lock);
+    if (this->broken)
+    {
+        //The reader stopped after Connect(), it would never complete the call.
+        pthread_mutex_unlock(&this->lock);
+        pthread_mutex_unlock(&this->writeLock);
+        throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, "Connection closed by server");
+    }
+    this->pending[id] = &handler;
+    pthread_mutex_unlock(&this->lock);
+
+    this->Send(request);
+    pthread_mutex_unlock(&this->writeLock);
+    return id;
+}
+
+Json::Value AsyncClient::CallMethod(const std::string &name, const Json::Value &parameter) throw (JsonRpcException)
+{
+    AsyncCall call;
+    this->CallMethod(name, parameter, call);
+    return call.GetResult();
+}
+
+void AsyncClient::CallNotification(const std::string &name, const Json::Value &parameter) throw (JsonRpcException)
+{
+    string request;
+    this->protocol->BuildRequest(name, parameter, request, true);
+
+    pthread_mutex_lock(&this->writeLock);
+    try
+    {
+        this->Connect();
+    }
+    catch (const JsonRpcException&)
+    {
+        pthread_mutex_unlock(&this->writeLock);
+        throw;
+    }
+    this->Send(request);
+    pthread_mutex_unlock(&this->writeLock);
+}
+
+void AsyncClient::SetNotificationHandler(IAsyncNotificationHandler *handler)
+{
+    pthread_mutex_lock(&this->lock);
+    this->notificationHandler = handler;
+    pthread_mutex_unlock(&this->lock);
+}
+
+void AsyncClient::Subscribe(const std::string &event) throw (JsonRpcException)
+{
+    Json::Value parameter(Json::arrayValue);
+    parameter.append(event);
+    this->CallMethod("rpc.subscribe", parameter);
+}
+
+void AsyncClient::Unsubscribe(const std::string &event) throw (JsonRpcException)
+{
+    Json::Value parameter(Json::arrayValue);
+    parameter.append(event);
+    this->CallMethod("rpc.unsubscribe", parameter);
+}
+
+bool AsyncClient::Cancel(int id)
+{
+    pthread_mutex_lock(&this->lock);
+    bool cancelled = this->pending.erase(id) > 0;
+    while (!cancelled && this->dispatching == id)
+    {
+        pthread_cond_wait(&this->dispatched, &this->lock);
+    }
+    pthread_mutex_unlock(&this->lock);
+    return cancelled;
+}
+
+size_t AsyncClient::GetPendingCount()
+{
+    pthread_mutex_lock(&this->lock);
+    size_t count = this->pending.size();
+    pthread_mutex_unlock(&this->lock);
+    return count;
+}
+
+void AsyncClient::Disconnect()
+{
+    pthread_mutex_lock(&this->writeLock);
+    this->Close();
+    pthread_mutex_unlock(&this->writeLock);
+}
+
+void AsyncClient::Send(const string &request)
+{
+    size_t offset = 0;
+    while (offset < request.size())
+    {
+        ssize_t byteWritten = send(this->fd, request.data() + offset, request.size() - offset, MSG_NOSIGNAL);
+        if (byteWritten > 0)
+        {
+            offset += byteWritten;
+        }
+        else if (byteWritten < 0 && errno != EINTR)
+        {
+            //The stream is unusable after a partial request. The reader stops and fails all calls in flight, this one included.
+            shutdown(this->fd, SHUT_RDWR);
+            return;
+        }
+    }
+}
+
+void AsyncClient::Connect() throw (JsonRpcException)
+{
+    pthread_mutex_lock(&this->lock);
+    bool usable = this->fd >= 0 && !this->broken;
+    pthread_mutex_unlock(&this->lock);
+    if (usable)
+        return;
+
+    this->Close();
+    this->fd = this->connector.OpenConnection();
+    this->broken = false;
+    if (pthread_create(&this->reader, NULL, AsyncClient::LaunchReader, this) != 0)
+    {
+        close(this->fd);
+        this->fd = -1;
+        throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, "Could not start the reader thread");
+    }
+    this->reading = true;
+}
+
+void AsyncClient::Close()
+{
+    if (this->reading)
+    {
+        shutdown(this->fd, SHUT_RDWR);
+        pthread_join(this->reader, NULL);
+        this->reading = false;
+    }
+    if (this->fd >= 0)
+    {
+        close(this->fd);
+        this->fd = -1;
+    }
+}
+
+void AsyncClient::FailPending(const string &message)
+{
+    JsonRpcException error(Errors::ERROR_CLIENT_CONNECTOR, message);
+    pthread_mutex_lock(&this->lock);
+    this->broken = true;
+    while (!this->pending.empty())
+    {
+        map<int, IAsyncCallHandler*>::iterator it = this->pending.begin();
+        IAsyncCallHandler *handler = it->second;
+        this->dispatching = it->first;
+        this->pending.erase(it);
+        pthread_mutex_unlock(&this->lock);
+
+        handler->OnError(error);
+
+        pthread_mutex_lock(&this->lock);
+        this->dispatching = 0;
+        pthread_cond_broadcast(&this->dispatched);
+    }
+    pthread_mutex_unlock(&this->lock);
+}
+
+void* AsyncClient::LaunchReader(void *p_data)
+{
+    AsyncClient *instance = reinterpret_cast<AsyncClient*>(p_data);
+    instance->ReadLoop();
+    return NULL;
+}
+
+void AsyncClient::ReadLoop()
+{
+    char buffer[BUFFER_SIZE];
+    string received;
+    size_t scanned = 0;
+    string reason = "Connection closed";
+
+    while (true)
+    {
+        ssize_t nbytes = recv(this->fd, buffer, BUFFER_SIZE, 0);
+        if (nbytes < 0 && errno == EINTR)
+            continue;
+        if (nbytes < 0)
+            reason = strerror(errno);
+        if (nbytes <= 0)
+            break;
+
+        received.append(buffer, nbytes);
+        size_t start = 0;
+        size_t pos;
+        while ((pos = received.find(DELIMITER_CHAR, scanned)) != string::npos)
+        {
+            this->Dispatch(received.substr(start, pos + 1 - start));
+            start = pos + 1;
+            scanned = start;
+        }
+        received.erase(0, start);
+        scanned = received.size();
+    }
+    this->FailPending(reason);
+}
+
+void AsyncClient::Dispatch(const string &response)
+{
+    Json::Reader reader;
+    Json::Value value;
+    if (!reader.parse(response, value, false) || !value.isObject())
+        return;
+    if (value.isMember(RpcProtocolClient::KEY_PROCEDURE_NAME) && value[RpcProtocolClient::KEY_PROCEDURE_NAME].isString() && value[RpcProtocolClient::KEY_ID].isNull())
+    {
+        pthread_mutex_lock(&this->lock);
+        IAsyncNotificationHandler *handler = this->notificationHandler;
+        pthread_mutex_unlock(&this->lock);
+        if (handler != NULL)
+            handler->OnNotification(value[RpcProtocolClient::KEY_PROCEDURE_NAME].asString(), value[RpcProtocolClient::KEY_PARAMETER]);
+        return;
+    }
+    //A response that cannot be matched to a call, e.g. the answer to a request the server could not parse, is dropped.
+    if (!value[RpcProtocolClient::KEY_ID].isInt())
+        return;
+
+    int id = value[RpcProtocolClient::KEY_ID].asInt();
+    pthread_mutex_lock(&this->lock);
+    map<int, IAsyncCallHandler*>::iterator it = this->pending.find(id);
+    if (it == this->pending.end())
+    {
+        pthread_mutex_unlock(&this->lock);
+        return;
+    }
+    IAsyncCallHandler *handler = it->second;
+    this->dispatching = id;
+    this->pending.erase(it);
+    pthread_mutex_unlock(&this->lock);
+
+    Json::Value result;
+    bool succeeded = false;
+    try
+    {
+        this->protocol->HandleResponse(value, result);
+        succeeded = true;
+    }
+    catch (const JsonRpcException &e)
+    {
+        handler->OnError(e);
+    }
+    if (succeeded)
+        handler->OnResult(result);
+
+    pthread_mutex_lock(&this->lock);
+    this->dispatching = 0;
+    pthread_cond_broadcast(&this->dispatched);
+    pthread_mutex_unlock(&this->lock);
+}
@@ -0,0 +1,191 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    asyncclient.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_ASYNCCLIENT_H_
+#define JSONRPC_CPP_ASYNCCLIENT_H_
+
+#include "iclientconnector.h"
+#include "client.h"
+#include <jsonrpccpp/common/exception.h>
+#include <jsonrpccpp/common/jsonparser.h>
+
+#include <string>
+#include <map>
+#include <pthread.h>
+
+namespace jsonrpc
+{
+    class RpcProtocolClient;
+
+    /**
+     * Receives the outcome of a call made with AsyncClient. Exactly one of the methods is called, from the reader thread
+     * of the client, so it must not block for long and must not wait for other calls of the same client.
+     */
+    class IAsyncCallHandler
+    {
+        public:
+            virtual ~IAsyncCallHandler() {}
+
+            virtual void OnResult(const Json::Value& result) = 0;
+
+            /**
+             * @param error - the error returned by the server, or ERROR_CLIENT_CONNECTOR if the connection failed before the response arrived.
+             */
+            virtual void OnError(const JsonRpcException& error) = 0;
+    };
+
+    /**
+     * Receives the notifications a server pushes to an AsyncClient that has subscribed to them. It is called from the reader
+     * thread of the client, in the order the notifications arrive, so it must not block for long and must not wait for calls
+     * of the same client.
+     */
+    class IAsyncNotificationHandler
+    {
+        public:
+            virtual ~IAsyncNotificationHandler() {}
+
+            virtual void OnNotification(const std::string& name, const Json::Value& parameters) = 0;
+    };
+
+    /**
+     * A call handler the caller can wait on, a future for the result of one call.
+     */
+    class AsyncCall : public IAsyncCallHandler
+    {
+        public:
+            AsyncCall();
+            virtual ~AsyncCall();
+
+            void OnResult(const Json::Value& result);
+            void OnError(const JsonRpcException& error);
+
+            bool IsDone();
+
+            /**
+             * @brief Blocks until the call is done.
+             * @param timeoutMs the longest time to wait, -1 to wait forever
+             * @return false if the call is not done when the timeout expires.
+             */
+            bool Wait(int timeoutMs = -1);
+
+            /**
+             * @brief Waits for the call and returns its result.
+             * @throw JsonRpcException the error of the call.
+             */
+            void GetResult(Json::Value& result) throw (JsonRpcException);
+            Json::Value GetResult() throw (JsonRpcException);
+
+        private:
+            bool done;
+            bool failed;
+            Json::Value result;
+            JsonRpcException error;
+
+            pthread_mutex_t lock;
+            pthread_cond_t finished;
+
+            AsyncCall(const AsyncCall&);
+            AsyncCall& operator=(const AsyncCall&);
+    };
+
+    /**
+     * A client that keeps any number of calls in flight over one persistent connection.
+     *
+     * Every call gets a unique id and is written as soon as it is made, from the calling thread. A reader thread matches
+     * the responses to the calls by id and completes their handlers, and passes notifications pushed by the server to the
+     * notification handler. The connection is opened by the first call and reopened by the next call after it failed.
+     * Batches are not supported.
+     */
+    class AsyncClient
+    {
+        public:
+            AsyncClient(IClientStreamConnector &connector, clientVersion_t version = JSONRPC_CLIENT_V2);
+
+            /**
+             * Closes the connection. Calls still in flight fail with ERROR_CLIENT_CONNECTOR.
+             */
+            virtual ~AsyncClient();
+
+            /**
+             * @brief Sends a method call and returns without waiting for the response.
+             * @param handler - completed when the response arrives. It must stay valid until then or until Cancel() has returned.
+             * @return the id of the call.
+             * @throw JsonRpcException if the connection could not be opened, the handler is not called then.
+             * A connection failing later completes the handler with an error.
+             */
+            int CallMethod(const std::string& name, const Json::Value& parameter, IAsyncCallHandler& handler) throw (JsonRpcException);
+
+            /**
+             * @brief Sends a method call and waits for its result, while other calls stay in flight.
+             */
+            Json::Value CallMethod(const std::string& name, const Json::Value& parameter) throw (JsonRpcException);
+
+            void CallNotification(const std::string& name, const Json::Value& parameter) throw (JsonRpcException);
+
+            /**
+             * @brief Receives the notifications pushed by the server, NULL drops them.
+             */
+            void SetNotificationHandler(IAsyncNotificationHandler* handler);
+
+            /**
+             * @brief Subscribes the connection to an event with rpc.subscribe, see AbstractServer::EnableSubscriptions.
+             * A subscription ends with the connection, after a reconnect the events have to be subscribed again.
+             * @throw JsonRpcException if the server does not accept subscriptions over this connection.
+             */
+            void Subscribe(const std::string& event) throw (JsonRpcException);
+            void Unsubscribe(const std::string& event) throw (JsonRpcException);
+
+            /**
+             * @brief Forgets a call, its handler will not be called. A response arriving later is dropped.
+             * @return false if the call is not in flight any more. Its handler has been called completely when Cancel returns.
+             */
+            bool Cancel(int id);
+
+            /**
+             * @return the number of calls waiting for their response.
+             */
+            size_t GetPendingCount();
+
+            /**
+             * @brief Closes the connection, calls in flight fail with ERROR_CLIENT_CONNECTOR. The next call reconnects.
+             */
+            void Disconnect();
+
+        private:
+            IClientStreamConnector &connector;
+            RpcProtocolClient *protocol;
+
+            int fd;                     /*!< The connection, -1 if closed*/
+            bool reading;               /*!< The reader thread has been started and not joined yet*/
+            bool broken;                /*!< The reader thread has stopped, the connection must be reopened*/
+            pthread_t reader;
+            int nextId;
+
+            std::map<int, IAsyncCallHandler*> pending;  /*!< Calls waiting for their response, by id*/
+            int dispatching;            /*!< The id whose handler the reader thread is calling, 0 if none*/
+            IAsyncNotificationHandler *notificationHandler;
+
+            pthread_mutex_t writeLock;  /*!< Serializes requests and reconnects*/
+            pthread_mutex_t lock;       /*!< Protects pending, dispatching, notificationHandler and broken*/
+            pthread_cond_t dispatched;
+
+            void Send(const std::string& request);
+            void Connect() throw (JsonRpcException);
+            void Close();
+            void FailPending(const std::string& message);
+
+            static void* LaunchReader(void *p_data);
+            void ReadLoop();
+            void Dispatch(const std::string& response);
+
+            AsyncClient(const AsyncClient&);
+            AsyncClient& operator=(const AsyncClient&);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_ASYNCCLIENT_H_ */
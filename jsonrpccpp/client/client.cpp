@@ -13,7 +13,8 @@
 using namespace jsonrpc;
 
 Client::Client(IClientConnector &connector, clientVersion_t version) :
-    connector(connector)
+    connector(connector),
+    jsonConnector(dynamic_cast<IClientJsonConnector*>(&connector))
 {
     this->protocol = new RpcProtocolClient(version);
 }
@@ -25,6 +26,17 @@ Client::~Client()
 
 void Client::CallMethod(const std::string &name, const Json::Value &parameter, Json::Value& result) throw(JsonRpcException)
 {
+    if (this->jsonConnector != NULL)
+    {
+        Json::Value request, response;
+        protocol->BuildRequest(1, name, parameter, request, false);
+        if (this->jsonConnector->SendJsonMessage(request, response))
+        {
+            protocol->HandleResponse(response, result);
+            return;
+        }
+    }
+
     std::string request, response;
     protocol->BuildRequest(name, parameter, request, false);
     connector.SendRPCMessage(request, response);
@@ -80,7 +92,20 @@ Json::Value Client::CallMethod(const std::string& name, const Json::Value& param
 
 void Client::CallNotification(const std::string& name, const Json::Value& parameter) throw(JsonRpcException)
 {
+    if (this->jsonConnector != NULL)
+    {
+        Json::Value request, response;
+        protocol->BuildRequest(1, name, parameter, request, true);
+        if (this->jsonConnector->SendJsonMessage(request, response))
+            return;
+    }
+
     std::string request, response;
     protocol->BuildRequest(name, parameter, request, true);
     connector.SendRPCMessage(request, response);
 }
+
+void Client::SetDeadline(unsigned int deadlineMs)
+{
+    this->protocol->SetDeadline(deadlineMs);
+}
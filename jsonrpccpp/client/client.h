@@ -38,9 +38,18 @@ namespace jsonrpc
 
             void        CallNotification    (const std::string& name, const Json::Value& parameter) throw (JsonRpcException);
 
+            /**
+             * @brief Tells the server how long the client waits for the calls it makes from now on, so it drops the ones it
+             * cannot start in time instead of working for nobody, see RpcProtocolClient::SetDeadline. The calls of a batch have
+             * no deadline. The client itself waits as long as its connector does, so set the connector's timeout to the same value.
+             * @param deadlineMs - 0 for no deadline, the default.
+             */
+            void        SetDeadline         (unsigned int deadlineMs);
+
         private:
            IClientConnector  &connector;
            RpcProtocolClient *protocol;
+           IClientJsonConnector *jsonConnector; /*!< The connector if it can carry JSON values, NULL otherwise*/
 
     };
 
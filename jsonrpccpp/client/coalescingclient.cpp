@@ -0,0 +1,272 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    coalescingclient.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "coalescingclient.h"
+#include "rpcprotocolclient.h"
+#include <errno.h>
+#include <limits.h>
+
+#include <map>
+
+#define DEFAULT_WINDOW_US 1000
+#define DEFAULT_MAX_CALLS 32
+
+using namespace jsonrpc;
+using namespace std;
+
+CoalescingClient::CoalescingClient(IClientConnector &connector) :
+    connector(connector),
+    protocol(new RpcProtocolClient(JSONRPC_CLIENT_V2)),
+    window(DEFAULT_WINDOW_US),
+    maxCalls(DEFAULT_MAX_CALLS),
+    nextId(1),
+    requests(0),
+    flushing(false),
+    stopping(false)
+{
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_mutex_init(&this->lock, NULL);
+    pthread_cond_init(&this->queued, &attributes);
+    pthread_condattr_destroy(&attributes);
+}
+
+CoalescingClient::~CoalescingClient()
+{
+    pthread_mutex_lock(&this->lock);
+    this->stopping = true;
+    pthread_cond_broadcast(&this->queued);
+    pthread_mutex_unlock(&this->lock);
+    if (this->flushing)
+        pthread_join(this->flusher, NULL);
+    pthread_cond_destroy(&this->queued);
+    pthread_mutex_destroy(&this->lock);
+    delete this->protocol;
+}
+
+void CoalescingClient::SetBatching(unsigned int windowUs, unsigned int maxCalls)
+{
+    pthread_mutex_lock(&this->lock);
+    this->window = windowUs;
+    this->maxCalls = maxCalls > 0 ? maxCalls : 1;
+    pthread_cond_broadcast(&this->queued);
+    pthread_mutex_unlock(&this->lock);
+}
+
+int CoalescingClient::CallMethod(const std::string &name, const Json::Value &parameter, IAsyncCallHandler &handler) throw (JsonRpcException)
+{
+    return this->Enqueue(name, parameter, &handler, false);
+}
+
+Json::Value CoalescingClient::CallMethod(const std::string &name, const Json::Value &parameter) throw (JsonRpcException)
+{
+    AsyncCall call;
+    this->CallMethod(name, parameter, call);
+    return call.GetResult();
+}
+
+void CoalescingClient::CallNotification(const std::string &name, const Json::Value &parameter) throw (JsonRpcException)
+{
+    this->Enqueue(name, parameter, NULL, true);
+}
+
+unsigned long long CoalescingClient::GetRequestCount()
+{
+    pthread_mutex_lock(&this->lock);
+    unsigned long long result = this->requests;
+    pthread_mutex_unlock(&this->lock);
+    return result;
+}
+
+int CoalescingClient::Enqueue(const std::string &name, const Json::Value &parameter, IAsyncCallHandler *handler, bool isNotification) throw (JsonRpcException)
+{
+    pthread_mutex_lock(&this->lock);
+    if (!this->flushing)
+    {
+        if (pthread_create(&this->flusher, NULL, CoalescingClient::LaunchFlusher, this) != 0)
+        {
+            pthread_mutex_unlock(&this->lock);
+            throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, "Could not start the flusher thread");
+        }
+        this->flushing = true;
+    }
+
+    if (this->queue.empty())
+        clock_gettime(CLOCK_MONOTONIC, &this->oldest);
+    this->queue.push_back(QueuedCall());
+    QueuedCall &call = this->queue.back();
+    call.handler = handler;
+    call.id = 0;
+    if (!isNotification)
+    {
+        //Ids restart after INT_MAX, they only have to tell apart the calls of one batch.
+        call.id = this->nextId;
+        this->nextId = (this->nextId == INT_MAX) ? 1 : this->nextId + 1;
+    }
+    this->protocol->BuildRequest(call.id, name, parameter, call.request, isNotification);
+    int id = call.id;
+
+    //The flusher waits for the first call of a batch, then for the window to pass or the batch to fill up.
+    if (this->queue.size() == 1 || this->queue.size() >= this->maxCalls)
+        pthread_cond_signal(&this->queued);
+    pthread_mutex_unlock(&this->lock);
+    return id;
+}
+
+void* CoalescingClient::LaunchFlusher(void *p_data)
+{
+    CoalescingClient *instance = reinterpret_cast<CoalescingClient*>(p_data);
+    instance->FlushLoop();
+    return NULL;
+}
+
+void CoalescingClient::FlushLoop()
+{
+    vector<QueuedCall> batch;
+    pthread_mutex_lock(&this->lock);
+    while (true)
+    {
+        while (this->queue.empty() && !this->stopping)
+            pthread_cond_wait(&this->queued, &this->lock);
+        if (this->queue.empty())
+            break;
+
+        //Calls left over from a full batch or queued while the previous batch was in flight have waited long enough already.
+        while (!this->stopping && this->queue.size() < this->maxCalls && this->window > 0)
+        {
+            struct timespec deadline = this->oldest;
+            deadline.tv_sec += this->window / 1000000;
+            deadline.tv_nsec += (this->window % 1000000) * 1000L;
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            if (pthread_cond_timedwait(&this->queued, &this->lock, &deadline) == ETIMEDOUT)
+                break;
+        }
+
+        size_t count = this->queue.size() < this->maxCalls ? this->queue.size() : this->maxCalls;
+        batch.resize(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            batch[i].id = this->queue[i].id;
+            batch[i].handler = this->queue[i].handler;
+            batch[i].request.swap(this->queue[i].request);
+        }
+        this->queue.erase(this->queue.begin(), this->queue.begin() + count);
+        this->requests++;
+        pthread_mutex_unlock(&this->lock);
+
+        this->SendBatch(batch);
+        batch.clear();
+
+        pthread_mutex_lock(&this->lock);
+    }
+    pthread_mutex_unlock(&this->lock);
+}
+
+void CoalescingClient::SendBatch(vector<QueuedCall> &calls)
+{
+    Json::Value request;
+    if (calls.size() == 1)
+    {
+        request.swap(calls[0].request);
+    }
+    else
+    {
+        request = Json::Value(Json::arrayValue);
+        request.resize(calls.size());
+        for (size_t i = 0; i < calls.size(); i++)
+            request[Json::ArrayIndex(i)].swap(calls[i].request);
+    }
+
+    map<int, QueuedCall*> waiting;
+    for (size_t i = 0; i < calls.size(); i++)
+    {
+        if (calls[i].id != 0)
+            waiting[calls[i].id] = &calls[i];
+    }
+
+    Json::FastWriter writer;
+    string response;
+    try
+    {
+        this->connector.SendRPCMessage(writer.write(request), response);
+    }
+    catch (const JsonRpcException &e)
+    {
+        for (map<int, QueuedCall*>::iterator it = waiting.begin(); it != waiting.end(); ++it)
+            it->second->handler->OnError(e);
+        return;
+    }
+    if (waiting.empty())
+        return;
+
+    //The response is parsed once and each call completed from its element, the elements are not copied.
+    Json::Reader reader;
+    Json::Value value;
+    if (!reader.parse(response, value, false))
+    {
+        JsonRpcException error(Errors::ERROR_RPC_JSON_PARSE_ERROR, " " + response);
+        for (map<int, QueuedCall*>::iterator it = waiting.begin(); it != waiting.end(); ++it)
+            it->second->handler->OnError(error);
+        return;
+    }
+
+    if (!value.isArray())
+    {
+        //A plain response, to a single call or to a batch the server could not take apart.
+        Json::Value responses(Json::arrayValue);
+        responses.append(Json::nullValue);
+        responses[Json::ArrayIndex(0)].swap(value);
+        value.swap(responses);
+    }
+    Json::Value unmatched;
+    for (Json::ArrayIndex i = 0; i < value.size(); i++)
+    {
+        Json::Value &element = value[i];
+        Json::Value id = element.isObject() ? element.get(RpcProtocolClient::KEY_ID, Json::Value()) : Json::Value();
+        map<int, QueuedCall*>::iterator it = id.isInt() ? waiting.find(id.asInt()) : waiting.end();
+        if (it == waiting.end())
+        {
+            //An answer without id refers to the whole request, e.g. a parse error or a busy server.
+            if (element.isObject() && id.isNull())
+                unmatched.swap(element);
+            continue;
+        }
+        this->Complete(*it->second, element);
+        waiting.erase(it);
+    }
+
+    for (map<int, QueuedCall*>::iterator it = waiting.begin(); it != waiting.end(); ++it)
+    {
+        if (!unmatched.isNull())
+            this->Complete(*it->second, unmatched);
+        else
+            it->second->handler->OnError(JsonRpcException(Errors::ERROR_CLIENT_INVALID_RESPONSE, "No response for the call"));
+    }
+}
+
+void CoalescingClient::Complete(QueuedCall &call, const Json::Value &response)
+{
+    Json::Value result;
+    bool succeeded = false;
+    try
+    {
+        this->protocol->HandleResponse(response, result);
+        succeeded = true;
+    }
+    catch (const JsonRpcException &e)
+    {
+        call.handler->OnError(e);
+    }
+    if (succeeded)
+        call.handler->OnResult(result);
+}
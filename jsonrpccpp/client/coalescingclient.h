@@ -0,0 +1,114 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    coalescingclient.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_COALESCINGCLIENT_H_
+#define JSONRPC_CPP_COALESCINGCLIENT_H_
+
+#include "iclientconnector.h"
+#include "asyncclient.h"
+#include <jsonrpccpp/common/exception.h>
+#include <jsonrpccpp/common/jsonparser.h>
+
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <time.h>
+
+namespace jsonrpc
+{
+    class RpcProtocolClient;
+
+    /**
+     * A client that merges the calls of concurrent threads into JSON-RPC 2.0 batches.
+     *
+     * Calls are queued and sent by a flusher thread over the connector, one request at a time. A batch is sent once the
+     * oldest queued call has waited for the batching window or enough calls are queued to fill a batch, calls made while
+     * a batch is in flight go out with the next one. The responses are matched to the calls by id and complete their
+     * handlers, from the flusher thread. A batch of a single call is sent as a plain request.
+     *
+     * Servers answer the calls of a batch together, so a slow call delays the others of its batch.
+     */
+    class CoalescingClient
+    {
+        public:
+            CoalescingClient(IClientConnector &connector);
+
+            /**
+             * Sends the calls still queued and waits for their responses.
+             */
+            virtual ~CoalescingClient();
+
+            /**
+             * @brief Sets how calls are merged, before or between calls.
+             * @param windowUs - the longest time a call waits for others to join its batch, 0 to send what is queued right away.
+             * 1000 by default.
+             * @param maxCalls - the most calls in one batch, 32 by default.
+             */
+            void SetBatching(unsigned int windowUs, unsigned int maxCalls);
+
+            /**
+             * @brief Queues a method call and returns without waiting for the response.
+             * @param handler - completed from the flusher thread when the response arrives, it must stay valid until then.
+             * It must not block for long and must not wait for other calls of the same client.
+             * @return the id of the call within its batch.
+             * @throw JsonRpcException if the flusher thread could not be started, the handler is not called then.
+             */
+            int CallMethod(const std::string& name, const Json::Value& parameter, IAsyncCallHandler& handler) throw (JsonRpcException);
+
+            /**
+             * @brief Queues a method call and waits for its result.
+             */
+            Json::Value CallMethod(const std::string& name, const Json::Value& parameter) throw (JsonRpcException);
+
+            /**
+             * @brief Queues a notification, it is sent with the next batch. Failures to send it are not reported.
+             */
+            void CallNotification(const std::string& name, const Json::Value& parameter) throw (JsonRpcException);
+
+            /**
+             * @return the number of requests sent so far, a batch counts once.
+             */
+            unsigned long long GetRequestCount();
+
+        private:
+            struct QueuedCall
+            {
+                int id;                     /*!< 0 for a notification*/
+                Json::Value request;
+                IAsyncCallHandler *handler;
+            };
+
+            IClientConnector &connector;
+            RpcProtocolClient *protocol;
+            unsigned int window;
+            unsigned int maxCalls;
+            int nextId;
+            unsigned long long requests;
+
+            std::vector<QueuedCall> queue;  /*!< Calls waiting for the next batch, oldest first*/
+            struct timespec oldest;         /*!< When the first call of queue was made, CLOCK_MONOTONIC*/
+            bool flushing;                  /*!< The flusher thread has been started*/
+            bool stopping;
+            pthread_t flusher;
+
+            pthread_mutex_t lock;           /*!< Protects everything above*/
+            pthread_cond_t queued;
+
+            int Enqueue(const std::string& name, const Json::Value& parameter, IAsyncCallHandler* handler, bool isNotification) throw (JsonRpcException);
+
+            static void* LaunchFlusher(void *p_data);
+            void FlushLoop();
+            void SendBatch(std::vector<QueuedCall>& calls);
+            void Complete(QueuedCall& call, const Json::Value& response);
+
+            CoalescingClient(const CoalescingClient&);
+            CoalescingClient& operator=(const CoalescingClient&);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_COALESCINGCLIENT_H_ */
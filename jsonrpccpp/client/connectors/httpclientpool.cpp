@@ -0,0 +1,239 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    httpclientpool.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "httpclientpool.h"
+#include <string.h>
+#include <cstdlib>
+#include <sstream>
+#include <new>
+
+#define RESPONSE_BUFFER_SIZE 4096
+
+using namespace jsonrpc;
+using namespace std;
+
+namespace
+{
+    class curl_initializer {
+        public:
+            curl_initializer() {curl_global_init(CURL_GLOBAL_ALL);}
+            ~curl_initializer() {curl_global_cleanup();}
+    };
+
+    // See here: http://curl.haxx.se/libcurl/c/curl_global_init.html
+    static curl_initializer _curl_init = curl_initializer();
+
+    /**
+     * Collects a response body. It grows geometrically and keeps its memory for the next call of the handle.
+     */
+    struct ResponseBuffer
+    {
+        char *data;
+        size_t size;
+        size_t capacity;
+    };
+}
+
+struct HttpClientPool::Handle
+{
+    CURL *curl;
+    struct curl_slist *headers;
+    unsigned int generation;        /*!< The settings generation applied to curl*/
+    ResponseBuffer response;
+};
+
+static size_t writefunc(void *ptr, size_t size, size_t nmemb, void *userdata)
+{
+    ResponseBuffer *buffer = static_cast<ResponseBuffer*>(userdata);
+    size_t length = size * nmemb;
+    if (buffer->capacity - buffer->size < length)
+    {
+        size_t capacity = buffer->capacity > 0 ? buffer->capacity : RESPONSE_BUFFER_SIZE;
+        while (capacity - buffer->size < length)
+            capacity *= 2;
+        char *grown = static_cast<char*>(realloc(buffer->data, capacity));
+        if (grown == NULL)
+            return 0;   //Makes curl fail the transfer with CURLE_WRITE_ERROR.
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, ptr, length);
+    buffer->size += length;
+    return length;
+}
+
+HttpClientPool::HttpClientPool(const std::string& url, unsigned int maxHandles) throw(JsonRpcException) :
+    url(url),
+    timeout(10000),
+    maxHandles(maxHandles > 0 ? maxHandles : 1),
+    generation(0)
+{
+    pthread_mutex_init(&this->lock, NULL);
+    pthread_cond_init(&this->released, NULL);
+}
+
+HttpClientPool::~HttpClientPool()
+{
+    for (size_t i = 0; i < this->handles.size(); i++)
+    {
+        Handle *handle = this->handles[i];
+        curl_easy_cleanup(handle->curl);
+        curl_slist_free_all(handle->headers);
+        free(handle->response.data);
+        delete handle;
+    }
+    pthread_cond_destroy(&this->released);
+    pthread_mutex_destroy(&this->lock);
+}
+
+void HttpClientPool::SendRPCMessage(const std::string& message, std::string& result) throw (JsonRpcException)
+{
+    Handle *handle = this->Acquire();
+
+    handle->response.size = 0;
+    curl_easy_setopt(handle->curl, CURLOPT_POSTFIELDS, message.data());
+    curl_easy_setopt(handle->curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(message.size()));
+    CURLcode res = curl_easy_perform(handle->curl);
+
+    result.assign(handle->response.data != NULL ? handle->response.data : "", handle->response.size);
+    long http_code = 0;
+    curl_easy_getinfo(handle->curl, CURLINFO_RESPONSE_CODE, &http_code);
+    string url;
+    if (res != CURLE_OK)
+    {
+        char *effective = NULL;
+        curl_easy_getinfo(handle->curl, CURLINFO_EFFECTIVE_URL, &effective);
+        if (effective != NULL)
+            url = effective;
+    }
+    this->Release(handle);
+
+    if (res != CURLE_OK)
+    {
+        std::stringstream str;
+        str << "libcurl error: " << res;
+
+        if (res == 7)
+            str << " -> Could not connect to " << url;
+        else if(res == 28)
+            str << " -> Operation timed out";
+        throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, str.str());
+    }
+
+    if (http_code != 200)
+    {
+        throw JsonRpcException(Errors::ERROR_RPC_INTERNAL_ERROR, result);
+    }
+}
+
+void HttpClientPool::SetUrl(const std::string& url)
+{
+    pthread_mutex_lock(&this->lock);
+    this->url = url;
+    this->generation++;
+    pthread_mutex_unlock(&this->lock);
+}
+
+void HttpClientPool::SetTimeout(long timeout)
+{
+    pthread_mutex_lock(&this->lock);
+    this->timeout = timeout;
+    this->generation++;
+    pthread_mutex_unlock(&this->lock);
+}
+
+void HttpClientPool::AddHeader(const std::string& attr, const std::string& val)
+{
+    pthread_mutex_lock(&this->lock);
+    this->headers[attr] = val;
+    this->generation++;
+    pthread_mutex_unlock(&this->lock);
+}
+
+void HttpClientPool::RemoveHeader(const std::string& attr)
+{
+    pthread_mutex_lock(&this->lock);
+    this->headers.erase(attr);
+    this->generation++;
+    pthread_mutex_unlock(&this->lock);
+}
+
+unsigned int HttpClientPool::GetHandleCount()
+{
+    pthread_mutex_lock(&this->lock);
+    unsigned int count = this->handles.size();
+    pthread_mutex_unlock(&this->lock);
+    return count;
+}
+
+HttpClientPool::Handle* HttpClientPool::Acquire() throw (JsonRpcException)
+{
+    pthread_mutex_lock(&this->lock);
+    while (this->idle.empty() && this->handles.size() >= this->maxHandles)
+        pthread_cond_wait(&this->released, &this->lock);
+
+    Handle *handle = NULL;
+    if (!this->idle.empty())
+    {
+        //The most recently used handle is the most likely to have a live connection.
+        handle = this->idle.back();
+        this->idle.pop_back();
+    }
+    else
+    {
+        CURL *curl = curl_easy_init();
+        if (curl == NULL)
+        {
+            pthread_mutex_unlock(&this->lock);
+            throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, "libcurl error: could not create a handle");
+        }
+        handle = new Handle();
+        handle->curl = curl;
+        handle->headers = NULL;
+        handle->generation = this->generation - 1;
+        handle->response.data = NULL;
+        handle->response.size = 0;
+        handle->response.capacity = 0;
+        this->handles.push_back(handle);
+
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writefunc);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &handle->response);
+        curl_easy_setopt(curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+        //Timeouts must not use signals when several threads perform transfers.
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    }
+    if (handle->generation != this->generation)
+        this->Configure(handle);
+    pthread_mutex_unlock(&this->lock);
+    return handle;
+}
+
+void HttpClientPool::Release(Handle* handle)
+{
+    pthread_mutex_lock(&this->lock);
+    this->idle.push_back(handle);
+    pthread_cond_signal(&this->released);
+    pthread_mutex_unlock(&this->lock);
+}
+
+void HttpClientPool::Configure(Handle* handle)
+{
+    curl_slist_free_all(handle->headers);
+    handle->headers = NULL;
+    for (std::map<std::string, std::string>::iterator header = this->headers.begin(); header != this->headers.end(); ++header) {
+        handle->headers = curl_slist_append(handle->headers, (header->first + ": " + header->second).c_str());
+    }
+    handle->headers = curl_slist_append(handle->headers, "Content-Type: application/json");
+    handle->headers = curl_slist_append(handle->headers, "charsets: utf-8");
+
+    curl_easy_setopt(handle->curl, CURLOPT_URL, this->url.c_str());
+    curl_easy_setopt(handle->curl, CURLOPT_HTTPHEADER, handle->headers);
+    curl_easy_setopt(handle->curl, CURLOPT_TIMEOUT_MS, this->timeout);
+    handle->generation = this->generation;
+}
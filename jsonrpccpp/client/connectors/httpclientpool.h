@@ -0,0 +1,79 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    httpclientpool.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_HTTPCLIENTPOOL_H_
+#define JSONRPC_CPP_HTTPCLIENTPOOL_H_
+
+#include "../iclientconnector.h"
+#include <jsonrpccpp/common/exception.h>
+#include <curl/curl.h>
+#include <pthread.h>
+#include <map>
+#include <vector>
+
+namespace jsonrpc
+{
+    /**
+     * An HTTP client connector that can be shared by any number of threads.
+     *
+     * Every call borrows a curl handle from a pool and returns it afterwards. A handle keeps its connection to the server
+     * open between calls (HTTP keep-alive), builds its header list only when the headers have changed and reuses its
+     * response buffer, so a call in steady state allocates little more than the result string.
+     */
+    class HttpClientPool : public IClientConnector
+    {
+        public:
+            /**
+             * @param maxHandles - the number of calls that can be in flight at once, further callers wait for a free handle.
+             */
+            HttpClientPool(const std::string& url, unsigned int maxHandles = 4) throw (JsonRpcException);
+            virtual ~HttpClientPool();
+            virtual void SendRPCMessage(const std::string& message, std::string& result) throw (JsonRpcException);
+
+            /**
+             * The settings apply to calls started afterwards, calls in flight are not affected.
+             */
+            void SetUrl(const std::string& url);
+            void SetTimeout(long timeout);
+
+            void AddHeader(const std::string& attr, const std::string& val);
+            void RemoveHeader(const std::string& attr);
+
+            /**
+             * @return the number of handles created so far, at most maxHandles.
+             */
+            unsigned int GetHandleCount();
+
+        private:
+            struct Handle;
+
+            std::map<std::string,std::string> headers;
+            std::string url;
+
+            /**
+             * @brief timeout for http request in milliseconds
+             */
+            long timeout;
+            unsigned int maxHandles;
+            unsigned int generation;        /*!< Incremented when the settings change, handles pick them up on their next call*/
+
+            std::vector<Handle*> handles;   /*!< All handles, idle or borrowed*/
+            std::vector<Handle*> idle;
+            pthread_mutex_t lock;           /*!< Protects the settings and the handles*/
+            pthread_cond_t released;
+
+            Handle* Acquire() throw (JsonRpcException);
+            void Release(Handle* handle);
+            void Configure(Handle* handle);
+
+            HttpClientPool(const HttpClientPool&);
+            HttpClientPool& operator=(const HttpClientPool&);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_HTTPCLIENTPOOL_H_ */
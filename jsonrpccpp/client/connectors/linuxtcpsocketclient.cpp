@@ -14,24 +14,41 @@
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <iostream>
 #include <errno.h>
 #include <cstring>
+#include <jsonrpccpp/common/cbor.h>
+
+using namespace jsonrpc;
+using namespace std;
 
-#define BUFFER_SIZE 64
 #ifndef DELIMITER_CHAR
 #define DELIMITER_CHAR char(0x0A)
 #endif //DELIMITER_CHAR
 
-using namespace jsonrpc;
-using namespace std;
+static void EncodeFrame(const Json::Value& message, string& frame)
+{
+	frame.assign(BinaryFraming::HEADER_SIZE, 0);
+	Cbor::Encode(message, frame);
+	BinaryFraming::WriteHeader(frame.size() - BinaryFraming::HEADER_SIZE, &frame[0]);
+}
+
+static void DecodePayload(const string& payload, Json::Value& result) throw (JsonRpcException)
+{
+	result = Json::Value();
+	if(!payload.empty() && !Cbor::Decode(payload.data(), payload.data() + payload.size(), result))
+		throw JsonRpcException(Errors::ERROR_CLIENT_INVALID_RESPONSE, "Invalid CBOR response");
+}
 
 LinuxTcpSocketClient::LinuxTcpSocketClient(const std::string& hostToConnect, const unsigned int &port) :
 	TcpSocketClientPrivate(),
 	hostToConnect(hostToConnect),
-	port(port)
+	port(port),
+	keepAlive(false),
+	binaryFraming(false)
 {
 }
 
@@ -41,84 +58,115 @@ LinuxTcpSocketClient::~LinuxTcpSocketClient()
 
 void LinuxTcpSocketClient::SendRPCMessage(const std::string& message, std::string& result) throw (JsonRpcException)
 {
-	int socket_fd = this->Connect();
-	char buffer[BUFFER_SIZE];
+	vector<string> messages(1, message);
+	vector<string> results;
+	this->SendRPCMessages(messages, results);
+	result.append(results[0]);
+}
 
-	bool fullyWritten = false;
-	string toSend = message;
-	do
+void LinuxTcpSocketClient::SendRPCMessages(const std::vector<std::string>& messages, std::vector<std::string>& results) throw (JsonRpcException)
+{
+	if(!this->keepAlive)
 	{
-		ssize_t byteWritten = send(socket_fd, toSend.c_str(), toSend.size(), 0);
-		if(byteWritten == -1)
+		results.clear();
+		for(size_t i = 0; i < messages.size(); i++)
 		{
-			string message = "send() failed";
-			int err = errno;
-			switch(err)
-			{
-				case EACCES:
-				case EWOULDBLOCK:
-				case EBADF:
-				case ECONNRESET:
-				case EDESTADDRREQ:
-				case EFAULT:
-				case EINTR:
-				case EINVAL:
-				case EISCONN:
-				case EMSGSIZE:
-				case ENOBUFS:
-				case ENOMEM:
-				case ENOTCONN:
-				case ENOTSOCK:
-				case EOPNOTSUPP:
-				case EPIPE:
-					message = strerror(err);
-					break;
-			}
-			close(socket_fd);
-			throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, message);
-		}
-		else if(static_cast<size_t>(byteWritten) < toSend.size())
-		{
-			int len = toSend.size() - byteWritten;
-			toSend = toSend.substr(byteWritten, len);
+			vector<string> single(1, messages[i]);
+			vector<string> response;
+			this->connection.Attach(this->Connect());
+			this->connection.Exchange(single, response);
+			this->connection.Close();
+			results.push_back(response[0]);
 		}
-		else
-			fullyWritten = true;
-	} while(!fullyWritten);
+		return;
+	}
 
-	do
+	this->Reconnect();
+	if(!this->connection.IsFramed())
 	{
-		int nbytes = recv(socket_fd, buffer, BUFFER_SIZE, 0);
-		if(nbytes == -1)
-		{
-			string message = "recv() failed";
-			int err = errno;
-			switch(err)
-			{
-				case EWOULDBLOCK:
-				case EBADF:
-				case ECONNRESET:
-				case EFAULT:
-				case EINTR:
-				case EINVAL:
-				case ENOMEM:
-				case ENOTCONN:
-				case ENOTSOCK:
-					message = strerror(err);
-					break;
-			}
-			close(socket_fd);
-			throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, message);
-		}
-		else
-		{
-			string tmp;
-			tmp.append(buffer, nbytes);
-			result.append(buffer,nbytes);
-		}
-	} while(result.find(DELIMITER_CHAR) == string::npos);
+		this->connection.Exchange(messages, results);
+		return;
+	}
+
+	//The server only reads frames on this connection, text built by the caller is converted.
+	Json::Reader reader;
+	Json::FastWriter writer;
+	vector<string> frames(messages.size());
+	vector<string> payloads;
+	for(size_t i = 0; i < messages.size(); i++)
+	{
+		Json::Value message;
+		if(!reader.parse(messages[i], message, false))
+			throw JsonRpcException(Errors::ERROR_RPC_JSON_PARSE_ERROR, " " + messages[i]);
+		EncodeFrame(message, frames[i]);
+	}
+	this->connection.Exchange(frames, payloads);
+	results.clear();
+	for(size_t i = 0; i < payloads.size(); i++)
+	{
+		Json::Value response;
+		DecodePayload(payloads[i], response);
+		results.push_back(payloads[i].empty() ? string(1, DELIMITER_CHAR) : writer.write(response));
+	}
+}
+
+bool LinuxTcpSocketClient::SendJsonMessage(const Json::Value& message, Json::Value& result) throw (JsonRpcException)
+{
+	if(!this->keepAlive || !this->binaryFraming)
+		return false;
+	this->Reconnect();
+	if(!this->connection.IsFramed())
+		return false;
+
+	vector<string> frames(1);
+	vector<string> payloads;
+	EncodeFrame(message, frames[0]);
+	this->connection.Exchange(frames, payloads);
+	DecodePayload(payloads[0], result);
+	return true;
+}
+
+void LinuxTcpSocketClient::Reconnect() throw (JsonRpcException)
+{
+	if(!this->connection.IsClosedByPeer())
+		return;
+	this->connection.Attach(this->OpenConnection());
+	if(this->binaryFraming)
+	{
+		vector<string> preamble(1, string(BinaryFraming::PREAMBLE, BinaryFraming::PREAMBLE_SIZE) + DELIMITER_CHAR);
+		vector<string> answer;
+		this->connection.Exchange(preamble, answer);
+		//A server without binary framing answers with a parse error, the connection then stays in text mode.
+		this->connection.SetFramed(answer[0] == preamble[0]);
+	}
+}
 
-	close(socket_fd);
+int LinuxTcpSocketClient::OpenConnection() throw (JsonRpcException)
+{
+	int socket_fd = this->Connect();
+	//Pipelined requests are small writes that must not wait for the acknowledgement of the previous one.
+	int nodelay = 1;
+	setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+	return socket_fd;
+}
+
+void LinuxTcpSocketClient::SetKeepAlive(bool keepAlive)
+{
+	this->keepAlive = keepAlive;
+	if(!keepAlive)
+		this->connection.Close();
+}
+
+void LinuxTcpSocketClient::SetTimeout(long timeout)
+{
+	this->connection.SetTimeout(timeout > 0 ? (timeout < 0x7FFFFFFF ? timeout : 0x7FFFFFFF) : -1);
+}
+
+void LinuxTcpSocketClient::SetBinaryFraming(bool binary)
+{
+	//Framing is negotiated per connection, the next call opens a new one.
+	this->binaryFraming = binary;
+	this->connection.Close();
 }
 
 int LinuxTcpSocketClient::Connect() throw (JsonRpcException)
@@ -12,15 +12,19 @@
 
 #include <jsonrpccpp/common/exception.h>
 #include <string>
+#include <vector>
 #include "tcpsocketclientprivate.h"
+#include "socketconnection.h"
 
 namespace jsonrpc
 {
 	/**
 	 * This class is the Linux/UNIX implementation of TCPSocketClient.
 	 * It uses the POSIX socket API to performs its job.
+	 * By default every call opens its own connection; SetKeepAlive() keeps one connection open across calls.
+	 * A kept connection can carry CBOR frames instead of text, see SetBinaryFraming().
 	 */
-	class LinuxTcpSocketClient : public TcpSocketClientPrivate
+	class LinuxTcpSocketClient : public TcpSocketClientPrivate, public IClientStreamConnector, public IClientJsonConnector
 	{
 		public:
 			/**
@@ -40,10 +44,55 @@ namespace jsonrpc
 			 * @throw JsonRpcException Thrown when an issue is encountered with socket manipulation (see message of exception for more information about what happened).
 			 */
 			virtual void SendRPCMessage(const std::string& message, std::string& result) throw (JsonRpcException);
+			/**
+			 * @brief Pipelines several requests: all of them are written before the responses have to be read.
+			 * 
+			 * Without keep-alive every message still gets its own connection.
+			 * @param messages The messages to send
+			 * @param results The responses, in the order of the messages
+			 * @throw JsonRpcException Thrown when an issue is encountered with socket manipulation (see message of exception for more information about what happened).
+			 */
+			void SendRPCMessages(const std::vector<std::string>& messages, std::vector<std::string>& results) throw (JsonRpcException);
+			/**
+			 * @brief Keeps the connection open between calls instead of connecting for every call.
+			 * 
+			 * The server has to run in keep-alive mode as well. A connection closed by the server is reopened on the next call.
+			 * @param keepAlive true to reuse the connection
+			 */
+			void SetKeepAlive(bool keepAlive);
+			/**
+			 * @brief Limits how long a call waits for its response, like HttpClient::SetTimeout. A call that times out fails with
+			 * ERROR_CLIENT_CONNECTOR and closes the connection, the next call opens a new one.
+			 * @param timeout The limit in milliseconds, 0 to wait as long as it takes, the default
+			 */
+			void SetTimeout(long timeout);
+			/**
+			 * @brief Asks the server to switch the kept connection to CBOR encoded, length prefixed frames.
+			 * 
+			 * The switch is negotiated when the connection is opened, see BinaryFraming. If the server refuses, the connection stays in text mode.
+			 * Only applies with keep-alive. Text messages passed to SendRPCMessage are converted, Client sends JSON values directly.
+			 * @param binary true to ask for binary framing on the next connection
+			 */
+			void SetBinaryFraming(bool binary);
+			/**
+			 * @brief The IClientJsonConnector::SendJsonMessage method, used by Client.
+			 * @returns false unless the connection uses binary framing.
+			 * @throw JsonRpcException Thrown when an issue is encountered with socket manipulation or the response cannot be decoded.
+			 */
+			bool SendJsonMessage(const Json::Value& message, Json::Value& result) throw (JsonRpcException);
+			/**
+			 * @brief Opens a connection of its own for an AsyncClient. The server has to run in keep-alive mode.
+			 * @returns A file descriptor to the connected socket, owned by the caller
+			 * @throw JsonRpcException Thrown when the connection could not be established.
+			 */
+			int OpenConnection() throw (JsonRpcException);
 
 		private:
 			std::string hostToConnect;    /*!< The hostname or the ipv4 address on which the client should try to connect*/
 			unsigned int port;          /*!< The port on which the client should try to connect*/
+			bool keepAlive;             /*!< True if the connection is kept open between calls*/
+			bool binaryFraming;         /*!< True if binary framing is asked for on new connections*/
+			SocketConnection connection; /*!< The connection to the server*/
 			/**
 			 * @brief Connects to the host and port provided by constructor parameters.
 			 * 
@@ -55,6 +104,11 @@ namespace jsonrpc
 			 * @throw JsonRpcException Thrown when an issue is encountered while trying to connect (see message of exception for more information about what happened).
 			 */
 			int Connect() throw (JsonRpcException);
+			/**
+			 * @brief Reopens the kept connection if the server has closed it and negotiates binary framing if it is asked for.
+			 * @throw JsonRpcException Thrown when the connection could not be established.
+			 */
+			void Reconnect() throw (JsonRpcException);
 			/**
 			 * @brief Connects to provided ip and port.
 			 * 
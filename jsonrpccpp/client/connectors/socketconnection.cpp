@@ -0,0 +1,241 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    socketconnection.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "socketconnection.h"
+#include <jsonrpccpp/common/cbor.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#define BUFFER_SIZE 4096
+#ifndef DELIMITER_CHAR
+#define DELIMITER_CHAR char(0x0A)
+#endif //DELIMITER_CHAR
+
+using namespace jsonrpc;
+using namespace std;
+
+/**
+ * Milliseconds until deadline, rounded up so poll() does not return just before it. 0 once it has passed.
+ */
+static int RemainingMs(const struct timespec &deadline)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long ns = (deadline.tv_sec - now.tv_sec) * 1000000000LL + (deadline.tv_nsec - now.tv_nsec);
+    return ns > 0 ? static_cast<int>((ns + 999999) / 1000000) : 0;
+}
+
+SocketConnection::SocketConnection() :
+    fd(-1),
+    scanned(0),
+    framed(false),
+    timeoutMs(-1)
+{
+}
+
+SocketConnection::~SocketConnection()
+{
+    this->Close();
+}
+
+void SocketConnection::Attach(int fd)
+{
+    this->Close();
+    this->fd = fd;
+}
+
+void SocketConnection::Close()
+{
+    if (this->fd >= 0)
+    {
+        close(this->fd);
+        this->fd = -1;
+    }
+    this->pending.clear();
+    this->scanned = 0;
+    this->framed = false;
+}
+
+bool SocketConnection::IsOpen() const
+{
+    return this->fd >= 0;
+}
+
+int SocketConnection::GetFd() const
+{
+    return this->fd;
+}
+
+void SocketConnection::SetFramed(bool framed)
+{
+    this->framed = framed;
+    this->scanned = 0;
+}
+
+bool SocketConnection::IsFramed() const
+{
+    return this->framed;
+}
+
+void SocketConnection::SetTimeout(int timeoutMs)
+{
+    this->timeoutMs = timeoutMs;
+}
+
+bool SocketConnection::IsClosedByPeer()
+{
+    if (this->fd < 0)
+        return true;
+
+    struct pollfd pfd;
+    pfd.fd = this->fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, 0) <= 0)
+        return false;
+    if (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))
+        return true;
+
+    char c;
+    ssize_t nbytes = recv(this->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return nbytes == 0 || (nbytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR);
+}
+
+/**
+ * Sends like send() and passes the descriptors with the bytes written, they reach the server together with the first of them.
+ */
+static ssize_t SendWithDescriptors(int fd, const char *data, size_t size, const vector<int> &descriptors)
+{
+    vector<char> control(CMSG_SPACE(sizeof(int) * descriptors.size()));
+    struct iovec io;
+    io.iov_base = const_cast<char*>(data);
+    io.iov_len = size;
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &io;
+    message.msg_iovlen = 1;
+    message.msg_control = &control[0];
+    message.msg_controllen = control.size();
+    struct cmsghdr *header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int) * descriptors.size());
+    memcpy(CMSG_DATA(header), &descriptors[0], sizeof(int) * descriptors.size());
+    return sendmsg(fd, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+
+void SocketConnection::Exchange(const vector<string> &messages, vector<string> &results, const vector<int> *descriptors) throw (JsonRpcException)
+{
+    char buffer[BUFFER_SIZE];
+    size_t message = 0;
+    size_t offset = 0;
+    struct timespec deadline;
+    if (this->timeoutMs >= 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += this->timeoutMs / 1000;
+        deadline.tv_nsec += (this->timeoutMs % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    results.clear();
+    results.reserve(messages.size());
+    while (results.size() < messages.size())
+    {
+        if (this->TakeResponse(results))
+            continue;
+
+        struct pollfd pfd;
+        pfd.fd = this->fd;
+        pfd.events = POLLIN;
+        if (message < messages.size())
+            pfd.events |= POLLOUT;
+        pfd.revents = 0;
+        int wait = (this->timeoutMs >= 0) ? RemainingMs(deadline) : -1;
+        if (wait == 0)
+            this->Fail("Timeout while waiting for the response");
+        if (poll(&pfd, 1, wait) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            this->Fail(strerror(errno));
+        }
+
+        if ((pfd.revents & POLLOUT) && message < messages.size())
+        {
+            const string &toSend = messages[message];
+            ssize_t byteWritten;
+            //The descriptors go with the first write that succeeds, later ones send the rest of the message.
+            if (message == 0 && offset == 0 && descriptors != NULL && !descriptors->empty())
+                byteWritten = SendWithDescriptors(this->fd, toSend.data(), toSend.size(), *descriptors);
+            else
+                byteWritten = send(this->fd, toSend.data() + offset, toSend.size() - offset, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (byteWritten < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                this->Fail(strerror(errno));
+            if (byteWritten > 0)
+                offset += byteWritten;
+            if (offset == toSend.size())
+            {
+                message++;
+                offset = 0;
+            }
+        }
+        if (pfd.revents & (POLLIN | POLLHUP | POLLERR))
+        {
+            ssize_t nbytes = recv(this->fd, buffer, BUFFER_SIZE, MSG_DONTWAIT);
+            if (nbytes == 0)
+                this->Fail("Connection closed by server");
+            if (nbytes < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                this->Fail(strerror(errno));
+            if (nbytes > 0)
+                this->pending.append(buffer, nbytes);
+        }
+    }
+}
+
+bool SocketConnection::TakeResponse(vector<string> &results)
+{
+    if (this->framed)
+    {
+        if (this->pending.size() < BinaryFraming::HEADER_SIZE)
+            return false;
+        size_t size = BinaryFraming::ReadHeader(this->pending.data());
+        if (size > BinaryFraming::MAX_PAYLOAD_SIZE)
+            this->Fail("Invalid frame received");
+        if (this->pending.size() - BinaryFraming::HEADER_SIZE < size)
+            return false;
+        results.push_back(this->pending.substr(BinaryFraming::HEADER_SIZE, size));
+        this->pending.erase(0, BinaryFraming::HEADER_SIZE + size);
+        return true;
+    }
+    size_t pos = this->pending.find(DELIMITER_CHAR, this->scanned);
+    if (pos == string::npos)
+    {
+        this->scanned = this->pending.size();
+        return false;
+    }
+    results.push_back(this->pending.substr(0, pos + 1));
+    this->pending.erase(0, pos + 1);
+    this->scanned = 0;
+    return true;
+}
+
+void SocketConnection::Fail(const string &message) throw (JsonRpcException)
+{
+    this->Close();
+    throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, message);
+}
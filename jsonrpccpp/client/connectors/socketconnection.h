@@ -0,0 +1,82 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    socketconnection.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_SOCKETCONNECTION_H_
+#define JSONRPC_CPP_SOCKETCONNECTION_H_
+
+#include <jsonrpccpp/common/exception.h>
+#include <string>
+#include <vector>
+
+namespace jsonrpc
+{
+    /**
+     * A connected stream socket that exchanges delimiter terminated messages.
+     * Bytes received after the last complete message are kept for the next exchange, so the
+     * connection can stay open across calls and carry pipelined requests.
+     */
+    class SocketConnection
+    {
+        public:
+            SocketConnection();
+            virtual ~SocketConnection();
+
+            /**
+             * @brief Takes ownership of a connected socket, closing the previous one.
+             */
+            void Attach(int fd);
+            void Close();
+
+            bool IsOpen() const;
+            int GetFd() const;
+
+            /**
+             * @brief Checks without blocking whether the server has closed or reset the connection.
+             */
+            bool IsClosedByPeer();
+
+            /**
+             * @brief Switches the responses between delimiter terminated messages and length prefixed frames, see BinaryFraming.
+             * Framed responses are returned as their payload, without header. Attach() and Close() switch back to messages.
+             */
+            void SetFramed(bool framed);
+            bool IsFramed() const;
+
+            /**
+             * @brief Limits how long Exchange() waits for the responses, measured from its call. When the time is up, the connection
+             * is closed, so a late response cannot be taken for the next one.
+             * @param timeoutMs The limit in milliseconds, -1 to wait as long as it takes
+             */
+            void SetTimeout(int timeoutMs);
+
+            /**
+             * @brief Sends all messages and reads one response per message.
+             *
+             * Reading is interleaved with writing, so a long pipeline cannot dead lock with a server
+             * that only reads the next request after its previous response has been sent.
+             * On failure and timeout the connection is closed.
+             * @param messages The requests, each terminated by the delimiter or framed
+             * @param results One response per request, in the order received, including its delimiter
+             * @param descriptors Passed with the first message over SCM_RIGHTS, for unix domain sockets, NULL for none
+             * @throw JsonRpcException Thrown when the socket fails, the server closes the connection early or the timeout passes.
+             */
+            void Exchange(const std::vector<std::string>& messages, std::vector<std::string>& results, const std::vector<int>* descriptors = NULL) throw (JsonRpcException);
+
+        private:
+            int fd;
+            std::string pending;    /*!< Bytes received that do not belong to a returned response yet*/
+            size_t scanned;         /*!< Offset up to which pending has been searched for the delimiter*/
+            bool framed;
+            int timeoutMs;          /*!< The limit of an exchange, -1 for none*/
+
+            bool TakeResponse(std::vector<std::string>& results);
+            void Fail(const std::string& message) throw (JsonRpcException);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_SOCKETCONNECTION_H_ */
@@ -15,67 +15,99 @@
 #include <unistd.h>
 #include <iostream>
 
-#define BUFFER_SIZE 64
 #define PATH_MAX 108
-#ifndef DELIMITER_CHAR
-#define DELIMITER_CHAR char(0x0A)
-#endif //DELIMITER_CHAR
+#define MAX_DESCRIPTORS 253	/*!< SCM_MAX_FD, the most descriptors the kernel passes with one message*/
 
 using namespace jsonrpc;
 using namespace std;
 
-	UnixDomainSocketClient::UnixDomainSocketClient(const std::string& path)
-: path(path)
+UnixDomainSocketClient::UnixDomainSocketClient(const std::string& path) :
+	path(path),
+	keepAlive(true)
 {
-
-	socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
-	if (socket_fd < 0)
-	{
-        throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, "Could not create unix domain socket");
-	}
-
 	memset(&address, 0, sizeof(sockaddr_un));
 
     address.sun_family = AF_UNIX;
     snprintf(address.sun_path, PATH_MAX, "%s", this->path.c_str());
 
-	if(connect(socket_fd, (struct sockaddr *) &address,  sizeof(sockaddr_un)) != 0)
-	{
-		throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, "Could not connect to: " + this->path);
-	}
-
+	this->connection.Attach(this->Connect());
 }
 
 UnixDomainSocketClient::~UnixDomainSocketClient()
 {
-    close (socket_fd);
 }
 
 void UnixDomainSocketClient::SendRPCMessage(const std::string& message, std::string& result) throw (JsonRpcException)
 {
-	int nbytes;
-	char buffer[BUFFER_SIZE];
+	vector<string> messages(1, message);
+	vector<string> results;
+	this->SendRPCMessages(messages, results);
+	result.append(results[0]);
+}
 
-	bool fullyWritten = false;
-	string toSend = message;
-	do
+void UnixDomainSocketClient::SendRPCMessages(const std::vector<std::string>& messages, std::vector<std::string>& results) throw (JsonRpcException)
+{
+	vector<int> descriptors;
+	descriptors.swap(this->payloads);
+	if(!this->keepAlive)
 	{
-		ssize_t byteWritten = write(socket_fd, toSend.c_str(), toSend.size());
-		if(static_cast<size_t>(byteWritten) < toSend.size())
+		results.clear();
+		for(size_t i = 0; i < messages.size(); i++)
 		{
-			int len = toSend.size() - byteWritten;
-			toSend = toSend.substr(byteWritten + sizeof(char), len);
+			vector<string> single(1, messages[i]);
+			vector<string> response;
+			this->connection.Attach(this->Connect());
+			this->connection.Exchange(single, response, i == 0 ? &descriptors : NULL);
+			this->connection.Close();
+			results.push_back(response[0]);
 		}
-		else
-			fullyWritten = true;
-	} while(!fullyWritten);
+		return;
+	}
+
+	if(this->connection.IsClosedByPeer())
+	{
+		this->connection.Attach(this->Connect());
+	}
+	this->connection.Exchange(messages, results, &descriptors);
+}
+
+bool UnixDomainSocketClient::AttachPayload(const BulkPayload& payload)
+{
+	if(!payload.IsSealed() || this->payloads.size() >= MAX_DESCRIPTORS)
+		return false;
+	this->payloads.push_back(payload.GetFd());
+	return true;
+}
+
+void UnixDomainSocketClient::SetKeepAlive(bool keepAlive)
+{
+	this->keepAlive = keepAlive;
+	if(!keepAlive)
+		this->connection.Close();
+}
 
-	do
+void UnixDomainSocketClient::SetTimeout(long timeout)
+{
+	this->connection.SetTimeout(timeout > 0 ? (timeout < 0x7FFFFFFF ? timeout : 0x7FFFFFFF) : -1);
+}
+
+int UnixDomainSocketClient::OpenConnection() throw (JsonRpcException)
+{
+	return this->Connect();
+}
+
+int UnixDomainSocketClient::Connect() throw (JsonRpcException)
+{
+	int socket_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (socket_fd < 0)
 	{
-		nbytes = read(socket_fd, buffer, BUFFER_SIZE);
-		string tmp;
-		tmp.append(buffer, nbytes);
-		result.append(buffer,nbytes);
+        throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, "Could not create unix domain socket");
+	}
 
-	} while(result.find(DELIMITER_CHAR) == string::npos);
+	if(connect(socket_fd, (struct sockaddr *) &address,  sizeof(sockaddr_un)) != 0)
+	{
+		close(socket_fd);
+		throw JsonRpcException(Errors::ERROR_CLIENT_CONNECTOR, "Could not connect to: " + this->path);
+	}
+	return socket_fd;
 }
@@ -14,20 +14,60 @@
 #include <jsonrpccpp/common/exception.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <vector>
+#include "socketconnection.h"
+#include <jsonrpccpp/common/bulkpayload.h>
 
 namespace jsonrpc
 {
-	class UnixDomainSocketClient : public IClientConnector
+	/**
+	 * Sends requests over a unix domain socket. In keep-alive mode, the default, the connection opened by the
+	 * constructor is reused by all calls and reopened if the server closed it; otherwise every call connects.
+	 */
+	class UnixDomainSocketClient : public IClientConnector, public IClientStreamConnector
 	{
 		public:
 			UnixDomainSocketClient(const std::string& path);
 			virtual ~UnixDomainSocketClient();
 			virtual void SendRPCMessage(const std::string& message, std::string& result) throw (JsonRpcException);
 
+			/**
+			 * @brief Pipelines several requests: all of them are written before the responses have to be read.
+			 * @param messages The messages to send
+			 * @param results The responses, in the order of the messages
+			 */
+			void SendRPCMessages(const std::vector<std::string>& messages, std::vector<std::string>& results) throw (JsonRpcException);
+
+			void SetKeepAlive(bool keepAlive);
+			/**
+			 * @brief Limits how long a call waits for its response, like HttpClient::SetTimeout. A call that times out fails with
+			 * ERROR_CLIENT_CONNECTOR and closes the connection, the next call opens a new one.
+			 * @param timeout The limit in milliseconds, 0 to wait as long as it takes, the default
+			 */
+			void SetTimeout(long timeout);
+
+			/**
+			 * @brief Sends a bulk payload with the next request, as a descriptor instead of in the JSON text. The server
+			 * must accept them, see UnixDomainSocketServer::SetBulkPayloads. The request refers to its payloads by their
+			 * index in the order they were attached, procedures read them with CallContext::GetPayload().
+			 * The payload must stay open until the request has been sent, it is sent only once, whether the call succeeds or not.
+			 * @return false if the payload is not sealed or the request already carries the most descriptors the kernel passes.
+			 */
+			bool AttachPayload(const BulkPayload& payload);
+
+			/**
+			 * @brief Opens a connection of its own for an AsyncClient.
+			 */
+			int OpenConnection() throw (JsonRpcException);
+
 		private:
 			std::string path;
             sockaddr_un address;
-            int socket_fd;
+            bool keepAlive;
+            SocketConnection connection;
+            std::vector<int> payloads;  /*!< The descriptors of the payloads attached to the next request*/
+
+            int Connect() throw (JsonRpcException);
 	};
 
 } /* namespace jsonrpc */
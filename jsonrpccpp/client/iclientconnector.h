@@ -12,6 +12,7 @@
 
 #include <string>
 #include <jsonrpccpp/common/exception.h>
+#include <jsonrpccpp/common/jsonparser.h>
 
 namespace jsonrpc
 {
@@ -22,5 +23,36 @@ namespace jsonrpc
 
             virtual void SendRPCMessage(const std::string& message, std::string& result) throw(JsonRpcException) = 0;
     };
+
+    /**
+     * A connector that can open a persistent connection over which delimiter terminated messages flow in both directions,
+     * as used by AsyncClient.
+     */
+    class IClientStreamConnector
+    {
+        public:
+            virtual ~IClientStreamConnector(){}
+
+            /**
+             * @return a connected socket, the caller owns it.
+             */
+            virtual int OpenConnection() throw(JsonRpcException) = 0;
+    };
+
+    /**
+     * A connector that can carry messages as JSON values, e.g. in a binary encoding. Client detects it and then skips
+     * the text serialization of its requests and responses.
+     */
+    class IClientJsonConnector
+    {
+        public:
+            virtual ~IClientJsonConnector(){}
+
+            /**
+             * @param result - the response, null if there is none.
+             * @return false if the connection does not carry JSON values right now, the message has not been sent then.
+             */
+            virtual bool SendJsonMessage(const Json::Value& message, Json::Value& result) throw(JsonRpcException) = 0;
+    };
 } /* namespace jsonrpc */
 #endif /* JSONRPC_CPP_CLIENTCONNECTOR_H_ */
@@ -22,17 +22,24 @@ const std::string RpcProtocolClient::KEY_ERROR            = "error";
 const std::string RpcProtocolClient::KEY_ERROR_CODE       = "code";
 const std::string RpcProtocolClient::KEY_ERROR_MESSAGE    = "message";
 const std::string RpcProtocolClient::KEY_ERROR_DATA       = "data";
+const std::string RpcProtocolClient::KEY_DEADLINE         = "deadline";
 
 RpcProtocolClient::RpcProtocolClient(clientVersion_t version) :
-    version(version)
+    version(version),
+    deadline(0)
 {
 }
 
 void RpcProtocolClient::BuildRequest(const std::string &method, const Json::Value &parameter, std::string &result, bool isNotification)
+{
+    this->BuildRequest(1, method, parameter, result, isNotification);
+}
+
+void RpcProtocolClient::BuildRequest(int id, const std::string &method, const Json::Value &parameter, std::string &result, bool isNotification)
 {
     Json::Value request;
     Json::FastWriter writer;
-    this->BuildRequest(1, method,parameter,request, isNotification);
+    this->BuildRequest(id, method, parameter, request, isNotification);
     result = writer.write(request);
 }
 
@@ -81,6 +88,13 @@ void RpcProtocolClient::BuildRequest(int id, const std::string &method, const Js
         result[KEY_ID] = id;
     else if (this->version == JSONRPC_CLIENT_V1)
         result[KEY_ID] = Json::nullValue;
+    if (this->deadline != 0)
+        result[KEY_DEADLINE] = this->deadline;
+}
+
+void RpcProtocolClient::SetDeadline(unsigned int deadlineMs)
+{
+    this->deadline = deadlineMs;
 }
 
 void RpcProtocolClient::throwErrorException(const Json::Value &response)
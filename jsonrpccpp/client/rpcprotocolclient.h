@@ -28,8 +28,7 @@ namespace jsonrpc {
 
             /**
              * @brief This method builds a valid json-rpc 2.0 request object based on passed parameters.
-             * The id starts at 1 and is incremented for each request. To reset this value to one, call
-             * the jsonrpc::RpcProRpcProtocolClient::resetId() method.
+             * The id is always 1, use the overload taking an id when several calls are in flight on one connection.
              * @param method - name of method or notification to be called
              * @param parameter - parameters represented as json objects
              * @return the string representation of the request to be built.
@@ -45,6 +44,22 @@ namespace jsonrpc {
              */
             void BuildRequest(const std::string& method, const Json::Value& parameter, std::string& result, bool isNotification);
 
+            /**
+             * @brief Same as above with the given id, so the response can be matched to its request.
+             */
+            void BuildRequest(int id, const std::string& method, const Json::Value& parameter, std::string& result, bool isNotification);
+
+            /**
+             * @brief Same as above, but returns the request as a value for connectors that do not send text.
+             */
+            void BuildRequest(int id, const std::string& method, const Json::Value& parameter, Json::Value& result, bool isNotification);
+
+            /**
+             * @brief Adds a deadline to the requests built from now on: the server does not start a call it has received more
+             * than deadlineMs milliseconds ago, and procedures can look up the time left, see CallContext.
+             * @param deadlineMs - 0 for no deadline, the default.
+             */
+            void SetDeadline(unsigned int deadlineMs);
 
             /**
              * @brief Does the same as Json::Value RpcProtocolClient::HandleResponse(const std::string& response) throw(Exception)
@@ -70,11 +85,12 @@ namespace jsonrpc {
             static const std::string KEY_ERROR_CODE;
             static const std::string KEY_ERROR_MESSAGE;
             static const std::string KEY_ERROR_DATA;
+            static const std::string KEY_DEADLINE;
 
         private:
             clientVersion_t version;
+            unsigned int deadline;
 
-            void BuildRequest(int id, const std::string& method, const Json::Value& parameter, Json::Value& result, bool isNotification);
             bool ValidateResponse(const Json::Value &response);
             bool HasError(const Json::Value &response);
             void throwErrorException(const Json::Value &response);
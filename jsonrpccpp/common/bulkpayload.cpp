@@ -0,0 +1,143 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    bulkpayload.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "bulkpayload.h"
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace jsonrpc;
+
+#define REQUIRED_SEALS (F_SEAL_WRITE | F_SEAL_SHRINK)
+
+BulkPayload::BulkPayload() :
+    fd(-1),
+    data(NULL),
+    size(0),
+    sealed(false)
+{
+}
+
+BulkPayload::~BulkPayload()
+{
+    this->Close();
+}
+
+char* BulkPayload::Allocate(size_t size)
+{
+    this->Close();
+    this->fd = memfd_create("jsonrpc-payload", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (this->fd < 0)
+        return NULL;
+    if (ftruncate(this->fd, size) != 0)
+    {
+        this->Close();
+        return NULL;
+    }
+    this->size = size;
+    if (size == 0)
+        return NULL;
+    void *mapped = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        this->Close();
+        return NULL;
+    }
+    this->data = static_cast<char*>(mapped);
+    return this->data;
+}
+
+bool BulkPayload::Seal()
+{
+    if (this->fd < 0 || this->sealed)
+        return false;
+    //The kernel refuses the write seal while a writable shared mapping exists.
+    if (this->data != NULL)
+    {
+        munmap(this->data, this->size);
+        this->data = NULL;
+    }
+    if (fcntl(this->fd, F_ADD_SEALS, F_SEAL_WRITE | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+        return false;
+    this->sealed = true;
+    return this->MapReadOnly();
+}
+
+bool BulkPayload::Assign(const void *data, size_t size)
+{
+    char *target = this->Allocate(size);
+    if (this->fd < 0)
+        return false;
+    if (size > 0)
+        memcpy(target, data, size);
+    return this->Seal();
+}
+
+bool BulkPayload::Map(int fd)
+{
+    this->Close();
+    this->fd = fd;
+    int seals = fcntl(fd, F_GET_SEALS);
+    struct stat status;
+    if (seals < 0 || (seals & REQUIRED_SEALS) != REQUIRED_SEALS || fstat(fd, &status) != 0 || !S_ISREG(status.st_mode))
+    {
+        this->Close();
+        return false;
+    }
+    this->size = status.st_size;
+    this->sealed = true;
+    return this->MapReadOnly();
+}
+
+const char* BulkPayload::GetData() const
+{
+    return this->sealed ? this->data : NULL;
+}
+
+size_t BulkPayload::GetSize() const
+{
+    return this->size;
+}
+
+int BulkPayload::GetFd() const
+{
+    return this->fd;
+}
+
+bool BulkPayload::IsSealed() const
+{
+    return this->sealed;
+}
+
+void BulkPayload::Close()
+{
+    if (this->data != NULL)
+        munmap(this->data, this->size);
+    if (this->fd >= 0)
+        close(this->fd);
+    this->fd = -1;
+    this->data = NULL;
+    this->size = 0;
+    this->sealed = false;
+}
+
+bool BulkPayload::MapReadOnly()
+{
+    if (this->size == 0)
+        return true;
+    void *mapped = mmap(NULL, this->size, PROT_READ, MAP_SHARED, this->fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        this->Close();
+        return false;
+    }
+    this->data = static_cast<char*>(mapped);
+    return true;
+}
@@ -0,0 +1,85 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    bulkpayload.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_BULKPAYLOAD_H_
+#define JSONRPC_CPP_BULKPAYLOAD_H_
+
+#include <stddef.h>
+
+namespace jsonrpc
+{
+    /**
+     * Binary data that travels next to a request as a file descriptor instead of inside the JSON text, for clients on
+     * the same machine, see UnixDomainSocketClient::AttachPayload and CallContext::GetPayload.
+     *
+     * The data lives in a memfd. The client writes it into the memory returned by Allocate() and seals the memfd, so it
+     * can neither change nor shrink once sent. The server maps the descriptor it receives read-only, the procedure reads
+     * the pages the client has written without a copy.
+     */
+    class BulkPayload
+    {
+        public:
+            BulkPayload();
+            ~BulkPayload();
+
+            /**
+             * @brief Creates a memfd of size bytes for the data, replacing what the payload held before.
+             * @return where to write the data, valid until Seal() is called. NULL if size is 0 or the memfd could not be
+             * created, GetFd() tells these apart.
+             */
+            char* Allocate(size_t size);
+
+            /**
+             * @brief Seals the memfd filled through Allocate() against writing and resizing, it can be attached to requests then.
+             * @return false if there is nothing to seal or the seals could not be set.
+             */
+            bool Seal();
+
+            /**
+             * @brief Allocates, fills and seals the payload in one go, copying the data once.
+             */
+            bool Assign(const void* data, size_t size);
+
+            /**
+             * @brief Takes ownership of a received descriptor and maps it read-only. Replaces what the payload held before.
+             * @return false if fd is no memfd sealed against writing and shrinking, which a client could change or truncate
+             * under the procedure, or cannot be mapped. fd is closed then.
+             */
+            bool Map(int fd);
+
+            /**
+             * @return the data of a sealed or mapped payload, NULL before and for an empty payload.
+             */
+            const char* GetData() const;
+            size_t GetSize() const;
+
+            /**
+             * @return the memfd, -1 if there is none.
+             */
+            int GetFd() const;
+            bool IsSealed() const;
+
+            /**
+             * @brief Unmaps the data and closes the memfd.
+             */
+            void Close();
+
+        private:
+            int     fd;
+            char    *data;
+            size_t  size;
+            bool    sealed;
+
+            bool MapReadOnly();
+
+            BulkPayload(const BulkPayload&);
+            BulkPayload& operator=(const BulkPayload&);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_BULKPAYLOAD_H_ */
@@ -0,0 +1,397 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    cbor.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "cbor.h"
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+using namespace jsonrpc;
+using namespace std;
+
+#define CBOR_UNSIGNED   0
+#define CBOR_NEGATIVE   1
+#define CBOR_BYTES      2
+#define CBOR_TEXT       3
+#define CBOR_ARRAY      4
+#define CBOR_MAP        5
+#define CBOR_TAG        6
+#define CBOR_SIMPLE     7
+
+#define CBOR_INDEFINITE 31
+#define CBOR_BREAK      0xff
+#define CBOR_MAX_DEPTH  1000
+
+const char BinaryFraming::PREAMBLE[] = "\xd9\xd9\xf7";
+
+static void EncodeHead(int major, uint64_t value, string &target)
+{
+    char head[9];
+    size_t size;
+    if (value < 24)
+    {
+        head[0] = static_cast<char>((major << 5) | value);
+        size = 1;
+    }
+    else if (value <= 0xff)
+    {
+        head[0] = static_cast<char>((major << 5) | 24);
+        size = 2;
+    }
+    else if (value <= 0xffff)
+    {
+        head[0] = static_cast<char>((major << 5) | 25);
+        size = 3;
+    }
+    else if (value <= 0xffffffffULL)
+    {
+        head[0] = static_cast<char>((major << 5) | 26);
+        size = 5;
+    }
+    else
+    {
+        head[0] = static_cast<char>((major << 5) | 27);
+        size = 9;
+    }
+    for (size_t i = size - 1; i > 0; i--)
+    {
+        head[i] = static_cast<char>(value & 0xff);
+        value >>= 8;
+    }
+    target.append(head, size);
+}
+
+static void EncodeReal(double value, string &target)
+{
+    float single = static_cast<float>(value);
+    char data[9];
+    size_t size;
+    uint64_t bits;
+    if (static_cast<double>(single) == value || value != value)
+    {
+        uint32_t singleBits;
+        memcpy(&singleBits, &single, sizeof(singleBits));
+        bits = singleBits;
+        data[0] = static_cast<char>((CBOR_SIMPLE << 5) | 26);
+        size = 5;
+    }
+    else
+    {
+        memcpy(&bits, &value, sizeof(bits));
+        data[0] = static_cast<char>((CBOR_SIMPLE << 5) | 27);
+        size = 9;
+    }
+    for (size_t i = size - 1; i > 0; i--)
+    {
+        data[i] = static_cast<char>(bits & 0xff);
+        bits >>= 8;
+    }
+    target.append(data, size);
+}
+
+void Cbor::Encode(const Json::Value &value, string &target)
+{
+    switch (value.type())
+    {
+        case Json::nullValue:
+            target.push_back(static_cast<char>(0xf6));
+            break;
+        case Json::booleanValue:
+            target.push_back(static_cast<char>(value.asBool() ? 0xf5 : 0xf4));
+            break;
+        case Json::intValue:
+        {
+            Json::LargestInt i = value.asLargestInt();
+            if (i >= 0)
+                EncodeHead(CBOR_UNSIGNED, static_cast<uint64_t>(i), target);
+            else
+                EncodeHead(CBOR_NEGATIVE, static_cast<uint64_t>(-1 - i), target);
+            break;
+        }
+        case Json::uintValue:
+            EncodeHead(CBOR_UNSIGNED, value.asLargestUInt(), target);
+            break;
+        case Json::realValue:
+            EncodeReal(value.asDouble(), target);
+            break;
+        case Json::stringValue:
+        {
+            const char *begin = NULL;
+            const char *end = NULL;
+            value.getString(&begin, &end);
+            EncodeHead(CBOR_TEXT, end - begin, target);
+            target.append(begin, end - begin);
+            break;
+        }
+        case Json::arrayValue:
+        {
+            Json::ArrayIndex size = value.size();
+            EncodeHead(CBOR_ARRAY, size, target);
+            for (Json::ArrayIndex i = 0; i < size; i++)
+                Encode(value[i], target);
+            break;
+        }
+        case Json::objectValue:
+        {
+            EncodeHead(CBOR_MAP, value.size(), target);
+            for (Json::Value::const_iterator it = value.begin(); it != value.end(); ++it)
+            {
+                const char *end = NULL;
+                const char *begin = it.memberName(&end);
+                EncodeHead(CBOR_TEXT, end - begin, target);
+                target.append(begin, end - begin);
+                Encode(*it, target);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * Decodes one item at a time from a range, recursing into arrays and maps.
+ */
+class CborDecoder
+{
+    public:
+        CborDecoder(const unsigned char *begin, const unsigned char *end) :
+            pos(begin),
+            end(end)
+        {
+        }
+
+        bool Finished() const
+        {
+            return this->pos == this->end;
+        }
+
+        bool DecodeItem(Json::Value &value, int depth)
+        {
+            if (depth > CBOR_MAX_DEPTH || this->pos == this->end)
+                return false;
+            int major = *this->pos >> 5;
+            int info = *this->pos & 0x1f;
+            this->pos++;
+
+            if (major == CBOR_SIMPLE)
+                return this->DecodeSimple(info, value);
+
+            uint64_t argument = 0;
+            if (info == CBOR_INDEFINITE)
+            {
+                if (major == CBOR_BYTES || major == CBOR_TEXT)
+                    return this->DecodeChunkedString(major, value);
+                if (major == CBOR_ARRAY)
+                    return this->DecodeArray(0, true, value, depth);
+                if (major == CBOR_MAP)
+                    return this->DecodeMap(0, true, value, depth);
+                return false;
+            }
+            if (!this->ReadArgument(info, argument))
+                return false;
+
+            switch (major)
+            {
+                case CBOR_UNSIGNED:
+                    //The same types Json::Reader produces for the number in text.
+                    if (argument <= static_cast<uint64_t>(Json::Value::maxLargestInt))
+                        value = Json::Value(static_cast<Json::LargestInt>(argument));
+                    else
+                        value = Json::Value(static_cast<Json::LargestUInt>(argument));
+                    return true;
+                case CBOR_NEGATIVE:
+                    if (argument > static_cast<uint64_t>(Json::Value::maxLargestInt))
+                        return false;
+                    value = Json::Value(-1 - static_cast<Json::LargestInt>(argument));
+                    return true;
+                case CBOR_BYTES:
+                case CBOR_TEXT:
+                    if (argument > static_cast<uint64_t>(this->end - this->pos))
+                        return false;
+                    value = Json::Value(reinterpret_cast<const char*>(this->pos), reinterpret_cast<const char*>(this->pos + argument));
+                    this->pos += argument;
+                    return true;
+                case CBOR_ARRAY:
+                    return this->DecodeArray(argument, false, value, depth);
+                case CBOR_MAP:
+                    return this->DecodeMap(argument, false, value, depth);
+                case CBOR_TAG:
+                    return this->DecodeItem(value, depth + 1);
+            }
+            return false;
+        }
+
+    private:
+        const unsigned char *pos;
+        const unsigned char *end;
+
+        bool ReadArgument(int info, uint64_t &argument)
+        {
+            if (info < 24)
+            {
+                argument = info;
+                return true;
+            }
+            if (info > 27)
+                return false;
+            size_t size = static_cast<size_t>(1) << (info - 24);
+            if (size > static_cast<size_t>(this->end - this->pos))
+                return false;
+            argument = 0;
+            for (size_t i = 0; i < size; i++)
+                argument = (argument << 8) | this->pos[i];
+            this->pos += size;
+            return true;
+        }
+
+        bool AtBreak()
+        {
+            if (this->pos != this->end && *this->pos == CBOR_BREAK)
+            {
+                this->pos++;
+                return true;
+            }
+            return false;
+        }
+
+        bool DecodeSimple(int info, Json::Value &value)
+        {
+            uint64_t bits = 0;
+            switch (info)
+            {
+                case 20:
+                    value = false;
+                    return true;
+                case 21:
+                    value = true;
+                    return true;
+                case 22:
+                case 23:
+                    value = Json::Value();
+                    return true;
+                case 25:
+                {
+                    if (!this->ReadArgument(info, bits))
+                        return false;
+                    int exponent = (bits >> 10) & 0x1f;
+                    int mantissa = bits & 0x3ff;
+                    double half;
+                    if (exponent == 0)
+                        half = ldexp(static_cast<double>(mantissa), -24);
+                    else if (exponent != 31)
+                        half = ldexp(static_cast<double>(mantissa + 1024), exponent - 25);
+                    else
+                        half = (mantissa == 0) ? HUGE_VAL : NAN;
+                    value = (bits & 0x8000) ? -half : half;
+                    return true;
+                }
+                case 26:
+                {
+                    if (!this->ReadArgument(info, bits))
+                        return false;
+                    uint32_t singleBits = static_cast<uint32_t>(bits);
+                    float single;
+                    memcpy(&single, &singleBits, sizeof(single));
+                    value = static_cast<double>(single);
+                    return true;
+                }
+                case 27:
+                {
+                    if (!this->ReadArgument(info, bits))
+                        return false;
+                    double real;
+                    memcpy(&real, &bits, sizeof(real));
+                    value = real;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool DecodeChunkedString(int major, Json::Value &value)
+        {
+            string text;
+            while (!this->AtBreak())
+            {
+                if (this->pos == this->end || (*this->pos >> 5) != major)
+                    return false;
+                uint64_t size = 0;
+                int info = *this->pos & 0x1f;
+                this->pos++;
+                if (!this->ReadArgument(info, size) || size > static_cast<uint64_t>(this->end - this->pos))
+                    return false;
+                text.append(reinterpret_cast<const char*>(this->pos), size);
+                this->pos += size;
+            }
+            value = text;
+            return true;
+        }
+
+        bool DecodeArray(uint64_t size, bool indefinite, Json::Value &value, int depth)
+        {
+            //Every item takes at least one byte, this rejects lengths that would only exhaust memory.
+            if (!indefinite && size > static_cast<uint64_t>(this->end - this->pos))
+                return false;
+            value = Json::Value(Json::arrayValue);
+            if (!indefinite && size > 0)
+                value.resize(static_cast<Json::ArrayIndex>(size));
+            for (Json::ArrayIndex i = 0; indefinite || i < size; i++)
+            {
+                if (indefinite && this->AtBreak())
+                    break;
+                if (!this->DecodeItem(value[i], depth + 1))
+                    return false;
+            }
+            return true;
+        }
+
+        bool DecodeMap(uint64_t size, bool indefinite, Json::Value &value, int depth)
+        {
+            if (!indefinite && size > static_cast<uint64_t>(this->end - this->pos) / 2)
+                return false;
+            value = Json::Value(Json::objectValue);
+            for (uint64_t i = 0; indefinite || i < size; i++)
+            {
+                if (indefinite && this->AtBreak())
+                    break;
+                Json::Value key;
+                if (!this->DecodeItem(key, depth + 1) || !key.isString())
+                    return false;
+                const char *begin = NULL;
+                const char *keyEnd = NULL;
+                key.getString(&begin, &keyEnd);
+                if (!this->DecodeItem(value[string(begin, keyEnd)], depth + 1))
+                    return false;
+            }
+            return true;
+        }
+};
+
+bool Cbor::Decode(const char *begin, const char *end, Json::Value &value)
+{
+    CborDecoder decoder(reinterpret_cast<const unsigned char*>(begin), reinterpret_cast<const unsigned char*>(end));
+    return decoder.DecodeItem(value, 0) && decoder.Finished();
+}
+
+void BinaryFraming::WriteHeader(size_t payloadSize, char *header)
+{
+    header[0] = static_cast<char>((payloadSize >> 24) & 0xff);
+    header[1] = static_cast<char>((payloadSize >> 16) & 0xff);
+    header[2] = static_cast<char>((payloadSize >> 8) & 0xff);
+    header[3] = static_cast<char>(payloadSize & 0xff);
+}
+
+size_t BinaryFraming::ReadHeader(const char *header)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char*>(header);
+    return (static_cast<size_t>(bytes[0]) << 24) | (static_cast<size_t>(bytes[1]) << 16) | (static_cast<size_t>(bytes[2]) << 8) | bytes[3];
+}
+
+bool BinaryFraming::IsPreamble(const char *begin, const char *end)
+{
+    return static_cast<size_t>(end - begin) == PREAMBLE_SIZE + 1 && memcmp(begin, PREAMBLE, PREAMBLE_SIZE) == 0;
+}
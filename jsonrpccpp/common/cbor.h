@@ -0,0 +1,65 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    cbor.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_CBOR_H_
+#define JSONRPC_CPP_CBOR_H_
+
+#include <stddef.h>
+#include <string>
+#include "jsonparser.h"
+
+namespace jsonrpc
+{
+    /**
+     * Converts between Json::Value and CBOR (RFC 7049).
+     * Numbers keep their JSON type: integers are encoded as CBOR integers, reals as single precision floats
+     * if that is lossless and as double precision otherwise, which halves the size of typical measurement arrays.
+     */
+    class Cbor
+    {
+        public:
+            /**
+             * @brief Appends the encoding of value to target.
+             */
+            static void Encode(const Json::Value& value, std::string& target);
+
+            /**
+             * @brief Decodes exactly one item filling [begin, end).
+             * Byte strings become strings, tags are ignored, map keys must be strings.
+             * @return false if the range is not a well formed item or nests deeper than 1000 levels.
+             */
+            static bool Decode(const char* begin, const char* end, Json::Value& value);
+    };
+
+    /**
+     * The binary mode of the socket connectors.
+     *
+     * A client asks for it by sending PREAMBLE followed by the delimiter as its first message, a server that supports it
+     * answers with the same bytes. From then on both sides exchange frames: a 4 byte big endian payload length followed
+     * by the CBOR encoded message, an empty payload where a text connection would send an empty line.
+     * A server without binary mode answers the preamble with a parse error and the connection goes on in text mode.
+     */
+    class BinaryFraming
+    {
+        public:
+            static const char PREAMBLE[];           /*!< The CBOR self-describe tag, no JSON text starts with it*/
+            static const size_t PREAMBLE_SIZE = 3;
+            static const size_t HEADER_SIZE = 4;
+            static const size_t MAX_PAYLOAD_SIZE = 256 * 1024 * 1024;
+
+            static void WriteHeader(size_t payloadSize, char* header);
+            static size_t ReadHeader(const char* header);
+
+            /**
+             * @return true if [begin, end) is the preamble message, delimiter included.
+             */
+            static bool IsPreamble(const char* begin, const char* end);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_CBOR_H_ */
@@ -27,6 +27,9 @@ const int Errors::ERROR_SERVER_PROCEDURE_POINTER_IS_NULL =            -32606;
 const int Errors::ERROR_SERVER_PROCEDURE_SPECIFICATION_NOT_FOUND =    -32000;
 const int Errors::ERROR_SERVER_CONNECTOR =                            -32002;
 const int Errors::ERROR_SERVER_PROCEDURE_SPECIFICATION_SYNTAX =       -32007;
+const int Errors::ERROR_SERVER_BUSY =                                 -32008;
+const int Errors::ERROR_SERVER_SUBSCRIPTION =                         -32009;
+const int Errors::ERROR_SERVER_DEADLINE_EXCEEDED =                    -32010;
 
 const int Errors::ERROR_CLIENT_CONNECTOR =   -32003;
 const int Errors::ERROR_CLIENT_INVALID_RESPONSE =     -32001;
@@ -56,6 +59,9 @@ Errors::_init::_init() {
     possibleErrors[ERROR_CLIENT_INVALID_RESPONSE] = "The response is invalid";
     possibleErrors[ERROR_CLIENT_CONNECTOR] = "Client connector error";
     possibleErrors[ERROR_SERVER_CONNECTOR] = "Server connector error";
+    possibleErrors[ERROR_SERVER_BUSY] = "SERVER_BUSY: The server is overloaded, retry later";
+    possibleErrors[ERROR_SERVER_SUBSCRIPTION] = "SUBSCRIPTION: The connection cannot receive notifications from the server";
+    possibleErrors[ERROR_SERVER_DEADLINE_EXCEEDED] = "DEADLINE_EXCEEDED: The deadline of the call passed before it was executed";
 }
 
 std::string Errors::GetErrorMessage(int errorCode)
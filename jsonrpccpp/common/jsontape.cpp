@@ -0,0 +1,683 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    jsontape.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "jsontape.h"
+#include <string.h>
+#include <sstream>
+
+using namespace jsonrpc;
+using namespace std;
+
+#define JSONTAPE_MAX_DEPTH 1000
+
+static bool DecodeHex(const char *position, unsigned int &code)
+{
+    code = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        char c = position[i];
+        code *= 16;
+        if (c >= '0' && c <= '9')
+            code += c - '0';
+        else if (c >= 'a' && c <= 'f')
+            code += c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            code += c - 'A' + 10;
+        else
+            return false;
+    }
+    return true;
+}
+
+static void AppendUtf8(unsigned int code, string &target)
+{
+    if (code <= 0x7f)
+    {
+        target += static_cast<char>(code);
+    }
+    else if (code <= 0x7ff)
+    {
+        target += static_cast<char>(0xc0 | (code >> 6));
+        target += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else if (code <= 0xffff)
+    {
+        target += static_cast<char>(0xe0 | (code >> 12));
+        target += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        target += static_cast<char>(0x80 | (code & 0x3f));
+    }
+    else
+    {
+        target += static_cast<char>(0xf0 | (code >> 18));
+        target += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+        target += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        target += static_cast<char>(0x80 | (code & 0x3f));
+    }
+}
+
+//The escapes have been checked by JsonTape::ParseString(), a high surrogate is always followed by another \u.
+static void DecodeString(const char *begin, const char *end, string &target)
+{
+    target.clear();
+    target.reserve(end - begin);
+    while (begin != end)
+    {
+        const char *escape = static_cast<const char*>(memchr(begin, '\\', end - begin));
+        if (escape == NULL)
+        {
+            target.append(begin, end);
+            return;
+        }
+        target.append(begin, escape);
+        switch (escape[1])
+        {
+            case 'b': target += '\b'; break;
+            case 'f': target += '\f'; break;
+            case 'n': target += '\n'; break;
+            case 'r': target += '\r'; break;
+            case 't': target += '\t'; break;
+            case 'u':
+            {
+                unsigned int code;
+                DecodeHex(escape + 2, code);
+                if (code >= 0xd800 && code <= 0xdbff)
+                {
+                    unsigned int low;
+                    DecodeHex(escape + 8, low);
+                    code = 0x10000 + ((code & 0x3ff) << 10) + (low & 0x3ff);
+                    escape += 6;
+                }
+                AppendUtf8(code, target);
+                escape += 4;
+                break;
+            }
+            default: target += escape[1]; break;
+        }
+        begin = escape + 2;
+    }
+}
+
+//Follows Json::Reader::decodeNumber(), so a number reads the same from the tape and from a parsed document.
+static void DecodeNumber(const char *begin, const char *end, Json::Value &target)
+{
+    const char *current = begin;
+    bool isNegative = *current == '-';
+    if (isNegative)
+        ++current;
+    Json::LargestUInt maxIntegerValue = isNegative ? Json::LargestUInt(Json::Value::maxLargestInt) + 1 : Json::Value::maxLargestUInt;
+    Json::LargestUInt threshold = maxIntegerValue / 10;
+    Json::LargestUInt value = 0;
+    bool integral = true;
+    while (current < end)
+    {
+        char c = *current++;
+        if (c < '0' || c > '9')
+        {
+            integral = false;
+            break;
+        }
+        Json::LargestUInt digit = static_cast<Json::LargestUInt>(c - '0');
+        if (value >= threshold && (value > threshold || current != end || digit > maxIntegerValue % 10))
+        {
+            integral = false;
+            break;
+        }
+        value = value * 10 + digit;
+    }
+
+    if (!integral)
+    {
+        double real = 0;
+        istringstream stream(string(begin, end));
+        stream >> real;
+        target = real;
+    }
+    else if (isNegative && value == maxIntegerValue)
+        target = Json::Value::minLargestInt;
+    else if (isNegative)
+        target = -Json::LargestInt(value);
+    else if (value <= Json::LargestUInt(Json::Value::maxInt))
+        target = Json::LargestInt(value);
+    else
+        target = value;
+}
+
+JsonTape::JsonTape() :
+    end(NULL)
+{
+}
+
+bool JsonTape::Parse(const char *begin, const char *end)
+{
+    this->entries.clear();
+    this->end = end;
+    const char *position = begin;
+    this->SkipWhitespace(position);
+    if (this->ParseValue(position, 0))
+    {
+        this->SkipWhitespace(position);
+        if (position == end)
+            return true;
+    }
+    this->entries.clear();
+    return false;
+}
+
+JsonView JsonTape::GetRoot() const
+{
+    if (this->entries.empty())
+        return JsonView();
+    return JsonView(this, 0);
+}
+
+bool JsonTape::ParseValue(const char *&position, int depth)
+{
+    if (position == this->end)
+        return false;
+    switch (*position)
+    {
+        case '"':
+            return this->ParseString(position);
+        case 't':
+            return this->ParseLiteral(position, "true", 4, TAPE_TRUE);
+        case 'f':
+            return this->ParseLiteral(position, "false", 5, TAPE_FALSE);
+        case 'n':
+            return this->ParseLiteral(position, "null", 4, TAPE_NULL);
+        case '[':
+        case '{':
+            break;
+        default:
+            return this->ParseNumber(position);
+    }
+    if (depth >= JSONTAPE_MAX_DEPTH)
+        return false;
+
+    //Entries may move while the elements are added, the container is referred to by its index.
+    bool isObject = *position == '{';
+    char close = isObject ? '}' : ']';
+    size_t container = this->entries.size();
+    Entry entry;
+    entry.begin = position;
+    entry.count = 0;
+    entry.type = isObject ? TAPE_OBJECT : TAPE_ARRAY;
+    entry.escaped = false;
+    this->entries.push_back(entry);
+
+    position++;
+    this->SkipWhitespace(position);
+    if (position != this->end && *position == close)
+    {
+        position++;
+    }
+    else
+    {
+        while (true)
+        {
+            if (isObject)
+            {
+                if (position == this->end || *position != '"' || !this->ParseString(position))
+                    return false;
+                this->SkipWhitespace(position);
+                if (position == this->end || *position != ':')
+                    return false;
+                position++;
+                this->SkipWhitespace(position);
+            }
+            if (!this->ParseValue(position, depth + 1))
+                return false;
+            this->entries[container].count++;
+            this->SkipWhitespace(position);
+            if (position == this->end)
+                return false;
+            if (*position == close)
+            {
+                position++;
+                break;
+            }
+            if (*position != ',')
+                return false;
+            position++;
+            this->SkipWhitespace(position);
+        }
+    }
+    this->entries[container].end = position;
+    this->entries[container].next = static_cast<unsigned int>(this->entries.size());
+    return true;
+}
+
+bool JsonTape::ParseString(const char *&position)
+{
+    Entry entry;
+    entry.begin = ++position;
+    entry.count = 0;
+    entry.type = TAPE_STRING;
+    entry.escaped = false;
+    while (true)
+    {
+        const char *quote = static_cast<const char*>(memchr(position, '"', this->end - position));
+        const char *escape = static_cast<const char*>(memchr(position, '\\', (quote != NULL ? quote : this->end) - position));
+        if (escape == NULL)
+        {
+            if (quote == NULL)
+                return false;
+            position = quote;
+            break;
+        }
+        entry.escaped = true;
+        position = escape + 1;
+        if (position == this->end)
+            return false;
+        switch (*position)
+        {
+            case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                position++;
+                break;
+            case 'u':
+            {
+                unsigned int code;
+                if (this->end - position < 5 || !DecodeHex(position + 1, code))
+                    return false;
+                position += 5;
+                if (code >= 0xd800 && code <= 0xdbff)
+                {
+                    if (this->end - position < 6 || position[0] != '\\' || position[1] != 'u' || !DecodeHex(position + 2, code))
+                        return false;
+                    position += 6;
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    entry.end = position++;
+    entry.next = static_cast<unsigned int>(this->entries.size() + 1);
+    this->entries.push_back(entry);
+    return true;
+}
+
+bool JsonTape::ParseNumber(const char *&position)
+{
+    Entry entry;
+    entry.begin = position;
+    entry.count = 0;
+    entry.type = TAPE_NUMBER;
+    entry.escaped = false;
+
+    if (*position == '-')
+        position++;
+    if (position == this->end || *position < '0' || *position > '9')
+        return false;
+    if (*position == '0')
+        position++;
+    else
+        while (position != this->end && *position >= '0' && *position <= '9')
+            position++;
+    if (position != this->end && *position == '.')
+    {
+        position++;
+        if (position == this->end || *position < '0' || *position > '9')
+            return false;
+        while (position != this->end && *position >= '0' && *position <= '9')
+            position++;
+    }
+    bool exponent = position != this->end && (*position == 'e' || *position == 'E');
+    if (exponent)
+    {
+        position++;
+        if (position != this->end && (*position == '+' || *position == '-'))
+            position++;
+        if (position == this->end || *position < '0' || *position > '9')
+            return false;
+        while (position != this->end && *position >= '0' && *position <= '9')
+            position++;
+    }
+
+    //Json::Reader rejects numbers out of the range of a double, only those with an exponent or very many digits can be.
+    if (exponent || position - entry.begin > 300)
+    {
+        double real = 0;
+        istringstream stream(string(entry.begin, position));
+        if (!(stream >> real))
+            return false;
+    }
+
+    entry.end = position;
+    entry.next = static_cast<unsigned int>(this->entries.size() + 1);
+    this->entries.push_back(entry);
+    return true;
+}
+
+bool JsonTape::ParseLiteral(const char *&position, const char *literal, size_t length, unsigned char type)
+{
+    if (static_cast<size_t>(this->end - position) < length || memcmp(position, literal, length) != 0)
+        return false;
+    Entry entry;
+    entry.begin = position;
+    entry.end = position + length;
+    entry.next = static_cast<unsigned int>(this->entries.size() + 1);
+    entry.count = 0;
+    entry.type = type;
+    entry.escaped = false;
+    this->entries.push_back(entry);
+    position += length;
+    return true;
+}
+
+void JsonTape::SkipWhitespace(const char *&position) const
+{
+    while (position != this->end && (*position == ' ' || *position == '\t' || *position == '\n' || *position == '\r'))
+        position++;
+}
+
+JsonView::JsonView() :
+    tape(NULL),
+    index(0),
+    value(NULL)
+{
+}
+
+JsonView::JsonView(const Json::Value &value) :
+    tape(NULL),
+    index(0),
+    value(&value)
+{
+}
+
+JsonView::JsonView(const JsonTape *tape, unsigned int index) :
+    tape(tape),
+    index(index),
+    value(NULL)
+{
+}
+
+const JsonTape::Entry* JsonView::GetEntry() const
+{
+    return &this->tape->entries[this->index];
+}
+
+bool JsonView::IsMissing() const
+{
+    return this->tape == NULL && this->value == NULL;
+}
+
+bool JsonView::IsNull() const
+{
+    if (this->value != NULL)
+        return this->value->isNull();
+    return this->tape == NULL || this->GetEntry()->type == JsonTape::TAPE_NULL;
+}
+
+bool JsonView::IsBool() const
+{
+    if (this->value != NULL)
+        return this->value->isBool();
+    return this->tape != NULL && (this->GetEntry()->type == JsonTape::TAPE_TRUE || this->GetEntry()->type == JsonTape::TAPE_FALSE);
+}
+
+bool JsonView::IsNumeric() const
+{
+    if (this->value != NULL)
+        return this->value->isNumeric();
+    return this->tape != NULL && this->GetEntry()->type == JsonTape::TAPE_NUMBER;
+}
+
+bool JsonView::IsIntegral() const
+{
+    if (!this->IsNumeric())
+        return false;
+    if (this->value != NULL)
+        return this->value->isIntegral();
+    Json::Value number;
+    this->GetScalar(number);
+    return number.isIntegral();
+}
+
+bool JsonView::IsString() const
+{
+    if (this->value != NULL)
+        return this->value->isString();
+    return this->tape != NULL && this->GetEntry()->type == JsonTape::TAPE_STRING;
+}
+
+bool JsonView::IsArray() const
+{
+    if (this->value != NULL)
+        return this->value->isArray();
+    return this->tape != NULL && this->GetEntry()->type == JsonTape::TAPE_ARRAY;
+}
+
+bool JsonView::IsObject() const
+{
+    if (this->value != NULL)
+        return this->value->isObject();
+    return this->tape != NULL && this->GetEntry()->type == JsonTape::TAPE_OBJECT;
+}
+
+Json::ArrayIndex JsonView::Size() const
+{
+    if (this->value != NULL)
+        return (this->value->isArray() || this->value->isObject()) ? this->value->size() : 0;
+    return this->tape != NULL ? this->GetEntry()->count : 0;
+}
+
+JsonView JsonView::Get(const std::string &name) const
+{
+    return this->Get(name.data(), name.size());
+}
+
+JsonView JsonView::Get(const char *name, size_t length) const
+{
+    if (this->value != NULL)
+    {
+        if (!this->value->isObject())
+            return JsonView();
+        const Json::Value *member = this->value->find(name, name + length);
+        return member != NULL ? JsonView(*member) : JsonView();
+    }
+    if (!this->IsObject())
+        return JsonView();
+
+    const vector<JsonTape::Entry> &entries = this->tape->entries;
+    unsigned int key = this->index + 1;
+    JsonView result;
+    for (unsigned int i = 0; i < entries[this->index].count; i++)
+    {
+        if (this->HasName(key, name, length))
+            result = JsonView(this->tape, key + 1);
+        key = entries[key + 1].next;
+    }
+    return result;
+}
+
+JsonView JsonView::At(Json::ArrayIndex index) const
+{
+    if (index >= this->Size())
+        return JsonView();
+    if (this->value != NULL)
+    {
+        if (this->value->isArray())
+            return JsonView((*this->value)[index]);
+        Json::Value::const_iterator it = this->value->begin();
+        for (Json::ArrayIndex i = 0; i < index; i++)
+            ++it;
+        return JsonView(*it);
+    }
+
+    const vector<JsonTape::Entry> &entries = this->tape->entries;
+    bool isObject = this->IsObject();
+    unsigned int element = this->index + 1;
+    for (Json::ArrayIndex i = 0; i < index; i++)
+        element = isObject ? entries[element + 1].next : entries[element].next;
+    return JsonView(this->tape, isObject ? element + 1 : element);
+}
+
+std::string JsonView::GetName(Json::ArrayIndex index) const
+{
+    if (!this->IsObject() || index >= this->Size())
+        return "";
+    if (this->value != NULL)
+    {
+        Json::Value::const_iterator it = this->value->begin();
+        for (Json::ArrayIndex i = 0; i < index; i++)
+            ++it;
+        return it.name();
+    }
+
+    const vector<JsonTape::Entry> &entries = this->tape->entries;
+    unsigned int key = this->index + 1;
+    for (Json::ArrayIndex i = 0; i < index; i++)
+        key = entries[key + 1].next;
+    return JsonView(this->tape, key).AsString();
+}
+
+bool JsonView::AsBool() const
+{
+    if (this->value != NULL)
+        return this->value->asBool();
+    Json::Value scalar;
+    this->GetScalar(scalar);
+    return scalar.asBool();
+}
+
+Json::Int64 JsonView::AsInt64() const
+{
+    if (this->value != NULL)
+        return this->value->asInt64();
+    Json::Value scalar;
+    this->GetScalar(scalar);
+    return scalar.asInt64();
+}
+
+Json::UInt64 JsonView::AsUInt64() const
+{
+    if (this->value != NULL)
+        return this->value->asUInt64();
+    Json::Value scalar;
+    this->GetScalar(scalar);
+    return scalar.asUInt64();
+}
+
+double JsonView::AsDouble() const
+{
+    if (this->value != NULL)
+        return this->value->asDouble();
+    Json::Value scalar;
+    this->GetScalar(scalar);
+    return scalar.asDouble();
+}
+
+std::string JsonView::AsString() const
+{
+    if (this->value != NULL)
+        return this->value->asString();
+    if (this->IsString())
+    {
+        const JsonTape::Entry *entry = this->GetEntry();
+        if (!entry->escaped)
+            return string(entry->begin, entry->end);
+        string result;
+        DecodeString(entry->begin, entry->end, result);
+        return result;
+    }
+    Json::Value scalar;
+    this->GetScalar(scalar);
+    return scalar.asString();
+}
+
+bool JsonView::GetString(const char *&begin, const char *&end) const
+{
+    if (this->value != NULL)
+        return this->value->isString() && this->value->getString(&begin, &end);
+    if (!this->IsString() || this->GetEntry()->escaped)
+        return false;
+    begin = this->GetEntry()->begin;
+    end = this->GetEntry()->end;
+    return true;
+}
+
+void JsonView::ToValue(Json::Value &value) const
+{
+    if (this->value != NULL)
+    {
+        value = *this->value;
+        return;
+    }
+    if (this->IsArray())
+    {
+        Json::ArrayIndex size = this->Size();
+        value = Json::Value(Json::arrayValue);
+        if (size > 0)
+            value.resize(size);
+        unsigned int element = this->index + 1;
+        for (Json::ArrayIndex i = 0; i < size; i++)
+        {
+            JsonView(this->tape, element).ToValue(value[i]);
+            element = this->tape->entries[element].next;
+        }
+    }
+    else if (this->IsObject())
+    {
+        value = Json::Value(Json::objectValue);
+        unsigned int key = this->index + 1;
+        for (Json::ArrayIndex i = 0; i < this->Size(); i++)
+        {
+            JsonView(this->tape, key + 1).ToValue(value[JsonView(this->tape, key).AsString()]);
+            key = this->tape->entries[key + 1].next;
+        }
+    }
+    else
+    {
+        this->GetScalar(value);
+    }
+}
+
+void JsonView::GetScalar(Json::Value &scalar) const
+{
+    if (this->tape == NULL)
+    {
+        scalar = Json::Value();
+        return;
+    }
+    const JsonTape::Entry *entry = this->GetEntry();
+    switch (entry->type)
+    {
+        case JsonTape::TAPE_FALSE:
+            scalar = false;
+            break;
+        case JsonTape::TAPE_TRUE:
+            scalar = true;
+            break;
+        case JsonTape::TAPE_NUMBER:
+            DecodeNumber(entry->begin, entry->end, scalar);
+            break;
+        case JsonTape::TAPE_STRING:
+            scalar = this->AsString();
+            break;
+        case JsonTape::TAPE_ARRAY:
+            scalar = Json::Value(Json::arrayValue);
+            break;
+        case JsonTape::TAPE_OBJECT:
+            scalar = Json::Value(Json::objectValue);
+            break;
+        default:
+            scalar = Json::Value();
+            break;
+    }
+}
+
+bool JsonView::HasName(unsigned int key, const char *name, size_t length) const
+{
+    const JsonTape::Entry &entry = this->tape->entries[key];
+    if (!entry.escaped)
+        return static_cast<size_t>(entry.end - entry.begin) == length && memcmp(entry.begin, name, length) == 0;
+    string decoded;
+    DecodeString(entry.begin, entry.end, decoded);
+    return decoded.size() == length && memcmp(decoded.data(), name, length) == 0;
+}
@@ -0,0 +1,172 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    jsontape.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_JSONTAPE_H_
+#define JSONRPC_CPP_JSONTAPE_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "jsonparser.h"
+
+namespace jsonrpc
+{
+    class JsonView;
+
+    /**
+     * An index over JSON text: one entry per value and member name with its position in the text and, for arrays and
+     * objects, where the entries of their elements end. Nothing is decoded and nothing is copied, so indexing a large
+     * document costs a single pass and a vector, and a JsonView finds a member by skipping the ones before it.
+     */
+    class JsonTape
+    {
+        public:
+            JsonTape();
+
+            /**
+             * @brief Indexes [begin, end), which must stay unchanged as long as views of the tape are in use.
+             * Replaces the previous index, the views of which become invalid.
+             * @return false if the range is not exactly one JSON value (RFC 8259, whitespace around it allowed) or
+             * nests deeper than 1000 levels.
+             */
+            bool Parse(const char* begin, const char* end);
+
+            /**
+             * @return the value of the text, a missing view if the last Parse() failed.
+             */
+            JsonView GetRoot() const;
+
+        private:
+            friend class JsonView;
+
+            enum
+            {
+                TAPE_NULL,
+                TAPE_FALSE,
+                TAPE_TRUE,
+                TAPE_NUMBER,
+                TAPE_STRING,
+                TAPE_ARRAY,
+                TAPE_OBJECT
+            };
+
+            struct Entry
+            {
+                const char      *begin;     /*!< The text of the value, strings without their quotes*/
+                const char      *end;
+                unsigned int    next;       /*!< The entry following the value and its elements*/
+                unsigned int    count;      /*!< The elements of an array, the members of an object*/
+                unsigned char   type;
+                bool            escaped;    /*!< A string with escape sequences*/
+            };
+
+            std::vector<Entry>  entries;
+            const char          *end;
+
+            bool ParseValue(const char*& position, int depth);
+            bool ParseString(const char*& position);
+            bool ParseNumber(const char*& position);
+            bool ParseLiteral(const char*& position, const char* literal, size_t length, unsigned char type);
+            void SkipWhitespace(const char*& position) const;
+
+            JsonTape(const JsonTape&);
+            JsonTape& operator=(const JsonTape&);
+    };
+
+    /**
+     * A read-only view of a JSON value, either an entry of a JsonTape or a parsed Json::Value. It mirrors the read
+     * interface of Json::Value: the conversions follow the same rules and throw the same exceptions, a missing member
+     * reads like null. Members and elements are decoded when they are read, ToValue() decodes a whole subtree.
+     *
+     * A view is valid as long as its tape, its text or its Json::Value is, and is cheap to copy.
+     */
+    class JsonView
+    {
+        public:
+            /**
+             * @brief A missing value.
+             */
+            JsonView();
+
+            /**
+             * @brief A view of a parsed value, which must outlive the view.
+             */
+            JsonView(const Json::Value& value);
+
+            /**
+             * @return true for a member or element that does not exist.
+             */
+            bool IsMissing() const;
+
+            bool IsNull() const;
+            bool IsBool() const;
+            bool IsNumeric() const;
+            /**
+             * @return true for numbers Json::Value::isIntegral() accepts.
+             */
+            bool IsIntegral() const;
+            bool IsString() const;
+            bool IsArray() const;
+            bool IsObject() const;
+
+            /**
+             * @return the number of elements of an array or members of an object, 0 for other values.
+             */
+            Json::ArrayIndex Size() const;
+
+            /**
+             * @return the member of an object with the given name, the last one if there are several. A missing view
+             * if there is no such member or the value is no object.
+             */
+            JsonView Get(const std::string& name) const;
+            JsonView Get(const char* name, size_t length) const;
+
+            /**
+             * @return the index-th element of an array or the value of the index-th member of an object, in the order of
+             * the text. A missing view if there is none.
+             */
+            JsonView At(Json::ArrayIndex index) const;
+
+            /**
+             * @return the name of the index-th member of an object, empty if there is none.
+             */
+            std::string GetName(Json::ArrayIndex index) const;
+
+            bool AsBool() const;
+            Json::Int64 AsInt64() const;
+            Json::UInt64 AsUInt64() const;
+            double AsDouble() const;
+            std::string AsString() const;
+
+            /**
+             * @brief Gives access to a string without copying it.
+             * @return false if the value is no string or a string of the text that has to be unescaped, use AsString() then.
+             */
+            bool GetString(const char*& begin, const char*& end) const;
+
+            /**
+             * @brief Decodes the value with all its elements.
+             */
+            void ToValue(Json::Value& value) const;
+
+        private:
+            friend class JsonTape;
+
+            const JsonTape      *tape;
+            unsigned int        index;
+            const Json::Value   *value;     /*!< Set for a view of a parsed value, NULL for a view of a tape*/
+
+            JsonView(const JsonTape* tape, unsigned int index);
+
+            const JsonTape::Entry* GetEntry() const;
+            void GetScalar(Json::Value& scalar) const;
+            bool HasName(unsigned int key, const char* name, size_t length) const;
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_JSONTAPE_H_ */
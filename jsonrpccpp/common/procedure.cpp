@@ -20,7 +20,11 @@ Procedure::Procedure() :
     procedureName(""),
     procedureType(RPC_METHOD),
     returntype(JSON_BOOLEAN),
-    paramDeclaration(PARAMS_BY_NAME)
+    paramDeclaration(PARAMS_BY_NAME),
+    serialized(false),
+    cacheTtl(0),
+    priority(PRIORITY_NORMAL),
+    lazyParameters(false)
 {
 }
 
@@ -40,6 +44,10 @@ Procedure::Procedure(const string &name, parameterDeclaration_t paramType, jsont
     this->returntype = returntype;
     this->procedureType = RPC_METHOD;
     this->paramDeclaration = paramType;
+    this->serialized = false;
+    this->cacheTtl = 0;
+    this->priority = PRIORITY_NORMAL;
+    this->lazyParameters = false;
 }
 Procedure::Procedure(const string &name, parameterDeclaration_t paramType, ...)
 {
@@ -57,6 +65,10 @@ Procedure::Procedure(const string &name, parameterDeclaration_t paramType, ...)
     this->procedureType = RPC_NOTIFICATION;
     this->paramDeclaration = paramType;
     this->returntype = JSON_BOOLEAN;
+    this->serialized = false;
+    this->cacheTtl = 0;
+    this->priority = PRIORITY_NORMAL;
+    this->lazyParameters = false;
 }
 
 bool                        Procedure::ValdiateParameters           (const Json::Value& parameters) const
@@ -82,6 +94,10 @@ const parameterNameList_t&  Procedure::GetParameters                () const
 {
     return this->parametersName;
 }
+const parameterPositionList_t& Procedure::GetPositionalParameters  () const
+{
+    return this->parametersPosition;
+}
 procedure_t                 Procedure::GetProcedureType             () const
 {
     return this->procedureType;
@@ -98,6 +114,22 @@ jsontype_t                  Procedure::GetReturnType                () const
 {
     return this->returntype;
 }
+bool                        Procedure::IsSerialized                 () const
+{
+    return this->serialized;
+}
+unsigned int                Procedure::GetCacheTtl                  () const
+{
+    return this->cacheTtl;
+}
+priority_t                  Procedure::GetPriority                  () const
+{
+    return this->priority;
+}
+bool                        Procedure::HasLazyParameters            () const
+{
+    return this->lazyParameters;
+}
 
 void    Procedure::SetProcedureName             (const string &name)
 {
@@ -115,6 +147,22 @@ void    Procedure::SetParameterDeclarationType  (parameterDeclaration_t type)
 {
     this->paramDeclaration = type;
 }
+void    Procedure::SetSerialized                (bool serialized)
+{
+    this->serialized = serialized;
+}
+void    Procedure::SetCacheTtl                  (unsigned int ttlMs)
+{
+    this->cacheTtl = ttlMs;
+}
+void    Procedure::SetPriority                  (priority_t priority)
+{
+    this->priority = priority;
+}
+void    Procedure::SetLazyParameters            (bool lazy)
+{
+    this->lazyParameters = lazy;
+}
 
 void    Procedure::AddParameter                 (const string& name, jsontype_t type)
 {
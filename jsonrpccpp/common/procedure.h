@@ -58,10 +58,15 @@ namespace jsonrpc
 
             //Various get methods.
             const parameterNameList_t&      GetParameters               () const;
+            const parameterPositionList_t&  GetPositionalParameters     () const;
             procedure_t                     GetProcedureType            () const;
             const std::string&              GetProcedureName            () const;
             jsontype_t                      GetReturnType               () const;
             parameterDeclaration_t          GetParameterDeclarationType () const;
+            bool                            IsSerialized                () const;
+            unsigned int                    GetCacheTtl                 () const;
+            priority_t                      GetPriority                 () const;
+            bool                            HasLazyParameters           () const;
 
             //Various set methods.
             void                            SetProcedureName            (const std::string &name);
@@ -69,6 +74,32 @@ namespace jsonrpc
             void                            SetReturnType               (jsontype_t type);
             void                            SetParameterDeclarationType (parameterDeclaration_t type);
 
+            /**
+             * @brief Marks a procedure with side effects. Inside a batch that is executed in parallel, it waits for all
+             * preceding calls and runs before any following call starts.
+             */
+            void                            SetSerialized               (bool serialized);
+
+            /**
+             * @brief Marks a method as idempotent. A server with a ResponseCache answers repeated calls with the same
+             * parameters from the cache for ttlMs milliseconds, 0 always executes the method.
+             */
+            void                            SetCacheTtl                 (unsigned int ttlMs);
+
+            /**
+             * @brief Assigns the procedure to a dispatch lane, PRIORITY_NORMAL by default. A server with an executor hands
+             * queued requests of a higher class to a worker first and bounds the workers each class may take, see
+             * ThreadPool::SetLaneLimit. A batch is queued in the lane of its most urgent call.
+             */
+            void                            SetPriority                 (priority_t priority);
+
+            /**
+             * @brief Hands the parameters to the procedure as a JsonView over the request text instead of a Json::Value,
+             * members are decoded when the procedure reads them. Meant for large parameters of which little is read.
+             * A cache ttl has no effect on such a procedure.
+             */
+            void                            SetLazyParameters           (bool lazy);
+
 
             /**
              * @brief AddParameter
@@ -113,6 +144,26 @@ namespace jsonrpc
              */
             parameterDeclaration_t      paramDeclaration;
 
+            /**
+             * @brief serialized this procedure must not run concurrently with other calls of the same batch.
+             */
+            bool                        serialized;
+
+            /**
+             * @brief cacheTtl milliseconds a result of this method may be answered from a ResponseCache, 0 if never.
+             */
+            unsigned int                cacheTtl;
+
+            /**
+             * @brief priority the lane requests of this procedure are queued in by a server.
+             */
+            priority_t                  priority;
+
+            /**
+             * @brief lazyParameters the procedure reads its parameters through a JsonView.
+             */
+            bool                        lazyParameters;
+
             bool ValidateSingleParameter        (jsontype_t expectedType, const Json::Value &value) const;
     };
 } /* namespace jsonrpc */
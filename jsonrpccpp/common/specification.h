@@ -15,6 +15,13 @@
 #define KEY_SPEC_PROCEDURE_NOTIFICATION  "notification" //legacy format -> use name now
 #define KEY_SPEC_PROCEDURE_PARAMETERS    "params"
 #define KEY_SPEC_RETURN_TYPE             "returns"
+#define KEY_SPEC_SERIALIZED              "serialized"
+#define KEY_SPEC_CACHE_TTL               "cache_ttl"
+#define KEY_SPEC_PRIORITY                "priority"
+
+#define SPEC_PRIORITY_HIGH               "high"
+#define SPEC_PRIORITY_NORMAL             "normal"
+#define SPEC_PRIORITY_BULK               "bulk"
 
 namespace jsonrpc
 {
@@ -27,6 +34,17 @@ namespace jsonrpc
         RPC_METHOD, RPC_NOTIFICATION
     } procedure_t;
 
+    /**
+     * The dispatch lane of a procedure. A server that queues requests hands those of a higher class to a worker first.
+     */
+    typedef enum
+    {
+        PRIORITY_HIGH,      /*!< Short control calls, e.g. status or abort*/
+        PRIORITY_NORMAL,
+        PRIORITY_BULK,      /*!< Long running calls, e.g. data transfers*/
+        PRIORITY_CLASSES
+    } priority_t;
+
     /**
      * This enum represents all processable json Types of this framework.
      */
@@ -65,6 +65,18 @@ void                SpecificationParser::GetProcedure           (Json::Value &si
         {
             result.SetProcedureType(RPC_NOTIFICATION);
         }
+        if (signature.isMember(KEY_SPEC_SERIALIZED))
+        {
+            result.SetSerialized(signature[KEY_SPEC_SERIALIZED].asBool());
+        }
+        if (signature.isMember(KEY_SPEC_CACHE_TTL) && signature[KEY_SPEC_CACHE_TTL].isUInt())
+        {
+            result.SetCacheTtl(signature[KEY_SPEC_CACHE_TTL].asUInt());
+        }
+        if (signature.isMember(KEY_SPEC_PRIORITY))
+        {
+            result.SetPriority(toPriority(signature[KEY_SPEC_PRIORITY]));
+        }
         if (signature.isMember(KEY_SPEC_PROCEDURE_PARAMETERS))
         {
             if (signature[KEY_SPEC_PROCEDURE_PARAMETERS].isObject() ||  signature[KEY_SPEC_PROCEDURE_PARAMETERS].isArray())
@@ -171,3 +183,15 @@ string SpecificationParser::GetProcedureName(Json::Value &signature)
         return signature[KEY_SPEC_PROCEDURE_NOTIFICATION].asString();
     return "";
 }
+priority_t          SpecificationParser::toPriority             (Json::Value &val)
+{
+    string name = val.isString() ? val.asString() : "";
+    if (name == SPEC_PRIORITY_HIGH)
+        return PRIORITY_HIGH;
+    if (name == SPEC_PRIORITY_NORMAL)
+        return PRIORITY_NORMAL;
+    if (name == SPEC_PRIORITY_BULK)
+        return PRIORITY_BULK;
+    throw JsonRpcException(Errors::ERROR_SERVER_PROCEDURE_SPECIFICATION_SYNTAX, "Unknown priority: "
+                           + val.toStyledString());
+}
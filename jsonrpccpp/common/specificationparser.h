@@ -28,6 +28,7 @@ namespace jsonrpc {
             static void         GetMethod       (Json::Value& val, Procedure &target);
             static void         GetNotification (Json::Value& val, Procedure &target);
             static jsontype_t   toJsonType      (Json::Value& val);
+            static priority_t   toPriority      (Json::Value& val);
 
             static void         GetPositionalParameters (Json::Value &val, Procedure &target);
             static void         GetNamedParameters      (Json::Value &val, Procedure &target);
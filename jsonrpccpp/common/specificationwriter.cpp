@@ -69,6 +69,18 @@ Json::Value SpecificationWriter::toJsonLiteral          (jsontype_t type)
     }
     return literal;
 }
+Json::Value SpecificationWriter::toPriorityLiteral      (priority_t priority)
+{
+    switch(priority)
+    {
+        case PRIORITY_HIGH:
+            return SPEC_PRIORITY_HIGH;
+        case PRIORITY_BULK:
+            return SPEC_PRIORITY_BULK;
+        default:
+            return SPEC_PRIORITY_NORMAL;
+    }
+}
 void        SpecificationWriter::procedureToJsonValue   (const Procedure &procedure, Json::Value &target)
 {
     target[KEY_SPEC_PROCEDURE_NAME] = procedure.GetProcedureName();
@@ -76,6 +88,18 @@ void        SpecificationWriter::procedureToJsonValue   (const Procedure &proced
     {
         target[KEY_SPEC_RETURN_TYPE] = toJsonLiteral(procedure.GetReturnType());
     }
+    if(procedure.IsSerialized())
+    {
+        target[KEY_SPEC_SERIALIZED] = true;
+    }
+    if(procedure.GetCacheTtl() != 0)
+    {
+        target[KEY_SPEC_CACHE_TTL] = procedure.GetCacheTtl();
+    }
+    if(procedure.GetPriority() != PRIORITY_NORMAL)
+    {
+        target[KEY_SPEC_PRIORITY] = toPriorityLiteral(procedure.GetPriority());
+    }
     for(parameterNameList_t::const_iterator it = procedure.GetParameters().begin(); it != procedure.GetParameters().end(); ++it)
     {
         if(procedure.GetParameterDeclarationType() == PARAMS_BY_NAME)
@@ -23,6 +23,7 @@ namespace jsonrpc {
 
         private:
             static Json::Value  toJsonLiteral           (jsontype_t type);
+            static Json::Value  toPriorityLiteral       (priority_t priority);
             static void         procedureToJsonValue    (const Procedure& procedure, Json::Value& target);
     };
 }
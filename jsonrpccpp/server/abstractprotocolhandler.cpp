@@ -8,16 +8,147 @@
  ************************************************************************/
 
 #include "abstractprotocolhandler.h"
+#include "abstractserverconnector.h"
+#include "callcontext.h"
 #include <jsonrpccpp/common/errors.h>
+#include <jsonrpccpp/common/exception.h>
 #include <jsonrpccpp/common/jsonparser.h>
-
-#include <map>
+#include <pthread.h>
+#include <string.h>
+#include <ctype.h>
+#include <sstream>
 
 using namespace jsonrpc;
 using namespace std;
 
+/**
+ * The reader and writer of one thread, they keep state while in use and cannot be shared.
+ */
+struct ThreadCodec
+{
+    Json::CharReader *reader;
+    Json::StreamWriter *writer;
+    JsonTape tape;
+    bool tapeInUse;     /*!< A procedure reads from tape, a request it handles itself needs a tape of its own*/
+    const Json::Value *missedRequest;   /*!< The request FindCachedResponse has looked up in vain, until it is processed*/
+    ResponseCache::Miss miss;
+};
+
+/**
+ * Marks the tape of a thread as in use while a lazy request is handled.
+ */
+class TapeLock
+{
+    public:
+        TapeLock(ThreadCodec *codec) : codec(codec) { if (codec != NULL) codec->tapeInUse = true; }
+        ~TapeLock() { if (codec != NULL) codec->tapeInUse = false; }
+
+    private:
+        ThreadCodec *codec;
+};
+
+static pthread_once_t codec_once = PTHREAD_ONCE_INIT;
+static pthread_key_t codec_key;
+
+static void DeleteCodec(void *p)
+{
+    ThreadCodec *codec = static_cast<ThreadCodec*>(p);
+    delete codec->reader;
+    delete codec->writer;
+    delete codec;
+}
+
+static void CreateCodecKey()
+{
+    pthread_key_create(&codec_key, DeleteCodec);
+}
+
+static ThreadCodec* GetThreadCodec()
+{
+    pthread_once(&codec_once, CreateCodecKey);
+    ThreadCodec *codec = static_cast<ThreadCodec*>(pthread_getspecific(codec_key));
+    if (codec == NULL)
+    {
+        codec = new ThreadCodec();
+        codec->tapeInUse = false;
+        codec->missedRequest = NULL;
+        Json::CharReaderBuilder reader;
+        reader["collectComments"] = false;
+        codec->reader = reader.newCharReader();
+        //No indentation gives the output of FastWriter, a comment style of All streams arrays element by element.
+        Json::StreamWriterBuilder writer;
+        writer["indentation"] = "";
+        writer["commentStyle"] = "All";
+        codec->writer = writer.newStreamWriter();
+        pthread_setspecific(codec_key, codec);
+    }
+    return codec;
+}
+
+/**
+ * Reads the value of a "method" member in a text request, position is right after the closing quote of the name.
+ */
+static bool GetTextName(const char *position, const char *end, const char *&name, size_t &length)
+{
+    while (position < end && isspace(static_cast<unsigned char>(*position)))
+        position++;
+    if (position == end || *position++ != ':')
+        return false;
+    while (position < end && isspace(static_cast<unsigned char>(*position)))
+        position++;
+    if (position == end || *position++ != '"')
+        return false;
+    name = position;
+    while (position < end && *position != '"' && *position != '\\')
+        position++;
+    length = position - name;
+    return position < end && *position == '"';
+}
+
+/**
+ * Reads the text string following the key method in a CBOR request, position is right after the key.
+ */
+static bool GetCborName(const char *position, const char *end, const char *&name, size_t &length)
+{
+    if (position == end)
+        return false;
+    unsigned char head = static_cast<unsigned char>(*position++);
+    if (head >= 0x60 && head <= 0x77)
+    {
+        length = head - 0x60;
+    }
+    else if (head == 0x78 && position < end)
+    {
+        length = static_cast<unsigned char>(*position++);
+    }
+    else
+    {
+        return false;
+    }
+    name = position;
+    return length <= static_cast<size_t>(end - position);
+}
+
+/**
+ * The milliseconds the caller of a request waits for the response, -1 if it has not said or the value is no number of them.
+ */
+static long long GetDeadline(const Json::Value &request)
+{
+    if (!request.isObject())
+        return -1;
+    const Json::Value &deadline = request.get(KEY_REQUEST_DEADLINE, Json::nullValue);
+    if (!deadline.isNumeric() || deadline.asDouble() < 0)
+        return -1;
+    //A year is as good as forever and keeps the deadline far from overflowing.
+    return deadline.asDouble() < 31536000000.0 ? static_cast<long long>(deadline.asDouble()) : 31536000000LL;
+}
+
 AbstractProtocolHandler::AbstractProtocolHandler(IProcedureInvokationHandler &handler) :
-    handler(handler)
+    handler(handler),
+    metrics(NULL),
+    cache(NULL),
+    prioritized(false),
+    lazy(false)
 {
 }
 
@@ -25,12 +156,322 @@ AbstractProtocolHandler::~AbstractProtocolHandler()
 {
 }
 
-void AbstractProtocolHandler::AddProcedure(const Procedure &procedure)
+void AbstractProtocolHandler::AddProcedure(const Procedure &procedure, int binding)
+{
+    this->procedures.Add(procedure, binding);
+    if (procedure.GetPriority() != PRIORITY_NORMAL)
+        this->prioritized = true;
+    if (procedure.HasLazyParameters())
+        this->lazy = true;
+    if (this->metrics != NULL)
+        this->procedures.Find(procedure.GetProcedureName())->metrics = this->metrics->RegisterMethod(procedure.GetProcedureName());
+}
+
+void AbstractProtocolHandler::SetMetrics(RpcMetrics *metrics)
+{
+    this->metrics = metrics;
+    //A procedure of the server with the same name takes precedence.
+    if (metrics != NULL && this->procedures.Find(METRICS_METHOD_NAME) == NULL)
+    {
+        //Monitoring should not wait behind the load it is meant to observe.
+        Procedure procedure(METRICS_METHOD_NAME, PARAMS_BY_NAME, JSON_OBJECT, NULL);
+        procedure.SetPriority(PRIORITY_HIGH);
+        this->procedures.Add(procedure, BINDING_METRICS);
+        this->prioritized = true;
+    }
+    for (size_t i = 0; i < this->procedures.Size(); i++)
+    {
+        DispatchEntry &entry = this->procedures.At(i);
+        entry.metrics = (metrics != NULL) ? metrics->RegisterMethod(entry.procedure.GetProcedureName()) : -1;
+    }
+}
+
+void AbstractProtocolHandler::SetResponseCache(ResponseCache *cache)
 {
-    this->procedures[procedure.GetProcedureName()] = procedure;
+    this->cache = cache;
+}
+
+void AbstractProtocolHandler::EnableSubscriptions()
+{
+    //Serialized, a batch executes them on the thread handling it, for which the connector knows the connection.
+    const char *names[] = {SUBSCRIBE_METHOD_NAME, UNSUBSCRIBE_METHOD_NAME};
+    const int bindings[] = {BINDING_SUBSCRIBE, BINDING_UNSUBSCRIBE};
+    for (int i = 0; i < 2; i++)
+    {
+        if (this->procedures.Find(names[i]) != NULL)
+            continue;
+        Procedure procedure(names[i], PARAMS_BY_NAME, JSON_BOOLEAN, NULL);
+        procedure.SetSerialized(true);
+        this->AddProcedure(procedure, bindings[i]);
+    }
+}
+
+priority_t AbstractProtocolHandler::GetRequestPriority(const char *begin, const char *end)
+{
+    if (!this->prioritized)
+        return PRIORITY_NORMAL;
+    //JSON text starts with ASCII, a CBOR request with the head of a map or an array.
+    bool binary = begin < end && static_cast<unsigned char>(*begin) >= 0x80;
+    int priority = PRIORITY_NORMAL;
+    bool found = false;
+    const char *position = begin;
+    while (priority != PRIORITY_HIGH && (position = static_cast<const char*>(memchr(position, 'm', end - position))) != NULL)
+    {
+        const char *key = position++;
+        if (end - key < 7 || memcmp(key, "method", 6) != 0 || key == begin)
+            continue;
+        //A key whose name cannot be read counts like an unknown procedure.
+        const char *name = key + 6;
+        size_t length = 0;
+        bool readable;
+        if (binary)
+        {
+            if (key[-1] != '\x66')
+                continue;
+            readable = GetCborName(key + 6, end, name, length);
+        }
+        else
+        {
+            if (key[-1] != '"' || key[6] != '"')
+                continue;
+            readable = GetTextName(key + 7, end, name, length);
+        }
+        DispatchEntry *entry = readable ? this->procedures.Find(name, length) : NULL;
+        int called = (entry != NULL) ? entry->procedure.GetPriority() : PRIORITY_NORMAL;
+        if (!found || called < priority)
+            priority = called;
+        found = true;
+        if (readable)
+            position = name + length;
+    }
+    return static_cast<priority_t>(priority);
 }
 
 void AbstractProtocolHandler::HandleRequest(const std::string &request, std::string &retValue)
+{
+    this->HandleRequest(request.data(), request.data() + request.size(), retValue);
+}
+
+void AbstractProtocolHandler::HandleRequest(const char *begin, const char *end, std::string &retValue)
+{
+    Json::Value req;
+    Json::Value resp;
+    Json::FastWriter w;
+
+    if (!this->lazy || !this->HandleLazyRequest(begin, end, resp))
+    {
+        unsigned long long started = RpcMetrics::Start(this->metrics);
+        bool parsed = ParseRequest(begin, end, req);
+        RpcMetrics::Stop(this->metrics, METRICS_PARSE, started);
+        if (parsed && this->FindCachedResponse(req, retValue))
+        {
+            //Terminated like the output of FastWriter.
+            retValue += '\n';
+            return;
+        }
+        if (parsed)
+        {
+            this->HandleJsonRequest(req, resp);
+            ForgetCacheMiss();
+        }
+        else
+        {
+            this->WrapError(Json::nullValue, Errors::ERROR_RPC_JSON_PARSE_ERROR, Errors::GetErrorMessage(Errors::ERROR_RPC_JSON_PARSE_ERROR), resp);
+        }
+    }
+
+    if (resp != Json::nullValue)
+    {
+        unsigned long long started = RpcMetrics::Start(this->metrics);
+        retValue = w.write(resp);
+        RpcMetrics::Stop(this->metrics, METRICS_SERIALIZE, started);
+    }
+}
+
+void AbstractProtocolHandler::HandleRequest(const char *begin, const char *end, std::ostream &response)
+{
+    Json::Value req;
+    Json::Value resp;
+
+    if (!this->lazy || !this->HandleLazyRequest(begin, end, resp))
+    {
+        unsigned long long started = RpcMetrics::Start(this->metrics);
+        bool parsed = ParseRequest(begin, end, req);
+        RpcMetrics::Stop(this->metrics, METRICS_PARSE, started);
+        std::string cached;
+        if (parsed && this->FindCachedResponse(req, cached))
+        {
+            response << cached;
+            return;
+        }
+        if (parsed)
+        {
+            this->HandleJsonRequest(req, resp);
+            ForgetCacheMiss();
+        }
+        else
+        {
+            this->WrapError(Json::nullValue, Errors::ERROR_RPC_JSON_PARSE_ERROR, Errors::GetErrorMessage(Errors::ERROR_RPC_JSON_PARSE_ERROR), resp);
+        }
+    }
+
+    if (resp != Json::nullValue)
+    {
+        unsigned long long started = RpcMetrics::Start(this->metrics);
+        WriteResponse(resp, response);
+        RpcMetrics::Stop(this->metrics, METRICS_SERIALIZE, started);
+    }
+}
+
+bool AbstractProtocolHandler::FindCachedResponse(const Json::Value &request, std::string &response)
+{
+    if (this->cache == NULL || !request.isObject() || !this->ValidateRequestFields(request) || this->GetRequestType(request) != RPC_METHOD)
+        return false;
+    const char *begin = NULL;
+    const char *end = NULL;
+    request[KEY_REQUEST_METHODNAME].getString(&begin, &end);
+    DispatchEntry *entry = this->procedures.Find(begin, end - begin);
+    if (entry == NULL || entry->procedure.GetProcedureType() != RPC_METHOD || entry->procedure.GetCacheTtl() == 0 || entry->procedure.HasLazyParameters())
+        return false;
+
+    //Equal parameters passed the validator when the result was stored, so a hit needs no validation.
+    std::string result;
+    ThreadCodec *codec = GetThreadCodec();
+    unsigned long long started = RpcMetrics::Start(this->metrics);
+    if (!this->cache->Find(entry->procedure.GetProcedureName(), request[KEY_REQUEST_PARAMETERS], NULL, &result, &codec->miss))
+    {
+        //ProcessRequest() executes the call without looking it up again.
+        codec->missedRequest = &request;
+        return false;
+    }
+    RpcMetrics::StopCall(this->metrics, entry->metrics, started, false);
+
+    //Members are serialized sorted by name, so the result comes last and its text takes the place of a null result.
+    Json::Value wrapped;
+    Json::Value placeholder;
+    this->WrapResult(request, wrapped, placeholder);
+    std::ostringstream text;
+    WriteResponse(wrapped, text);
+    response = text.str();
+    static const std::string TAIL = "\"" KEY_RESPONSE_RESULT "\":null}";
+    if (response.size() >= TAIL.size() && response.compare(response.size() - TAIL.size(), TAIL.size(), TAIL) == 0)
+    {
+        response.replace(response.size() - 5, 4, result);
+    }
+    else
+    {
+        ParseRequest(result.data(), result.data() + result.size(), placeholder);
+        wrapped = Json::Value();
+        this->WrapResult(request, wrapped, placeholder);
+        text.str("");
+        WriteResponse(wrapped, text);
+        response = text.str();
+    }
+    return true;
+}
+
+void AbstractProtocolHandler::ForgetCacheMiss()
+{
+    GetThreadCodec()->missedRequest = NULL;
+}
+
+bool AbstractProtocolHandler::MayCallLazyProcedure(const char *begin, const char *end)
+{
+    //Batches and CBOR requests are parsed as usual.
+    while (begin < end && isspace(static_cast<unsigned char>(*begin)))
+        begin++;
+    if (begin == end || *begin != '{')
+        return false;
+    const char *position = begin;
+    while ((position = static_cast<const char*>(memchr(position, 'm', end - position))) != NULL)
+    {
+        const char *key = position++;
+        if (end - key < 7 || memcmp(key, "method", 6) != 0 || key[-1] != '"' || key[6] != '"')
+            continue;
+        const char *name = NULL;
+        size_t length = 0;
+        if (!GetTextName(key + 7, end, name, length))
+            continue;
+        DispatchEntry *entry = this->procedures.Find(name, length);
+        if (entry != NULL && entry->procedure.HasLazyParameters())
+            return true;
+        position = name + length;
+    }
+    return false;
+}
+
+bool AbstractProtocolHandler::HandleLazyRequest(const char *begin, const char *end, Json::Value &response)
+{
+    if (!this->MayCallLazyProcedure(begin, end))
+        return false;
+
+    //A procedure may handle a request on its thread while it reads its own parameters from the tape of the thread.
+    ThreadCodec *codec = GetThreadCodec();
+    JsonTape nested;
+    JsonTape &tape = codec->tapeInUse ? nested : codec->tape;
+    TapeLock lock(codec->tapeInUse ? NULL : codec);
+
+    unsigned long long started = RpcMetrics::Start(this->metrics);
+    if (!tape.Parse(begin, end))
+        return false;
+    JsonView root = tape.GetRoot();
+    const char *name = NULL;
+    const char *nameEnd = NULL;
+    if (!root.Get(KEY_REQUEST_METHODNAME).GetString(name, nameEnd))
+        return false;
+    DispatchEntry *entry = this->procedures.Find(name, nameEnd - name);
+    if (entry == NULL || !entry->procedure.HasLazyParameters())
+        return false;
+
+    //The protocol checks the envelope as usual, params only tells them whether it is an object or an array.
+    Json::Value request(Json::objectValue);
+    JsonView parameters;
+    for (Json::ArrayIndex i = 0; i < root.Size(); i++)
+    {
+        std::string member = root.GetName(i);
+        if (member == KEY_REQUEST_PARAMETERS)
+            parameters = root.At(i);
+        else
+            root.At(i).ToValue(request[member]);
+    }
+    if (parameters.IsObject())
+        request[KEY_REQUEST_PARAMETERS] = Json::Value(Json::objectValue);
+    else if (parameters.IsArray())
+        request[KEY_REQUEST_PARAMETERS] = Json::Value(Json::arrayValue);
+    else if (!parameters.IsMissing())
+        parameters.ToValue(request[KEY_REQUEST_PARAMETERS]);
+    RpcMetrics::Stop(this->metrics, METRICS_PARSE, started);
+
+    int error = this->ValidateRequest(request, entry, &parameters);
+    if (error == 0)
+    {
+        try
+        {
+            this->ProcessRequest(request, *entry, response, &parameters);
+        }
+        catch (const JsonRpcException &exception)
+        {
+            this->WrapException(request, exception, response);
+        }
+    }
+    else
+    {
+        this->WrapError(request, error, Errors::GetErrorMessage(error), response);
+    }
+    return true;
+}
+
+bool AbstractProtocolHandler::ParseRequest(const char *begin, const char *end, Json::Value &request)
+{
+    return GetThreadCodec()->reader->parse(begin, end, &request, NULL);
+}
+
+void AbstractProtocolHandler::WriteResponse(const Json::Value &response, std::ostream &out)
+{
+    GetThreadCodec()->writer->write(response, &out);
+}
+
+void AbstractProtocolHandler::HandleRejectedRequest(const std::string &request, int code, std::string &retValue)
 {
     Json::Reader reader;
     Json::Value req;
@@ -39,7 +480,7 @@ void AbstractProtocolHandler::HandleRequest(const std::string &request, std::str
 
     if (reader.parse(request, req, false))
     {
-        this->HandleJsonRequest(req, resp);
+        this->RejectJsonRequest(req, code, resp);
     }
     else
     {
@@ -50,54 +491,164 @@ void AbstractProtocolHandler::HandleRequest(const std::string &request, std::str
         retValue = w.write(resp);
 }
 
-void AbstractProtocolHandler::ProcessRequest(const Json::Value &request, Json::Value &response)
+void AbstractProtocolHandler::RejectJsonRequest(const Json::Value &request, int code, Json::Value &response)
+{
+    if (request.isArray())
+    {
+        for (unsigned int i = 0; i < request.size(); i++)
+        {
+            Json::Value result;
+            this->RejectJsonRequest(request[i], code, result);
+            if (result != Json::nullValue)
+                response.append(result);
+        }
+    }
+    else if (!request.isObject() || this->GetRequestType(request) == RPC_METHOD)
+    {
+        this->WrapError(request, code, Errors::GetErrorMessage(code), response);
+    }
+}
+
+void AbstractProtocolHandler::ProcessRequest(const Json::Value &request, DispatchEntry &entry, Json::Value &response, const JsonView *parameters)
 {
-    Procedure& method = this->procedures[request[KEY_REQUEST_METHODNAME].asString()];
+    Procedure& method = entry.procedure;
     Json::Value result;
 
-    if (method.GetProcedureType() == RPC_METHOD)
+    //Taken before anything runs, a request the procedure handles itself is no longer the one that missed.
+    ThreadCodec *codec = GetThreadCodec();
+    bool missed = codec->missedRequest == &request;
+    ResponseCache::Miss miss = codec->miss;
+    codec->missedRequest = NULL;
+
+    CallContext call(CallContext::GetCurrent(), GetDeadline(request));
+    if (call.IsExpired())
     {
-        handler.HandleMethodCall(method, request[KEY_REQUEST_PARAMETERS], result);
-        this->WrapResult(request, response, result);
+        //The caller has stopped waiting, e.g. while the request was queued, so the procedure is not invoked at all.
+        if (this->metrics != NULL)
+            this->metrics->RecordError(entry.metrics);
+        if (method.GetProcedureType() != RPC_METHOD)
+        {
+            response = Json::nullValue;
+            return;
+        }
+        throw JsonRpcException(Errors::ERROR_SERVER_DEADLINE_EXCEEDED);
     }
-    else
+
+    CallContext *previous = CallContext::Enter(&call);
+    unsigned long long started = RpcMetrics::Start(this->metrics);
+    try
     {
-        handler.HandleNotificationCall(method, request[KEY_REQUEST_PARAMETERS]);
-        response = Json::nullValue;
+        if (entry.binding == BINDING_METRICS)
+        {
+            MetricsSnapshot snapshot;
+            if (this->metrics != NULL)
+                this->metrics->GetSnapshot(snapshot);
+            snapshot.ToJson(result);
+        }
+        else if (entry.binding == BINDING_SUBSCRIBE || entry.binding == BINDING_UNSUBSCRIBE)
+        {
+            const Json::Value &parameters = request[KEY_REQUEST_PARAMETERS];
+            Json::Value event;
+            if (parameters.isArray() && parameters.size() == 1)
+                event = parameters[0u];
+            else if (parameters.isObject() && parameters.size() == 1)
+                event = parameters.get("event", Json::nullValue);
+            if (!event.isString())
+                throw JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS);
+            if (!AbstractServerConnector::Subscribe(event.asString(), entry.binding == BINDING_SUBSCRIBE))
+                throw JsonRpcException(Errors::ERROR_SERVER_SUBSCRIPTION);
+            result = true;
+        }
+        else if (method.HasLazyParameters())
+        {
+            //Batches and the other decoders have parsed the whole request, the view then reads the parsed params.
+            JsonView view = (parameters != NULL) ? *parameters : JsonView(request[KEY_REQUEST_PARAMETERS]);
+            if (method.GetProcedureType() == RPC_METHOD)
+                handler.InvokeLazyMethod(method, entry.binding, view, result);
+            else
+                handler.InvokeLazyNotification(method, entry.binding, view);
+        }
+        else if (method.GetProcedureType() == RPC_METHOD)
+        {
+            //Batches and decoded requests take the cached value, FindCachedResponse() serves single requests from the text
+            //and has already missed for those that get here.
+            unsigned int ttl = (this->cache != NULL) ? method.GetCacheTtl() : 0;
+            if (ttl == 0 || missed || !this->cache->Find(method.GetProcedureName(), request[KEY_REQUEST_PARAMETERS], &result, NULL, &miss))
+            {
+                handler.InvokeMethod(method, entry.binding, request[KEY_REQUEST_PARAMETERS], result);
+                if (ttl != 0)
+                    this->cache->Store(method.GetProcedureName(), request[KEY_REQUEST_PARAMETERS], result, ttl, miss);
+            }
+        }
+        else
+        {
+            handler.InvokeNotification(method, entry.binding, request[KEY_REQUEST_PARAMETERS]);
+        }
     }
+    catch (...)
+    {
+        CallContext::Enter(previous);
+        RpcMetrics::StopCall(this->metrics, entry.metrics, started, true);
+        throw;
+    }
+    CallContext::Enter(previous);
+    RpcMetrics::StopCall(this->metrics, entry.metrics, started, false);
+
+    if (method.GetProcedureType() == RPC_METHOD)
+        this->WrapResult(request, response, result);
+    else
+        response = Json::nullValue;
 }
 
-int AbstractProtocolHandler::ValidateRequest(const Json::Value &request)
+int AbstractProtocolHandler::ValidateRequest(const Json::Value &request, DispatchEntry *&entry, const JsonView *parameters)
 {
+    unsigned long long started = RpcMetrics::Start(this->metrics);
+    DispatchEntry *found = NULL;
     int error = 0;
-    Procedure proc;
+    entry = NULL;
     if (!this->ValidateRequestFields(request))
     {
         error = Errors::ERROR_RPC_INVALID_REQUEST;
     }
     else
     {
-        map<string, Procedure>::iterator it = this->procedures.find(request[KEY_REQUEST_METHODNAME].asString());
-        if (it != this->procedures.end())
+        //The name is looked up in place, ValidateRequestFields made sure it is a string.
+        const char *begin = NULL;
+        const char *end = NULL;
+        request[KEY_REQUEST_METHODNAME].getString(&begin, &end);
+        found = this->procedures.Find(begin, end - begin);
+        if (found != NULL)
         {
-            proc = it->second;
-            if(this->GetRequestType(request) == RPC_METHOD && proc.GetProcedureType() == RPC_NOTIFICATION)
+            const Procedure &proc = found->procedure;
+            procedure_t requestType = this->GetRequestType(request);
+            if(requestType == RPC_METHOD && proc.GetProcedureType() == RPC_NOTIFICATION)
             {
                 error = Errors::ERROR_SERVER_PROCEDURE_IS_NOTIFICATION;
             }
-            else if(this->GetRequestType(request) == RPC_NOTIFICATION && proc.GetProcedureType() == RPC_METHOD)
+            else if(requestType == RPC_NOTIFICATION && proc.GetProcedureType() == RPC_METHOD)
             {
                 error = Errors::ERROR_SERVER_PROCEDURE_IS_METHOD;
             }
-            else if (!proc.ValdiateParameters(request[KEY_REQUEST_PARAMETERS]))
+            else if (parameters != NULL ? !found->validator.Validate(*parameters) : !found->validator.Validate(request[KEY_REQUEST_PARAMETERS]))
             {
                 error = Errors::ERROR_RPC_INVALID_PARAMS;
             }
+            else
+            {
+                entry = found;
+            }
         }
         else
         {
             error = Errors::ERROR_RPC_METHOD_NOT_FOUND;
         }
     }
+
+    if (started != 0)
+    {
+        RpcMetrics::Stop(this->metrics, METRICS_VALIDATE, started);
+        if (error != 0 && found != NULL)
+            this->metrics->RecordError(found->metrics);
+    }
     return error;
 }
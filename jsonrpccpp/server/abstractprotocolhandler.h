@@ -12,15 +12,22 @@
 
 #include "iprocedureinvokationhandler.h"
 #include "iclientconnectionhandler.h"
-#include <map>
+#include "dispatchtable.h"
+#include "rpcmetrics.h"
+#include "responsecache.h"
 #include <string>
 #include <jsonrpccpp/common/procedure.h>
+#include <jsonrpccpp/common/exception.h>
 
 #define KEY_REQUEST_METHODNAME  "method"
 #define KEY_REQUEST_ID          "id"
 #define KEY_REQUEST_PARAMETERS  "params"
 #define KEY_RESPONSE_ERROR      "error"
 #define KEY_RESPONSE_RESULT     "result"
+#define KEY_REQUEST_DEADLINE    "deadline"  /*!< Optional, the milliseconds the caller waits from when the request is received*/
+
+#define SUBSCRIBE_METHOD_NAME   "rpc.subscribe"
+#define UNSUBSCRIBE_METHOD_NAME "rpc.unsubscribe"
 
 namespace jsonrpc {
 
@@ -31,21 +38,105 @@ namespace jsonrpc {
             virtual ~AbstractProtocolHandler();
 
             void HandleRequest(const std::string& request, std::string& retValue);
+            void HandleRequest(const char* begin, const char* end, std::string& retValue);
+            void HandleRequest(const char* begin, const char* end, std::ostream& response);
+            void HandleRejectedRequest(const std::string& request, int code, std::string& retValue);
+
+            /**
+             * Looks for the procedure names in the raw request instead of parsing it, a batch gets the most urgent priority
+             * of its calls. Unknown procedures and names the scan cannot read, e.g. with escapes, count as PRIORITY_NORMAL.
+             * Strings that contain a method member may mislead the scan, which only affects the lane of the request.
+             */
+            priority_t GetRequestPriority(const char* begin, const char* end);
+
+            /**
+             * Builds the error responses for a parsed request that will not be executed.
+             */
+            void RejectJsonRequest(const Json::Value& request, int code, Json::Value& response);
+
+            /**
+             * Parses [begin, end) in place with a reader that is cached per thread.
+             * @return false if the range does not hold a valid JSON document.
+             */
+            static bool ParseRequest(const char* begin, const char* end, Json::Value& request);
+
+            /**
+             * Serializes a response into a stream as compact as Json::FastWriter, without the trailing newline.
+             * The writer is cached per thread.
+             */
+            static void WriteResponse(const Json::Value& response, std::ostream& out);
+
+            virtual void AddProcedure(const Procedure& procedure, int binding = -1);
+            virtual void SetMetrics(RpcMetrics* metrics);
+            virtual void SetResponseCache(ResponseCache* cache);
+            virtual void EnableSubscriptions();
 
-            virtual void AddProcedure(const Procedure& procedure);
+            /**
+             * Produces the serialized response to a single method call from the response cache, without executing it
+             * or serializing its result again. The text has no trailing newline. A miss is kept for the thread, so that
+             * HandleJsonRequest executes the request without looking it up again.
+             * @return false if the request is no valid call of a cacheable method or its result is not cached.
+             */
+            bool FindCachedResponse(const Json::Value& request, std::string& response);
+
+            /**
+             * Drops the miss FindCachedResponse has kept, to be called once the request has been handled.
+             */
+            static void ForgetCacheMiss();
+
+            /**
+             * Handles a single text request of a procedure with lazy parameters from a JsonTape of the text. Only the members
+             * besides params are decoded, the procedure gets a JsonView of params, see Procedure::SetLazyParameters.
+             * @return false if the request is no such call or no strict JSON, it has not been handled then.
+             */
+            bool HandleLazyRequest(const char* begin, const char* end, Json::Value& response);
+
+            /**
+             * Scans the text for a method key naming a procedure with lazy parameters, like GetRequestPriority does,
+             * so that other requests are parsed once only. A key nested in params may match as well, the tape decides then.
+             * @return false if the text is no object or names no such procedure.
+             */
+            bool MayCallLazyProcedure(const char* begin, const char* end);
 
             virtual void HandleJsonRequest(const Json::Value& request, Json::Value& response) = 0;
             virtual bool ValidateRequestFields(const Json::Value &val) = 0;
             virtual void WrapResult(const Json::Value& request, Json::Value& response, Json::Value& retValue) = 0;
             virtual void WrapError(const Json::Value& request, int code, const std::string &message, Json::Value& result) = 0;
+            virtual void WrapException(const Json::Value& request, const JsonRpcException& exception, Json::Value& result) = 0;
             virtual procedure_t GetRequestType(const Json::Value& request) = 0;
 
+            /**
+             * The binding of the built-in rpc.metrics method, which the handler answers itself.
+             */
+            static const int BINDING_METRICS = -2;
+
+            /**
+             * The bindings of the built-in rpc.subscribe and rpc.unsubscribe methods, see EnableSubscriptions.
+             */
+            static const int BINDING_SUBSCRIBE = -3;
+            static const int BINDING_UNSUBSCRIBE = -4;
+
         protected:
             IProcedureInvokationHandler &handler;
-            std::map<std::string, Procedure> procedures;
+            DispatchTable procedures;
+            RpcMetrics *metrics;
+            ResponseCache *cache;
+            bool prioritized;       /*!< A procedure has a priority other than PRIORITY_NORMAL*/
+            bool lazy;              /*!< A procedure has lazy parameters*/
 
-            void ProcessRequest(const Json::Value &request, Json::Value &retValue);
-            int ValidateRequest(const Json::Value &val);
+            /**
+             * Invokes the procedure of a valid request in a CallContext with the deadline of the request. A call whose deadline
+             * has passed is not invoked: a method fails with ERROR_SERVER_DEADLINE_EXCEEDED, a notification is dropped.
+             * @param parameters - the params of the request for a procedure with lazy parameters, they are taken from
+             * request if NULL.
+             */
+            void ProcessRequest(const Json::Value &request, DispatchEntry &entry, Json::Value &retValue, const JsonView* parameters = NULL);
+            /**
+             * @param entry - set to the procedure the request calls if it is valid.
+             * @param parameters - validated instead of the params of the request if not NULL.
+             * @return 0 or the error code to answer the request with.
+             */
+            int ValidateRequest(const Json::Value &val, DispatchEntry *&entry, const JsonView* parameters = NULL);
 
     };
 
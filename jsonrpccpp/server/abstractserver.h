@@ -28,6 +28,8 @@ namespace jsonrpc
         public:
             typedef void(S::*methodPointer_t)       (const Json::Value &parameter, Json::Value &result);
             typedef void(S::*notificationPointer_t) (const Json::Value &parameter);
+            typedef void(S::*lazyMethodPointer_t)       (const JsonView &parameter, Json::Value &result);
+            typedef void(S::*lazyNotificationPointer_t) (const JsonView &parameter);
 
             AbstractServer(AbstractServerConnector &connector, serverVersion_t type = JSONRPC_SERVER_V2) :
                 connection(connector)
@@ -51,25 +53,121 @@ namespace jsonrpc
                 return connection.StopListening();
             }
 
+            /**
+             * Executes the calls of JSON-RPC 2.0 batches in parallel on the given pool, see IProtocolHandler::SetBatchExecutor.
+             */
+            void SetBatchExecutor(ThreadPool* executor)
+            {
+                this->handler->SetBatchExecutor(executor);
+            }
+
+            bool GetBatchStatistics(BatchStatistics& statistics)
+            {
+                return this->handler->GetBatchStatistics(statistics);
+            }
+
+            /**
+             * Records latencies and per-method counters into metrics and answers the method rpc.metrics with them,
+             * see RpcMetrics. Call before StartListening(), metrics must outlive the server.
+             */
+            void SetMetrics(RpcMetrics* metrics)
+            {
+                this->handler->SetMetrics(metrics);
+                this->connection.SetMetrics(metrics);
+            }
+
+            /**
+             * Answers repeated calls of procedures with a cache ttl from cache, see ResponseCache and Procedure::SetCacheTtl.
+             * Call before StartListening(), cache must outlive the server. Invalidate it when the results change.
+             */
+            void SetResponseCache(ResponseCache* cache)
+            {
+                this->handler->SetResponseCache(cache);
+            }
+
+            /**
+             * Lets clients subscribe to events with rpc.subscribe and rpc.unsubscribe, see IProtocolHandler::EnableSubscriptions.
+             * Only connectors with persistent connections, i.e. the socket servers in keep-alive mode, accept subscriptions.
+             * Clients receive the notifications with AsyncClient. Call before StartListening().
+             */
+            void EnableSubscriptions()
+            {
+                this->handler->EnableSubscriptions();
+            }
+
+            /**
+             * Pushes a notification with the event as method to the connections subscribed to it, see AbstractServerConnector::Publish.
+             * @return the number of connections it was sent to.
+             */
+            unsigned int Publish(const std::string& event, const Json::Value& parameters)
+            {
+                return this->connection.Publish(event, parameters);
+            }
+
             virtual void HandleMethodCall(Procedure &proc, const Json::Value& input, Json::Value& output)
             {
-                S* instance = dynamic_cast<S*>(this);
+                S* instance = static_cast<S*>(this);
                 (instance->*methods[proc.GetProcedureName()])(input, output);
             }
 
             virtual void HandleNotificationCall(Procedure &proc, const Json::Value& input)
             {
-                S* instance = dynamic_cast<S*>(this);
+                S* instance = static_cast<S*>(this);
                 (instance->*notifications[proc.GetProcedureName()])(input);
             }
 
+            virtual void InvokeMethod(Procedure &proc, int binding, const Json::Value& input, Json::Value& output)
+            {
+                if (binding < 0)
+                {
+                    this->HandleMethodCall(proc, input, output);
+                    return;
+                }
+                S* instance = static_cast<S*>(this);
+                (instance->*methodTable[binding])(input, output);
+            }
+
+            virtual void InvokeNotification(Procedure &proc, int binding, const Json::Value& input)
+            {
+                if (binding < 0)
+                {
+                    this->HandleNotificationCall(proc, input);
+                    return;
+                }
+                S* instance = static_cast<S*>(this);
+                (instance->*notificationTable[binding])(input);
+            }
+
+            virtual void InvokeLazyMethod(Procedure &proc, int binding, const JsonView& input, Json::Value& output)
+            {
+                if (binding < 0)
+                {
+                    IProcedureInvokationHandler::InvokeLazyMethod(proc, binding, input, output);
+                    return;
+                }
+                S* instance = static_cast<S*>(this);
+                (instance->*lazyMethodTable[binding])(input, output);
+            }
+
+            virtual void InvokeLazyNotification(Procedure &proc, int binding, const JsonView& input)
+            {
+                if (binding < 0)
+                {
+                    IProcedureInvokationHandler::InvokeLazyNotification(proc, binding, input);
+                    return;
+                }
+                S* instance = static_cast<S*>(this);
+                (instance->*lazyNotificationTable[binding])(input);
+            }
+
         protected:
             bool bindAndAddMethod(const Procedure& proc, methodPointer_t pointer)
             {
                 if(proc.GetProcedureType() == RPC_METHOD && !this->symbolExists(proc.GetProcedureName()))
                 {
-                    this->handler->AddProcedure(proc);
+                    this->handler->AddProcedure(proc, this->methodTable.size());
                     this->methods[proc.GetProcedureName()] = pointer;
+                    this->methodTable.push_back(pointer);
                     return true;
                 }
                 return false;
@@ -79,8 +177,59 @@ namespace jsonrpc
             {
                 if(proc.GetProcedureType() == RPC_NOTIFICATION && !this->symbolExists(proc.GetProcedureName()))
                 {
-                    this->handler->AddProcedure(proc);
+                    this->handler->AddProcedure(proc, this->notificationTable.size());
                     this->notifications[proc.GetProcedureName()] = pointer;
+                    this->notificationTable.push_back(pointer);
+                    return true;
+                }
+                return false;
+            }
+
+            /**
+             * Registers a method the subclass dispatches itself by overriding InvokeMethod, as the stubs generated by
+             * jsonrpcstub do. Its binding is the number of methods registered before it.
+             */
+            bool bindAndAddMethod(const Procedure& proc)
+            {
+                return this->bindAndAddMethod(proc, NULL);
+            }
+
+            /**
+             * Registers a notification the subclass dispatches itself by overriding InvokeNotification.
+             * Its binding is the number of notifications registered before it.
+             */
+            bool bindAndAddNotification(const Procedure& proc)
+            {
+                return this->bindAndAddNotification(proc, NULL);
+            }
+
+            /**
+             * Registers a method that reads its parameters through a JsonView, see Procedure::SetLazyParameters.
+             * Single requests over text connectors are not decoded beyond their envelope, the method decodes what it reads.
+             */
+            bool bindAndAddLazyMethod(const Procedure& proc, lazyMethodPointer_t pointer)
+            {
+                if(proc.GetProcedureType() == RPC_METHOD && !this->symbolExists(proc.GetProcedureName()))
+                {
+                    Procedure lazy(proc);
+                    lazy.SetLazyParameters(true);
+                    this->handler->AddProcedure(lazy, this->lazyMethodTable.size());
+                    this->lazyMethods[proc.GetProcedureName()] = pointer;
+                    this->lazyMethodTable.push_back(pointer);
+                    return true;
+                }
+                return false;
+            }
+
+            bool bindAndAddLazyNotification(const Procedure& proc, lazyNotificationPointer_t pointer)
+            {
+                if(proc.GetProcedureType() == RPC_NOTIFICATION && !this->symbolExists(proc.GetProcedureName()))
+                {
+                    Procedure lazy(proc);
+                    lazy.SetLazyParameters(true);
+                    this->handler->AddProcedure(lazy, this->lazyNotificationTable.size());
+                    this->lazyNotifications[proc.GetProcedureName()] = pointer;
+                    this->lazyNotificationTable.push_back(pointer);
                     return true;
                 }
                 return false;
@@ -91,6 +240,12 @@ namespace jsonrpc
             IProtocolHandler                                *handler;
             std::map<std::string, methodPointer_t>          methods;
             std::map<std::string, notificationPointer_t>    notifications;
+            std::vector<methodPointer_t>                    methodTable;        /*!< Indexed by the binding passed to the protocol handler*/
+            std::vector<notificationPointer_t>              notificationTable;  /*!< Indexed by the binding passed to the protocol handler*/
+            std::map<std::string, lazyMethodPointer_t>          lazyMethods;
+            std::map<std::string, lazyNotificationPointer_t>    lazyNotifications;
+            std::vector<lazyMethodPointer_t>                    lazyMethodTable;
+            std::vector<lazyNotificationPointer_t>              lazyNotificationTable;
 
             bool symbolExists(const std::string &name)
             {
@@ -98,6 +253,10 @@ namespace jsonrpc
                     return true;
                 if (notifications.find(name) != notifications.end())
                     return true;
+                if (lazyMethods.find(name) != lazyMethods.end())
+                    return true;
+                if (lazyNotifications.find(name) != lazyNotifications.end())
+                    return true;
                 return false;
             }
     };
@@ -9,33 +9,722 @@
 
 #include "abstractserverconnector.h"
 #include <jsonrpccpp/common/specificationwriter.h>
+#include <jsonrpccpp/common/errors.h>
+#include <jsonrpccpp/common/cbor.h>
 #include <cstdlib>
+#include <deque>
+#include <vector>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <string.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace jsonrpc;
 
+/**
+ * The request a thread is processing, so the protocol handler can subscribe its connection.
+ */
+struct AbstractServerConnector::RequestContext
+{
+    AbstractServerConnector *connector;
+    void *addInfo;
+    bool writer;            /*!< The thread may write to the connection of a subscriber, notifications are queued meanwhile*/
+};
+
+struct AbstractServerConnector::Subscriber
+{
+    set<string> events;
+    deque<string> queue;    /*!< Notifications waiting for the thread writing to the connection*/
+    bool binary;            /*!< The connection uses binary framing, the queue holds CBOR payloads*/
+    bool writing;           /*!< A thread writes to the connection, it sends the queue before it stops*/
+    bool failed;            /*!< A notification could not be sent, the connection is being shut down*/
+};
+
+static pthread_once_t context_once = PTHREAD_ONCE_INIT;
+static pthread_key_t context_key;
+
+static void CreateContextKey()
+{
+    pthread_key_create(&context_key, NULL);
+}
+
+/**
+ * Executes one request on the executor. If done is set, the submitting thread waits on it and the
+ * request is used in place, otherwise it is copied because the connector reuses its buffer.
+ */
+class AbstractServerConnector::RequestTask : public IThreadPoolTask
+{
+    public:
+        struct Completion
+        {
+            bool finished;
+            pthread_mutex_t lock;
+            pthread_cond_t cond;
+        };
+
+        RequestTask(AbstractServerConnector *connector, const char *begin, const char *end, void *addInfo, Completion *done) :
+            connector(connector),
+            begin(begin),
+            end(end),
+            addInfo(addInfo),
+            done(done),
+            priority(connector->GetRequestPriority(begin, end)),
+            queued(RpcMetrics::Start(connector->metrics)),
+            received(RpcMetrics::Now())
+        {
+            if (done == NULL)
+            {
+                this->request.assign(begin, end);
+                this->begin = this->request.data();
+                this->end = this->begin + this->request.size();
+            }
+        }
+
+        priority_t GetPriority() const
+        {
+            return priority;
+        }
+
+        void Run()
+        {
+            RpcMetrics::StopQueue(connector->metrics, priority, queued);
+            connector->ProcessRequest(begin, end, addInfo, received);
+            connector->EndRequest(end - begin);
+            if (done != NULL)
+            {
+                pthread_mutex_lock(&done->lock);
+                done->finished = true;
+                pthread_cond_signal(&done->cond);
+                pthread_mutex_unlock(&done->lock);
+            }
+            connector->EndPendingRequest();
+        }
+
+    private:
+        AbstractServerConnector *connector;
+        string request;
+        const char *begin;
+        const char *end;
+        void *addInfo;
+        Completion *done;
+        priority_t priority;
+        unsigned long long queued;
+        unsigned long long received;
+};
+
 AbstractServerConnector::AbstractServerConnector()
 {
     this->handler = NULL;
+    this->executor = NULL;
+    this->metrics = NULL;
+    this->pending = 0;
+    this->subscriber_count = 0;
+    this->max_connections = 0;
+    this->max_requests = 0;
+    this->max_bytes = 0;
+    memset(&this->admission, 0, sizeof(this->admission));
+    pthread_mutex_init(&this->pending_lock, NULL);
+    pthread_cond_init(&this->pending_done, NULL);
+    pthread_mutex_init(&this->subscription_lock, NULL);
+    pthread_cond_init(&this->subscription_idle, NULL);
 }
 
 AbstractServerConnector::~AbstractServerConnector()
 {
+    for (map<void*, Subscriber*>::iterator it = this->subscribers.begin(); it != this->subscribers.end(); ++it)
+        delete it->second;
+    pthread_cond_destroy(&this->subscription_idle);
+    pthread_mutex_destroy(&this->subscription_lock);
+    pthread_cond_destroy(&this->pending_done);
+    pthread_mutex_destroy(&this->pending_lock);
 }
 
 bool AbstractServerConnector::OnRequest(const std::string& request, void* addInfo)
 {
-    string response;
-    if (this->handler != NULL)
+    return this->OnRequest(request.data(), request.data() + request.size(), addInfo);
+}
+
+bool AbstractServerConnector::OnRequest(const char* begin, const char* end, void* addInfo)
+{
+    if (this->handler == NULL)
+        return false;
+    if (!this->AdmitRequest(end - begin))
     {
-        this->handler->HandleRequest(request, response);
-        this->SendResponse(response, addInfo);
+        this->RejectRequest(begin, end, addInfo);
+        return true;
+    }
+    if (this->executor == NULL)
+    {
+        bool result = this->ProcessRequest(begin, end, addInfo);
+        this->EndRequest(end - begin);
+        return result;
+    }
+
+    RequestTask *task = new RequestTask(this, begin, end, addInfo, NULL);
+    this->BeginPendingRequest();
+    if (!this->executor->Submit(task, task->GetPriority()))
+    {
+        delete task;
+        this->EndPendingRequest();
+        this->EndRequest(end - begin);
+        this->RejectRequest(begin, end, addInfo);
+    }
+    return true;
+}
+
+bool AbstractServerConnector::OnRequestAndWait(const std::string& request, void* addInfo)
+{
+    return this->OnRequestAndWait(request.data(), request.data() + request.size(), addInfo);
+}
+
+bool AbstractServerConnector::OnRequestAndWait(const char* begin, const char* end, void* addInfo)
+{
+    if (this->handler == NULL)
+        return false;
+    if (!this->AdmitRequest(end - begin))
+    {
+        this->RejectRequest(begin, end, addInfo);
         return true;
     }
+    if (this->executor == NULL)
+    {
+        bool result = this->ProcessRequest(begin, end, addInfo);
+        this->EndRequest(end - begin);
+        return result;
+    }
+
+    RequestTask::Completion done;
+    done.finished = false;
+    pthread_mutex_init(&done.lock, NULL);
+    pthread_cond_init(&done.cond, NULL);
+
+    RequestTask *task = new RequestTask(this, begin, end, addInfo, &done);
+    this->BeginPendingRequest();
+    if (this->executor->Submit(task, task->GetPriority()))
+    {
+        pthread_mutex_lock(&done.lock);
+        while (!done.finished)
+            pthread_cond_wait(&done.cond, &done.lock);
+        pthread_mutex_unlock(&done.lock);
+    }
     else
     {
+        delete task;
+        this->EndPendingRequest();
+        this->EndRequest(end - begin);
+        this->RejectRequest(begin, end, addInfo);
+    }
+
+    pthread_cond_destroy(&done.cond);
+    pthread_mutex_destroy(&done.lock);
+    return true;
+}
+
+bool AbstractServerConnector::ProcessRequest(const std::string& request, void* addInfo)
+{
+    return this->ProcessRequest(request.data(), request.data() + request.size(), addInfo);
+}
+
+bool AbstractServerConnector::ProcessRequest(const char* begin, const char* end, void* addInfo)
+{
+    return this->ProcessRequest(begin, end, addInfo, RpcMetrics::Now());
+}
+
+bool AbstractServerConnector::ProcessRequest(const char* begin, const char* end, void* addInfo, unsigned long long received)
+{
+    if (this->handler == NULL)
         return false;
+    unsigned long long started = RpcMetrics::Start(this->metrics);
+    RequestContext context;
+    context.connector = this;
+    context.addInfo = addInfo;
+    context.writer = false;
+    pthread_once(&context_once, CreateContextKey);
+    //A procedure may handle a request inline, the outer request is current again afterwards.
+    void *outer = pthread_getspecific(context_key);
+    pthread_setspecific(context_key, &context);
+    CallContext call(this, addInfo, received);
+    CallContext *previous = CallContext::Enter(&call);
+
+    bool result = true;
+    if (this->IsBinaryRequest(addInfo))
+    {
+        result = this->ProcessBinaryRequest(begin, end, context);
+    }
+    else
+    {
+        //The response to a subscriber is written in one piece, so notifications wait for the write but not for the request.
+        unsigned long long writing;
+        ResponseWriter *writer = this->IsSubscriber(addInfo) ? NULL : this->OpenResponse(addInfo);
+        if (writer != NULL)
+        {
+            ostream out(writer);
+            this->handler->HandleRequest(begin, end, out);
+            writing = RpcMetrics::Start(this->metrics);
+            this->CloseResponse(writer, addInfo);
+        }
+        else
+        {
+            string response;
+            this->handler->HandleRequest(begin, end, response);
+            writing = RpcMetrics::Start(this->metrics);
+            this->AcquireWriter(context);
+            this->SendResponse(response, addInfo);
+        }
+        RpcMetrics::Stop(this->metrics, METRICS_WRITE, writing);
+    }
+    CallContext::Enter(previous);
+    pthread_setspecific(context_key, outer);
+    RpcMetrics::Stop(this->metrics, METRICS_REQUEST, started);
+    this->ReleaseWriter(context);
+    return result;
+}
+
+bool AbstractServerConnector::ProcessBinaryRequest(const char* begin, const char* end, RequestContext& context)
+{
+    Json::Value request;
+    unsigned long long started = RpcMetrics::Start(this->metrics);
+    bool decoded = Cbor::Decode(begin, end, request);
+    RpcMetrics::Stop(this->metrics, METRICS_PARSE, started);
+    if (!decoded)
+    {
+        //An empty request is never valid JSON, the handler answers it with a parse error.
+        string response;
+        this->handler->HandleRequest(end, end, response);
+        this->AcquireWriter(context);
+        return this->SendJsonResponse(response, context.addInfo);
+    }
+
+    Json::Value response;
+    string payload;
+    this->handler->HandleJsonRequest(request, response);
+    started = RpcMetrics::Start(this->metrics);
+    if (response != Json::nullValue)
+        Cbor::Encode(response, payload);
+    RpcMetrics::Stop(this->metrics, METRICS_SERIALIZE, started);
+
+    started = RpcMetrics::Start(this->metrics);
+    this->AcquireWriter(context);
+    bool result = this->SendBinaryResponse(payload, context.addInfo);
+    RpcMetrics::Stop(this->metrics, METRICS_WRITE, started);
+    return result;
+}
+
+bool AbstractServerConnector::SendJsonResponse(const std::string& response, void* addInfo)
+{
+    Json::Reader reader;
+    Json::Value value;
+    string payload;
+    if (!response.empty() && reader.parse(response, value, false))
+        Cbor::Encode(value, payload);
+    return this->SendBinaryResponse(payload, addInfo);
+}
+
+ResponseWriter *AbstractServerConnector::OpenResponse(void* addInfo)
+{
+    (void)addInfo;
+    return NULL;
+}
+
+bool AbstractServerConnector::CloseResponse(ResponseWriter* writer, void* addInfo)
+{
+    (void)addInfo;
+    bool result = writer->Flush();
+    delete writer;
+    return result;
+}
+
+bool AbstractServerConnector::IsBinaryRequest(void* addInfo)
+{
+    (void)addInfo;
+    return false;
+}
+
+bool AbstractServerConnector::SendBinaryResponse(const std::string& payload, void* addInfo)
+{
+    (void)payload;
+    (void)addInfo;
+    return false;
+}
+
+bool AbstractServerConnector::CanPush(void* addInfo)
+{
+    (void)addInfo;
+    return false;
+}
+
+bool AbstractServerConnector::SendPush(const std::string& message, bool binary, void* addInfo)
+{
+    (void)message;
+    (void)binary;
+    (void)addInfo;
+    return false;
+}
+
+bool AbstractServerConnector::IsPeerClosed(void* addInfo)
+{
+    (void)addInfo;
+    return false;
+}
+
+size_t AbstractServerConnector::GetPayloadCount(void* addInfo)
+{
+    (void)addInfo;
+    return 0;
+}
+
+const BulkPayload* AbstractServerConnector::GetPayload(void* addInfo, size_t index)
+{
+    (void)addInfo;
+    (void)index;
+    return NULL;
+}
+
+void AbstractServerConnector::RejectRequest(const char* begin, const char* end, void* addInfo)
+{
+    __atomic_add_fetch(&this->admission.shedRequests, 1, __ATOMIC_RELAXED);
+    string response;
+    RequestContext context;
+    context.connector = this;
+    context.addInfo = addInfo;
+    context.writer = false;
+    if (this->IsBinaryRequest(addInfo))
+    {
+        //Rejection works on text, the rare busy answer is not worth a binary path of its own.
+        Json::Value request;
+        Json::FastWriter writer;
+        if (this->handler != NULL && Cbor::Decode(begin, end, request))
+            this->handler->HandleRejectedRequest(writer.write(request), Errors::ERROR_SERVER_BUSY, response);
+        else if (this->handler != NULL)
+            this->handler->HandleRequest(end, end, response);
+        this->AcquireWriter(context);
+        this->SendJsonResponse(response, addInfo);
     }
+    else
+    {
+        if (this->handler != NULL)
+            this->handler->HandleRejectedRequest(string(begin, end), Errors::ERROR_SERVER_BUSY, response);
+        this->AcquireWriter(context);
+        this->SendResponse(response, addInfo);
+    }
+    this->ReleaseWriter(context);
+}
+
+unsigned int AbstractServerConnector::Publish(const std::string& event, const Json::Value& parameters)
+{
+    if (__atomic_load_n(&this->subscriber_count, __ATOMIC_ACQUIRE) == 0)
+        return 0;
+
+    Json::Value notification;
+    notification["jsonrpc"] = "2.0";
+    notification["method"] = event;
+    if (!parameters.isNull())
+        notification["params"] = parameters;
+    Json::FastWriter writer;
+    string text = writer.write(notification);
+    string payload;
+
+    vector<void*> idle;
+    unsigned int count = 0;
+    pthread_mutex_lock(&this->subscription_lock);
+    for (map<void*, Subscriber*>::iterator it = this->subscribers.begin(); it != this->subscribers.end(); ++it)
+    {
+        Subscriber *subscriber = it->second;
+        if (subscriber->failed || subscriber->events.count(event) == 0)
+            continue;
+        if (subscriber->binary && payload.empty())
+            Cbor::Encode(notification, payload);
+        subscriber->queue.push_back(subscriber->binary ? payload : text);
+        count++;
+        if (!subscriber->writing)
+        {
+            subscriber->writing = true;
+            idle.push_back(it->first);
+        }
+    }
+    pthread_mutex_unlock(&this->subscription_lock);
+
+    for (size_t i = 0; i < idle.size(); i++)
+        this->SendPushes(idle[i]);
+    return count;
+}
+
+bool AbstractServerConnector::Subscribe(const std::string& event, bool subscribe)
+{
+    pthread_once(&context_once, CreateContextKey);
+    RequestContext *context = static_cast<RequestContext*>(pthread_getspecific(context_key));
+    if (context == NULL || !context->connector->CanPush(context->addInfo))
+        return false;
+    AbstractServerConnector *connector = context->connector;
+    bool binary = connector->IsBinaryRequest(context->addInfo);
+
+    pthread_mutex_lock(&connector->subscription_lock);
+    map<void*, Subscriber*>::iterator it = connector->subscribers.find(context->addInfo);
+    if (it == connector->subscribers.end() && subscribe)
+    {
+        //The thread is about to write the response, it sends what is published meanwhile afterwards.
+        Subscriber *subscriber = new Subscriber();
+        subscriber->binary = binary;
+        subscriber->writing = true;
+        subscriber->failed = false;
+        it = connector->subscribers.insert(make_pair(context->addInfo, subscriber)).first;
+        __atomic_store_n(&connector->subscriber_count, connector->subscribers.size(), __ATOMIC_RELEASE);
+        context->writer = true;
+    }
+    if (it != connector->subscribers.end())
+    {
+        if (subscribe)
+            it->second->events.insert(event);
+        else
+            it->second->events.erase(event);
+    }
+    pthread_mutex_unlock(&connector->subscription_lock);
+    return true;
+}
+
+void AbstractServerConnector::RemoveSubscriber(void* addInfo)
+{
+    if (__atomic_load_n(&this->subscriber_count, __ATOMIC_ACQUIRE) == 0)
+        return;
+    pthread_mutex_lock(&this->subscription_lock);
+    map<void*, Subscriber*>::iterator it = this->subscribers.find(addInfo);
+    if (it != this->subscribers.end())
+    {
+        while (it->second->writing)
+            pthread_cond_wait(&this->subscription_idle, &this->subscription_lock);
+        delete it->second;
+        this->subscribers.erase(it);
+        __atomic_store_n(&this->subscriber_count, this->subscribers.size(), __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&this->subscription_lock);
+}
+
+bool AbstractServerConnector::IsSubscriber(void* addInfo)
+{
+    if (__atomic_load_n(&this->subscriber_count, __ATOMIC_ACQUIRE) == 0)
+        return false;
+    pthread_mutex_lock(&this->subscription_lock);
+    bool found = this->subscribers.count(addInfo) > 0;
+    pthread_mutex_unlock(&this->subscription_lock);
+    return found;
+}
+
+void AbstractServerConnector::AcquireWriter(RequestContext& context)
+{
+    //Only the thread handling a request of the connection subscribes it, so a connection missed here cannot become a subscriber.
+    if (context.writer || __atomic_load_n(&this->subscriber_count, __ATOMIC_ACQUIRE) == 0)
+        return;
+    pthread_mutex_lock(&this->subscription_lock);
+    map<void*, Subscriber*>::iterator it = this->subscribers.find(context.addInfo);
+    if (it != this->subscribers.end())
+    {
+        while (it->second->writing)
+            pthread_cond_wait(&this->subscription_idle, &this->subscription_lock);
+        it->second->writing = true;
+        context.writer = true;
+    }
+    pthread_mutex_unlock(&this->subscription_lock);
+}
+
+void AbstractServerConnector::ReleaseWriter(RequestContext& context)
+{
+    if (!context.writer)
+        return;
+    context.writer = false;
+    this->SendPushes(context.addInfo);
+}
+
+void AbstractServerConnector::SendPushes(void* addInfo)
+{
+    //The caller has set writing, so the subscriber is not removed meanwhile.
+    pthread_mutex_lock(&this->subscription_lock);
+    Subscriber *subscriber = this->subscribers[addInfo];
+    while (!subscriber->queue.empty())
+    {
+        string message;
+        message.swap(subscriber->queue.front());
+        subscriber->queue.pop_front();
+        bool binary = subscriber->binary;
+        pthread_mutex_unlock(&this->subscription_lock);
+        bool sent = this->SendPush(message, binary, addInfo);
+        pthread_mutex_lock(&this->subscription_lock);
+        if (!sent)
+        {
+            subscriber->failed = true;
+            subscriber->queue.clear();
+        }
+    }
+    subscriber->writing = false;
+    pthread_cond_broadcast(&this->subscription_idle);
+    pthread_mutex_unlock(&this->subscription_lock);
+}
+
+void AbstractServerConnector::SetExecutor(ThreadPool* executor)
+{
+    this->executor = executor;
+}
+
+ThreadPool *AbstractServerConnector::GetExecutor()
+{
+    return this->executor;
+}
+
+void AbstractServerConnector::SetMetrics(RpcMetrics* metrics)
+{
+    this->metrics = metrics;
+}
+
+RpcMetrics *AbstractServerConnector::GetMetrics()
+{
+    return this->metrics;
+}
+
+void AbstractServerConnector::RecordRead(unsigned long long arrival)
+{
+    if (arrival != 0 && this->metrics != NULL && this->metrics->IsEnabled())
+        this->metrics->Record(METRICS_READ, RpcMetrics::Now() - arrival);
+}
+
+void AbstractServerConnector::SetAdmissionLimits(unsigned int maxConnections, unsigned int maxRequests, size_t maxBytes)
+{
+    this->max_connections = maxConnections;
+    this->max_requests = maxRequests;
+    this->max_bytes = maxBytes;
+}
+
+void AbstractServerConnector::GetAdmissionStatistics(AdmissionStatistics& statistics)
+{
+    statistics.connections = __atomic_load_n(&this->admission.connections, __ATOMIC_RELAXED);
+    statistics.requests = __atomic_load_n(&this->admission.requests, __ATOMIC_RELAXED);
+    statistics.bytes = __atomic_load_n(&this->admission.bytes, __ATOMIC_RELAXED);
+    statistics.refusedConnections = __atomic_load_n(&this->admission.refusedConnections, __ATOMIC_RELAXED);
+    statistics.shedRequests = __atomic_load_n(&this->admission.shedRequests, __ATOMIC_RELAXED);
+    statistics.acceptQueuePeak = __atomic_load_n(&this->admission.acceptQueuePeak, __ATOMIC_RELAXED);
+    statistics.acceptQueueFull = __atomic_load_n(&this->admission.acceptQueueFull, __ATOMIC_RELAXED);
+}
+
+bool AbstractServerConnector::AdmitConnection(int fd, char delimiter)
+{
+    unsigned int connections = __atomic_add_fetch(&this->admission.connections, 1, __ATOMIC_RELAXED);
+    if (this->max_connections == 0 || connections <= this->max_connections)
+        return true;
+    __atomic_sub_fetch(&this->admission.connections, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&this->admission.refusedConnections, 1, __ATOMIC_RELAXED);
+    this->SendBusy(fd, delimiter);
+    close(fd);
+    return false;
+}
+
+void AbstractServerConnector::LeaveConnection()
+{
+    __atomic_sub_fetch(&this->admission.connections, 1, __ATOMIC_RELAXED);
+}
+
+bool AbstractServerConnector::AdmitRequest(size_t size)
+{
+    //Requests racing for the last slot may both be refused, which errs on the safe side.
+    unsigned int requests = __atomic_add_fetch(&this->admission.requests, 1, __ATOMIC_RELAXED);
+    unsigned long long bytes = __atomic_add_fetch(&this->admission.bytes, size, __ATOMIC_RELAXED);
+    if ((this->max_requests == 0 || requests <= this->max_requests) && (this->max_bytes == 0 || bytes <= this->max_bytes))
+        return true;
+    this->EndRequest(size);
+    return false;
+}
+
+void AbstractServerConnector::EndRequest(size_t size)
+{
+    __atomic_sub_fetch(&this->admission.requests, 1, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&this->admission.bytes, size, __ATOMIC_RELAXED);
+}
+
+bool AbstractServerConnector::CanBuffer(size_t size)
+{
+    return this->max_bytes == 0 || size <= this->max_bytes;
+}
+
+void AbstractServerConnector::RecordAcceptQueue(unsigned int length, unsigned int backlog)
+{
+    unsigned int peak = __atomic_load_n(&this->admission.acceptQueuePeak, __ATOMIC_RELAXED);
+    while (length > peak && !__atomic_compare_exchange_n(&this->admission.acceptQueuePeak, &peak, length, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+    if (backlog > 0 && length >= backlog)
+        __atomic_add_fetch(&this->admission.acceptQueueFull, 1, __ATOMIC_RELAXED);
+}
+
+void AbstractServerConnector::RefuseConnection(int fd, char delimiter)
+{
+    __atomic_add_fetch(&this->admission.shedRequests, 1, __ATOMIC_RELAXED);
+    this->SendBusy(fd, delimiter);
+}
+
+void AbstractServerConnector::SendBusy(int fd, char delimiter)
+{
+    //Without a request there is no id to answer, the error carries null.
+    string response;
+    if (this->handler != NULL)
+        this->handler->HandleRejectedRequest("null", Errors::ERROR_SERVER_BUSY, response);
+    //Written without waiting, the accepting thread or an event loop must not stall on a client that does not read.
+    SocketResponseWriter::SendMessage(fd, response, delimiter, 0);
+
+    //Closing a socket with unread data resets it and may discard the answer, so what has arrived is read first.
+    char discard[4096];
+    for (int i = 0; i < 16 && recv(fd, discard, sizeof(discard), MSG_DONTWAIT) > 0; i++)
+        ;
+    shutdown(fd, SHUT_WR);
+}
+
+priority_t AbstractServerConnector::GetRequestPriority(const char* begin, const char* end)
+{
+    return this->handler->GetRequestPriority(begin, end);
+}
+
+void AbstractServerConnector::BeginPendingRequest()
+{
+    pthread_mutex_lock(&this->pending_lock);
+    this->pending++;
+    pthread_mutex_unlock(&this->pending_lock);
+}
+
+void AbstractServerConnector::EndPendingRequest()
+{
+    pthread_mutex_lock(&this->pending_lock);
+    if (--this->pending == 0)
+        pthread_cond_broadcast(&this->pending_done);
+    pthread_mutex_unlock(&this->pending_lock);
+}
+
+void AbstractServerConnector::WaitForPendingRequests()
+{
+    pthread_mutex_lock(&this->pending_lock);
+    while (this->pending > 0)
+        pthread_cond_wait(&this->pending_done, &this->pending_lock);
+    pthread_mutex_unlock(&this->pending_lock);
+}
+
+void AbstractServerConnector::BeginConnection(int fd)
+{
+    pthread_mutex_lock(&this->pending_lock);
+    this->pending++;
+    this->connections.insert(fd);
+    pthread_mutex_unlock(&this->pending_lock);
+}
+
+void AbstractServerConnector::ReleaseConnection(int fd)
+{
+    pthread_mutex_lock(&this->pending_lock);
+    this->connections.erase(fd);
+    pthread_mutex_unlock(&this->pending_lock);
+    this->RemoveSubscriber(reinterpret_cast<void*>(static_cast<intptr_t>(fd)));
+}
+
+void AbstractServerConnector::ShutdownConnections()
+{
+    //The threads see the end of their connection and exit, a released socket may already be closed and is not touched.
+    pthread_mutex_lock(&this->pending_lock);
+    for (set<int>::iterator it = this->connections.begin(); it != this->connections.end(); ++it)
+        shutdown(*it, SHUT_RDWR);
+    pthread_mutex_unlock(&this->pending_lock);
 }
 
 void AbstractServerConnector::SetHandler(IClientConnectionHandler* handler)
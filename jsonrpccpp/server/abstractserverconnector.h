@@ -10,14 +10,33 @@
 #ifndef JSONRPC_CPP_SERVERCONNECTOR_H_
 #define JSONRPC_CPP_SERVERCONNECTOR_H_
 
+#include <map>
+#include <set>
 #include <string>
+#include <pthread.h>
 #include "iclientconnectionhandler.h"
+#include "threadpool.h"
+#include "responsewriter.h"
+#include "rpcmetrics.h"
+#include "callcontext.h"
 
 namespace jsonrpc
 {
-    
+    struct AdmissionStatistics
+    {
+        unsigned int        connections;        /*!< Connections open now, if the connector tracks them*/
+        unsigned int        requests;           /*!< Requests received and not answered yet*/
+        unsigned long long  bytes;              /*!< The size of these requests*/
+        unsigned long long  refusedConnections; /*!< Connections answered with ERROR_SERVER_BUSY and closed right after accepting them*/
+        unsigned long long  shedRequests;       /*!< Requests answered with ERROR_SERVER_BUSY instead of being executed*/
+        unsigned int        acceptQueuePeak;    /*!< The longest accept queue of the listening socket seen, 0 if the connector cannot tell*/
+        unsigned long long  acceptQueueFull;    /*!< Times the accept queue has been found at its backlog, the kernel drops new connections then*/
+    };
+
     class AbstractServerConnector
     {
+        friend class CallContext;
+
         public:
             AbstractServerConnector();
             virtual ~AbstractServerConnector();
@@ -43,16 +62,251 @@ namespace jsonrpc
 
             /**
              * This method must be called, when a request is recognised. It will do everything else for you (including sending the response).
+             * If an executor is set, the request is queued and this method returns before the response is sent, so addInfo must stay valid until SendResponse has been called.
              * @param request - the request that has been recognised.
              * @param addInfo - additional Info, that the Connector might need for responding.
              */
             bool OnRequest(const std::string& request, void* addInfo = NULL);
 
+            /**
+             * Same as OnRequest for a request held in [begin, end), e.g. in a RequestBuffer. The range is parsed in place,
+             * it is only copied if an executor handles the request after this method has returned.
+             */
+            bool OnRequest(const char* begin, const char* end, void* addInfo);
+
+            /**
+             * Same as OnRequest, but returns only after the response has been sent, so the request is never copied.
+             * Connectors that read several requests from one connection use it to keep the responses in order.
+             */
+            bool OnRequestAndWait(const std::string& request, void* addInfo = NULL);
+            bool OnRequestAndWait(const char* begin, const char* end, void* addInfo);
+
+            /**
+             * Handles the request and sends the response in the calling thread, regardless of the executor.
+             * Deadlines of the calls are counted from now, see CallContext.
+             */
+            bool ProcessRequest(const std::string& request, void* addInfo = NULL);
+            bool ProcessRequest(const char* begin, const char* end, void* addInfo);
+
             void SetHandler(IClientConnectionHandler* handler);
             IClientConnectionHandler* GetHandler();
 
+            /**
+             * Executes requests on a worker pool instead of the thread that received them.
+             * The pool bounds the number of requests handled concurrently. When its queue is full, it either blocks the connector or
+             * refuses the request, which is then answered with ERROR_SERVER_BUSY. The pool is not owned and must be started by the caller.
+             * A request is queued in the lane of its procedure, see Procedure::SetPriority and ThreadPool::SetLaneLimit.
+             * @param executor - the worker pool, NULL to handle requests in the receiving thread.
+             */
+            void SetExecutor(ThreadPool* executor);
+            ThreadPool* GetExecutor();
+
+            /**
+             * Records the receive, write and overall time of requests, see IProtocolHandler::SetMetrics.
+             * Connections accepted before it is set are not timed while receiving. NULL stops recording.
+             */
+            void SetMetrics(RpcMetrics* metrics);
+            RpcMetrics* GetMetrics();
+
+            /**
+             * Bounds the load the connector takes on, so a burst of clients cannot exhaust its threads and memory. Beyond a limit,
+             * work is answered right away with ERROR_SERVER_BUSY instead of being queued:
+             *  - a connection beyond maxConnections is answered and closed by the socket servers as soon as it has been accepted,
+             *  - a request beyond maxRequests or maxBytes, counting the requests received and not answered yet, is not executed,
+             *  - a socket server closes a connection once its unfinished request alone is larger than maxBytes.
+             * Requests an executor refuses are answered the same way, see SetExecutor. Must be called before StartListening.
+             * @param maxConnections, maxRequests, maxBytes - 0 for no limit, the default.
+             */
+            void SetAdmissionLimits(unsigned int maxConnections, unsigned int maxRequests, size_t maxBytes);
+            void GetAdmissionStatistics(AdmissionStatistics& statistics);
+
+            /**
+             * Pushes a JSON-RPC 2.0 notification, with the event as method, to every connection that has subscribed to the event
+             * with rpc.subscribe, see IProtocolHandler::EnableSubscriptions. The notification is written by the calling thread,
+             * unless the connection is writing a response, which then sends it right after. A connection that does not take a
+             * notification within the write timeout of the connector is closed.
+             * @return the number of connections the notification has been sent or queued to.
+             */
+            unsigned int Publish(const std::string& event, const Json::Value& parameters);
+
+            /**
+             * Subscribes the connection whose request the calling thread is processing to an event, or unsubscribes it.
+             * The protocol handler calls it for rpc.subscribe and rpc.unsubscribe. Notifications published later are sent after
+             * the response to the current request. A subscription ends with the connection.
+             * @return false if the thread is not processing a request or the connection cannot receive notifications.
+             */
+            static bool Subscribe(const std::string& event, bool subscribe);
+
+        protected:
+            /**
+             * Same as ProcessRequest, for a request that has been received at RpcMetrics::Now() received. Connectors that queue
+             * requests on a pool of their own pass the time they queued it, so the deadlines of its calls include the wait.
+             */
+            bool ProcessRequest(const char* begin, const char* end, void* addInfo, unsigned long long received);
+
+            /**
+             * Requests handed to the executor are counted, so a connector can wait for them before it releases what addInfo refers to.
+             */
+            void BeginPendingRequest();
+            void EndPendingRequest();
+            void WaitForPendingRequests();
+
+            /**
+             * Connection threads are counted like pending requests and their sockets are tracked, so StopListening() can shut
+             * them down with ShutdownConnections() and wait for the threads with WaitForPendingRequests().
+             * A thread calls ReleaseConnection() before it closes its socket and EndPendingRequest() when it is done with the connector.
+             */
+            void BeginConnection(int fd);
+            /**
+             * Also ends the subscriptions of the connection, connectors that track their sockets pass the socket as addInfo.
+             */
+            void ReleaseConnection(int fd);
+            void ShutdownConnections();
+
+            /**
+             * Records the time since a request started to arrive, as returned by RequestBuffer::GetArrival(). Nothing if it is 0.
+             */
+            void RecordRead(unsigned long long arrival);
+
+            /**
+             * Counts a connection that has been accepted on fd. At the connection limit the connection is answered with
+             * ERROR_SERVER_BUSY, using delimiter to terminate the message, and closed.
+             * @return false if fd has been closed. Otherwise LeaveConnection() has to be called when the connection is closed.
+             */
+            bool AdmitConnection(int fd, char delimiter);
+            void LeaveConnection();
+
+            /**
+             * Counts a request of size bytes that is about to be executed. OnRequest and OnRequestAndWait do it themselves,
+             * connectors that queue requests on a pool of their own call it before and EndRequest() after a request.
+             * @return false beyond the request or byte limit, the request is then answered with RejectRequest().
+             */
+            bool AdmitRequest(size_t size);
+            void EndRequest(size_t size);
+
+            /**
+             * @return false if size bytes of one unfinished request are more than the byte limit allows, the connection should
+             * then be answered with ERROR_SERVER_BUSY and closed.
+             */
+            bool CanBuffer(size_t size);
+
+            /**
+             * Records the length of the accept queue of the listening socket, for connectors that can read it.
+             */
+            void RecordAcceptQueue(unsigned int length, unsigned int backlog);
+
+            /**
+             * Answers a connection whose requests are not read anymore with ERROR_SERVER_BUSY, without id, and shuts down
+             * its sending side. The answer is dropped if it does not fit the socket. The caller closes fd. It counts as a shed request.
+             */
+            void RefuseConnection(int fd, char delimiter);
+
+            /**
+             * The lane the request in [begin, end) is queued in, see IClientConnectionHandler::GetRequestPriority.
+             * Connectors that queue requests on a pool of their own use it like OnRequest does with the executor, and
+             * record the time a request waited with RpcMetrics::StopQueue.
+             */
+            priority_t GetRequestPriority(const char* begin, const char* end);
+
+            /**
+             * Answers a request the executor or the admission limits have refused.
+             */
+            void RejectRequest(const char* begin, const char* end, void* addInfo);
+
+            /**
+             * Connectors that can write to the client while a response is being serialized return a writer for addInfo.
+             * ProcessRequest then streams the response into it and hands it to CloseResponse, instead of building a string for SendResponse.
+             * The default returns NULL.
+             */
+            virtual ResponseWriter* OpenResponse(void* addInfo);
+
+            /**
+             * Terminates and flushes a response written into a writer returned by OpenResponse, then deletes the writer.
+             * Nothing has been written for a request without response.
+             * @return true if the response has been sent completely.
+             */
+            virtual bool CloseResponse(ResponseWriter* writer, void* addInfo);
+
+            /**
+             * Connectors that have switched addInfo's connection to binary framing return true. ProcessRequest then decodes the request
+             * from CBOR, hands the value to IClientConnectionHandler::HandleJsonRequest and passes the encoded response to SendBinaryResponse.
+             * The default returns false.
+             */
+            virtual bool IsBinaryRequest(void* addInfo);
+
+            /**
+             * Sends a CBOR encoded response as one frame, see BinaryFraming. The payload is empty for a request without response.
+             * The default fails.
+             */
+            virtual bool SendBinaryResponse(const std::string& payload, void* addInfo);
+
+            /**
+             * Connectors whose connections outlive a request return true if addInfo's connection can receive notifications
+             * from Publish. addInfo must then identify the connection until RemoveSubscriber() has been called for it.
+             * The default returns false.
+             */
+            virtual bool CanPush(void* addInfo);
+
+            /**
+             * Writes a notification, a text message or the CBOR payload of a frame, to a connection without waiting longer than
+             * the write timeout of the connector. If that fails, the connection must be shut down, so it is released soon.
+             * The default fails.
+             */
+            virtual bool SendPush(const std::string& message, bool binary, void* addInfo);
+
+            /**
+             * Ends the subscriptions of a connection before what addInfo refers to goes away. Waits while a notification
+             * is written to the connection.
+             */
+            void RemoveSubscriber(void* addInfo);
+
+            /**
+             * Connectors that can tell return true once the client has closed addInfo's connection or it has failed, so
+             * CallContext::IsCancelled() lets procedures stop working for a client that is gone. Called by the thread that
+             * processes a request of the connection. The default returns false.
+             */
+            virtual bool IsPeerClosed(void* addInfo);
+
+            /**
+             * Connectors that receive bulk payloads with requests return those of the request addInfo's connection is
+             * processing, for CallContext::GetPayload(). Called by the thread that processes the request. The defaults
+             * report none.
+             */
+            virtual size_t GetPayloadCount(void* addInfo);
+            virtual const BulkPayload* GetPayload(void* addInfo, size_t index);
+
         private:
+            class RequestTask;
+            struct RequestContext;
+            struct Subscriber;
+
+            bool ProcessBinaryRequest(const char* begin, const char* end, RequestContext& context);
+            bool SendJsonResponse(const std::string& response, void* addInfo);
+            void SendBusy(int fd, char delimiter);
+
+            bool IsSubscriber(void* addInfo);
+            void AcquireWriter(RequestContext& context);
+            void ReleaseWriter(RequestContext& context);
+            void SendPushes(void* addInfo);
+
             IClientConnectionHandler *handler;
+            ThreadPool *executor;
+            RpcMetrics *metrics;
+
+            unsigned int pending;
+            pthread_mutex_t pending_lock;
+            pthread_cond_t pending_done;
+            std::set<int> connections;          /*!< The sockets of connection threads, protected by pending_lock*/
+
+            std::map<void*, Subscriber*> subscribers;   /*!< Connections that have subscribed, by addInfo*/
+            unsigned int subscriber_count;      /*!< The size of subscribers, read without the lock*/
+            pthread_mutex_t subscription_lock;  /*!< Protects subscribers*/
+            pthread_cond_t subscription_idle;   /*!< Signaled when a thread stops writing to a subscriber*/
+
+            unsigned int max_connections;
+            unsigned int max_requests;
+            size_t max_bytes;
+            AdmissionStatistics admission;      /*!< Updated with atomic operations*/
     };
 
 } /* namespace jsonrpc */
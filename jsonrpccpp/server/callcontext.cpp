@@ -0,0 +1,94 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    callcontext.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "callcontext.h"
+#include "abstractserverconnector.h"
+#include "rpcmetrics.h"
+#include <pthread.h>
+
+using namespace jsonrpc;
+
+static pthread_once_t current_once = PTHREAD_ONCE_INIT;
+static pthread_key_t current_key;
+
+static void CreateCurrentKey()
+{
+    pthread_key_create(&current_key, NULL);
+}
+
+CallContext::CallContext(AbstractServerConnector *connector, void *addInfo, unsigned long long received) :
+    connector(connector),
+    addInfo(addInfo),
+    received(received),
+    deadline(0)
+{
+}
+
+CallContext::CallContext(const CallContext *parent, long long timeoutMs) :
+    connector(parent != NULL ? parent->connector : NULL),
+    addInfo(parent != NULL ? parent->addInfo : NULL),
+    received(parent != NULL ? parent->received : RpcMetrics::Now()),
+    deadline(0)
+{
+    if (timeoutMs >= 0)
+        this->deadline = this->received + timeoutMs * 1000000ULL;
+    //A call never outlives the deadline of its request.
+    if (parent != NULL && parent->deadline != 0 && (this->deadline == 0 || parent->deadline < this->deadline))
+        this->deadline = parent->deadline;
+}
+
+CallContext* CallContext::GetCurrent()
+{
+    pthread_once(&current_once, CreateCurrentKey);
+    return static_cast<CallContext*>(pthread_getspecific(current_key));
+}
+
+CallContext* CallContext::Enter(CallContext *context)
+{
+    CallContext *previous = GetCurrent();
+    pthread_setspecific(current_key, context);
+    return previous;
+}
+
+bool CallContext::HasDeadline() const
+{
+    return this->deadline != 0;
+}
+
+unsigned long long CallContext::GetDeadline() const
+{
+    return this->deadline;
+}
+
+long long CallContext::GetRemainingMs() const
+{
+    if (this->deadline == 0)
+        return -1;
+    unsigned long long now = RpcMetrics::Now();
+    return now < this->deadline ? static_cast<long long>((this->deadline - now) / 1000000ULL) : 0;
+}
+
+bool CallContext::IsExpired() const
+{
+    return this->deadline != 0 && RpcMetrics::Now() >= this->deadline;
+}
+
+bool CallContext::IsCancelled() const
+{
+    return this->IsExpired() || (this->connector != NULL && this->connector->IsPeerClosed(this->addInfo));
+}
+
+size_t CallContext::GetPayloadCount() const
+{
+    return (this->connector != NULL) ? this->connector->GetPayloadCount(this->addInfo) : 0;
+}
+
+const BulkPayload* CallContext::GetPayload(size_t index) const
+{
+    return (this->connector != NULL) ? this->connector->GetPayload(this->addInfo, index) : NULL;
+}
@@ -0,0 +1,94 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    callcontext.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_CALLCONTEXT_H_
+#define JSONRPC_CPP_CALLCONTEXT_H_
+
+#include <stddef.h>
+
+namespace jsonrpc
+{
+    class AbstractServerConnector;
+    class BulkPayload;
+
+    /**
+     * What a procedure can learn about the call it executes: how long its caller still waits for the result and whether
+     * the caller has given up, so long running work can stop early.
+     *
+     * A connector sets up a context for every request it processes, the protocol handler one for every call of the request
+     * with the deadline the call carries, see KEY_REQUEST_DEADLINE. A procedure finds it with GetCurrent(). It is only valid
+     * until the procedure returns and must not be handed to other threads.
+     */
+    class CallContext
+    {
+        public:
+            /**
+             * @brief The context of a request, without deadline.
+             * @param received - RpcMetrics::Now() when the request had been received completely.
+             */
+            CallContext(AbstractServerConnector* connector, void* addInfo, unsigned long long received);
+
+            /**
+             * @brief The context of a call of the request parent, which may be NULL.
+             * @param timeoutMs - how long the caller waits, counted from when the request was received. Negative for no deadline.
+             */
+            CallContext(const CallContext* parent, long long timeoutMs);
+
+            /**
+             * @return the context of the call the calling thread executes, NULL outside of a request.
+             */
+            static CallContext* GetCurrent();
+
+            /**
+             * @brief Makes context the current one of the calling thread.
+             * @return the previous one, to be restored when context ends.
+             */
+            static CallContext* Enter(CallContext* context);
+
+            bool HasDeadline() const;
+
+            /**
+             * @return the deadline in the clock of RpcMetrics::Now(), 0 without deadline.
+             */
+            unsigned long long GetDeadline() const;
+
+            /**
+             * @return milliseconds until the deadline, 0 once it has passed, -1 without deadline.
+             */
+            long long GetRemainingMs() const;
+
+            bool IsExpired() const;
+
+            /**
+             * @brief Tells whether the result is of no use anymore: the deadline has passed or the client has closed the connection
+             * of the request. Looking at the connection takes a system call, so long running procedures check now and then,
+             * e.g. between chunks of work. Connectors that cannot tell report an open connection.
+             */
+            bool IsCancelled() const;
+
+            /**
+             * @return the number of bulk payloads the client has sent along with the request, see BulkPayload.
+             * Only UnixDomainSocketServer receives them.
+             */
+            size_t GetPayloadCount() const;
+
+            /**
+             * @return the index-th payload of the request in the order the client attached them, mapped read-only. NULL if
+             * there is none or the client has sent a descriptor that is no sealed memfd. Valid until the procedure returns.
+             */
+            const BulkPayload* GetPayload(size_t index) const;
+
+        private:
+            AbstractServerConnector *connector;
+            void *addInfo;
+            unsigned long long received;
+            unsigned long long deadline;
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_CALLCONTEXT_H_ */
@@ -8,7 +8,11 @@
  ************************************************************************/
 
 #include "filedescriptorserver.h"
-#include <sys/select.h>
+#include "../requestbuffer.h"
+#include <poll.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/eventfd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -22,11 +26,19 @@ using namespace std;
 #ifndef DELIMITER_CHAR
 #define DELIMITER_CHAR char(0x0A)
 #endif
-#define READ_TIMEOUT 0.2 // Set timeout in seconds
 
 FileDescriptorServer::FileDescriptorServer(int inputfd, int outputfd) :
   running(false), inputfd(inputfd), outputfd(outputfd)
 {
+  this->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  pthread_mutex_init(&write_lock, NULL);
+}
+
+FileDescriptorServer::~FileDescriptorServer()
+{
+  if (this->wakeup_fd >= 0)
+    close(this->wakeup_fd);
+  pthread_mutex_destroy(&write_lock);
 }
 
 bool FileDescriptorServer::StartListening()
@@ -34,9 +46,14 @@ bool FileDescriptorServer::StartListening()
   if(this->running)
     return false;
 
-  if (!IsReadable(inputfd) || !IsWritable(outputfd))
+  if (!IsReadable(inputfd) || !IsWritable(outputfd) || this->wakeup_fd < 0)
     return false;
 
+  // Forget a wakeup left from a previous StopListening.
+  uint64_t count;
+  ssize_t drained = read(this->wakeup_fd, &count, sizeof(count));
+  (void)drained;
+
   this->running = true;
   int ret = pthread_create(&(this->listenning_thread), NULL, FileDescriptorServer::LaunchLoop, this);
   this->running = static_cast<bool>(ret == 0);
@@ -49,7 +66,11 @@ bool FileDescriptorServer::StopListening()
   if (!this->running)
     return false;
   this->running = false;
+  uint64_t one = 1;
+  ssize_t ret = write(this->wakeup_fd, &one, sizeof(one));
+  (void)ret;
   pthread_join(this->listenning_thread, NULL);
+  this->WaitForPendingRequests();
   return !(this->running);
 }
 
@@ -70,11 +91,13 @@ bool FileDescriptorServer::SendResponse(const string& response, void* addInfo)
 
   ssize_t result = 0;
   ssize_t nbytes = toSend.size();
+  pthread_mutex_lock(&write_lock);
   do
   {
     result = write(outputfd, &(toSend.c_str()[toSend.size() - nbytes]), toSend.size() - result);
     nbytes -= result;
   } while (result && nbytes); // While we are still writing and there is still to write
+  pthread_mutex_unlock(&write_lock);
   return result != 0;
 }
 
@@ -87,44 +110,44 @@ void* FileDescriptorServer::LaunchLoop(void *p_data)
 
 void FileDescriptorServer::ListenLoop()
 {
+  RequestBuffer buffer(DELIMITER_CHAR);
+  buffer.SetTimed(this->GetMetrics() != NULL);
+  const char *begin, *end;
+  struct pollfd fds[2];
+  fds[0].fd = inputfd;
+  fds[0].events = POLLIN;
+  fds[1].fd = this->wakeup_fd;
+  fds[1].events = POLLIN;
   while (this->running)
   {
-    char buffer[BUFFER_SIZE];
-    ssize_t nbytes;
-    string request;
-    do
+    // Requests that arrived together are handled before the input is read again.
+    if (buffer.Next(begin, end))
     {
-      // Wait for something to be read.
-      // Interrupt after a timeout to check it we should still wait or just stop.
-      int wait_ret = 0;
-      if ((wait_ret = this->WaitForRead()) > 0 && FD_ISSET(inputfd, &read_fds))
-      {
-        this->running = (nbytes = read(inputfd, buffer, BUFFER_SIZE)) != 0;
-        request.append(buffer, nbytes);
-      } else {
-        if (wait_ret < 0) {
-          // File closed
-          this->running = false;
-          break;
-        }
-      }
-    } while (this->running && request.find(DELIMITER_CHAR) == string::npos);
-    if (this->running) { // False if either the input fd was closed or someone interrupted us with ::StopListening.
-      this->OnRequest(request, NULL);
+      this->RecordRead(buffer.GetArrival());
+      this->OnRequest(begin, end, NULL);
+      continue;
     }
-  }
-}
 
-int FileDescriptorServer::WaitForRead() {
-  // Has to be reset after every call, as POSIX allow the value to be modifiable by the system.
-  FD_ZERO(&read_fds);
-  FD_ZERO(&write_fds);
-  FD_ZERO(&except_fds);
-  FD_SET(inputfd, &read_fds);
-  timeout.tv_sec = 0;
-  timeout.tv_usec = (suseconds_t) (READ_TIMEOUT * 1000000);
-  // Wait for something to read
-  return select(inputfd + 1, &read_fds, &write_fds, &except_fds, &timeout);
+    // Wait without timeout, StopListening wakes us through the eventfd.
+    if (poll(fds, 2, -1) < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      this->running = false;
+      break;
+    }
+    if (fds[1].revents != 0)
+      break;
+    if (fds[0].revents == 0)
+      continue;
+
+    char *space = buffer.Reserve(BUFFER_SIZE);
+    ssize_t nbytes = read(inputfd, space, buffer.Available());
+    if (nbytes > 0)
+      buffer.Commit(nbytes);
+    else if (nbytes == 0 || (errno != EINTR && errno != EAGAIN))
+      this->running = false; // The input fd was closed.
+  }
 }
 
 bool FileDescriptorServer::IsReadable(int fd)
@@ -12,7 +12,6 @@
 
 #include <string>
 #include <pthread.h>
-#include <sys/select.h>
 
 #include "../abstractserverconnector.h"
 
@@ -21,7 +20,8 @@ namespace jsonrpc
   /**
    * This class is the file descriptor implementation of an AbstractServerConnector.
    * It uses the POSIX file API and POSIX thread API to performs its job.
-   * Each client request is handled in a new thread.
+   * A listening thread blocks in poll() on the input and on an eventfd that StopListening() signals,
+   * several requests received in one read are handled one after the other.
    */
   class FileDescriptorServer: public AbstractServerConnector
   {
@@ -32,6 +32,7 @@ namespace jsonrpc
        * @param outputfd The file descriptor already open for us to write
        */
       FileDescriptorServer(int inputfd, int outputfd);
+      virtual ~FileDescriptorServer();
       /**
        * This method launches the listening loop that will handle client connections.
        * @return true if the file is readable, false otherwise.
@@ -43,7 +44,8 @@ namespace jsonrpc
        */
       bool StopListening();
       /**
-       * This method sends the result of the RPC Call over the output file
+       * This method sends the result of the RPC Call over the output file.
+       * Responses of requests executed concurrently by an executor are written one at a time.
        * @param response The response to send to the client
        * @param addInfo Additionnal parameters
        * @return A boolean that indicates the success or the failure of the operation.
@@ -59,21 +61,15 @@ namespace jsonrpc
       bool running;
       int inputfd;
       int outputfd;
-
-      // For select operation
-      fd_set read_fds;
-      fd_set write_fds;
-      fd_set except_fds;
-      struct timeval timeout;
+      int wakeup_fd;              /*!< eventfd that interrupts the poll() of the listening thread*/
 
       pthread_t listenning_thread;
+      pthread_mutex_t write_lock;
 
       static void* LaunchLoop(void *p_data);
       void ListenLoop();
       bool IsReadable(int fd);
       bool IsWritable(int fd);
-
-      int WaitForRead();
   };
 }
 
@@ -9,23 +9,97 @@
 
 #include "httpserver.h"
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <iostream>
+#include <new>
 #include <jsonrpccpp/common/specificationparser.h>
+#include "../requestbuffer.h"
 
 using namespace jsonrpc;
 using namespace std;
 
 #define BUFFERSIZE 65536
+#define MAX_POOLED_BUFFERSIZE (1024 * 1024)
 
 struct mhd_coninfo {
         struct MHD_PostProcessor *postprocessor;
         MHD_Connection* connection;
-        stringstream request;
+        RequestBuffer* request;     /*!< The body received so far, NULL until the first chunk*/
         HttpServer* server;
         int code;
 };
 
+/**
+ * Collects a response in memory allocated with malloc, so libmicrohttpd can send it without a copy and free it.
+ */
+class MallocResponseBuffer : public std::streambuf
+{
+    public:
+        MallocResponseBuffer() :
+            data(NULL),
+            capacity(0)
+        {
+        }
+
+        ~MallocResponseBuffer()
+        {
+            free(this->data);
+        }
+
+        /**
+         * @brief Hands the response over to the caller, who has to free it.
+         */
+        char* Release(size_t &size)
+        {
+            char *result = this->data;
+            size = this->pptr() - this->pbase();
+            this->data = NULL;
+            this->capacity = 0;
+            this->setp(NULL, NULL);
+            return result;
+        }
+
+    protected:
+        int_type overflow(int_type c)
+        {
+            if (traits_type::eq_int_type(c, traits_type::eof()))
+                return traits_type::not_eof(c);
+            this->Grow(1);
+            *this->pptr() = traits_type::to_char_type(c);
+            this->pbump(1);
+            return c;
+        }
+
+        std::streamsize xsputn(const char *s, std::streamsize n)
+        {
+            if (this->epptr() - this->pptr() < n)
+                this->Grow(n);
+            memcpy(this->pptr(), s, n);
+            this->pbump(static_cast<int>(n));
+            return n;
+        }
+
+    private:
+        char *data;
+        size_t capacity;
+
+        void Grow(size_t needed)
+        {
+            size_t size = this->pptr() - this->pbase();
+            size_t capacity = this->capacity > 0 ? this->capacity : BUFFERSIZE;
+            while (capacity - size < needed)
+                capacity *= 2;
+            char *grown = static_cast<char*>(realloc(this->data, capacity));
+            if (grown == NULL)
+                throw std::bad_alloc();
+            this->data = grown;
+            this->capacity = capacity;
+            this->setp(this->data, this->data + capacity);
+            this->pbump(static_cast<int>(size));
+        }
+};
+
 HttpServer::HttpServer(int port, const std::string &sslcert, const std::string &sslkey, int threads) :
     AbstractServerConnector(),
     port(port),
@@ -35,6 +109,15 @@ HttpServer::HttpServer(int port, const std::string &sslcert, const std::string &
     path_sslkey(sslkey),
     daemon(NULL)
 {
+    pthread_mutex_init(&this->buffers_lock, NULL);
+}
+
+HttpServer::~HttpServer()
+{
+    this->StopListening();
+    for (size_t i = 0; i < this->buffers.size(); i++)
+        delete this->buffers[i];
+    pthread_mutex_destroy(&this->buffers_lock);
 }
 
 IClientConnectionHandler *HttpServer::GetHandler(const std::string &url)
@@ -66,7 +149,7 @@ bool HttpServer::StartListening()
                 SpecificationParser::GetFileContent(this->path_sslcert, this->sslcert);
                 SpecificationParser::GetFileContent(this->path_sslkey, this->sslkey);
 
-                this->daemon = MHD_start_daemon(MHD_USE_SSL | mhd_flags, this->port, NULL, NULL, HttpServer::callback, this, MHD_OPTION_HTTPS_MEM_KEY, this->sslkey.c_str(), MHD_OPTION_HTTPS_MEM_CERT, this->sslcert.c_str(), MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_END);
+                this->daemon = MHD_start_daemon(MHD_USE_SSL | mhd_flags, this->port, NULL, NULL, HttpServer::callback, this, MHD_OPTION_HTTPS_MEM_KEY, this->sslkey.c_str(), MHD_OPTION_HTTPS_MEM_CERT, this->sslcert.c_str(), MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_NOTIFY_COMPLETED, HttpServer::completed, this, MHD_OPTION_END);
             }
             catch (JsonRpcException& ex)
             {
@@ -75,7 +158,7 @@ bool HttpServer::StartListening()
         }
         else
         {
-            this->daemon = MHD_start_daemon(mhd_flags, this->port, NULL, NULL, HttpServer::callback, this,   MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_END);
+            this->daemon = MHD_start_daemon(mhd_flags, this->port, NULL, NULL, HttpServer::callback, this,   MHD_OPTION_THREAD_POOL_SIZE, this->threads, MHD_OPTION_NOTIFY_COMPLETED, HttpServer::completed, this, MHD_OPTION_END);
         }
         if (this->daemon != NULL)
             this->running = true;
@@ -107,6 +190,24 @@ bool HttpServer::SendResponse(const string& response, void* addInfo)
     return ret == MHD_YES;
 }
 
+bool HttpServer::SendBuffer(char* data, size_t size, void* addInfo)
+{
+    struct mhd_coninfo* client_connection = static_cast<struct mhd_coninfo*>(addInfo);
+    struct MHD_Response *result = MHD_create_response_from_buffer(size, data, MHD_RESPMEM_MUST_FREE);
+    if (result == NULL)
+    {
+        free(data);
+        return false;
+    }
+
+    MHD_add_response_header(result, "Content-Type", "application/json");
+    MHD_add_response_header(result, "Access-Control-Allow-Origin", "*");
+
+    int ret = MHD_queue_response(client_connection->connection, client_connection->code, result);
+    MHD_destroy_response(result);
+    return ret == MHD_YES;
+}
+
 bool HttpServer::SendOptionsResponse(void* addInfo)
 {
     struct mhd_coninfo* client_connection = static_cast<struct mhd_coninfo*>(addInfo);
@@ -135,6 +236,7 @@ int HttpServer::callback(void *cls, MHD_Connection *connection, const char *url,
     {
         struct mhd_coninfo* client_connection = new mhd_coninfo;
         client_connection->connection = connection;
+        client_connection->request = NULL;
         client_connection->server = static_cast<HttpServer*>(cls);
         *con_cls = client_connection;
         return MHD_YES;
@@ -145,13 +247,26 @@ int HttpServer::callback(void *cls, MHD_Connection *connection, const char *url,
     {
         if (*upload_data_size != 0)
         {
-            client_connection->request.write(upload_data, *upload_data_size);
+            if (client_connection->request == NULL)
+            {
+                client_connection->request = client_connection->server->AcquireBuffer();
+                //A body of announced size fits without growing as long as it could be pooled. The announcement is not
+                //trusted beyond that, a client could claim a large body and never send it, the buffer grows as data arrives.
+                const char *length = MHD_lookup_connection_value(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_CONTENT_LENGTH);
+                if (length != NULL)
+                {
+                    unsigned long announced = strtoul(length, NULL, 10);
+                    client_connection->request->Reserve(announced < MAX_POOLED_BUFFERSIZE ? announced : MAX_POOLED_BUFFERSIZE);
+                }
+            }
+            char *space = client_connection->request->Reserve(*upload_data_size);
+            memcpy(space, upload_data, *upload_data_size);
+            client_connection->request->Commit(*upload_data_size);
             *upload_data_size = 0;
             return MHD_YES;
         }
         else
         {
-            string response;
             IClientConnectionHandler* handler = client_connection->server->GetHandler(string(url));
             if (handler == NULL)
             {
@@ -160,9 +275,18 @@ int HttpServer::callback(void *cls, MHD_Connection *connection, const char *url,
             }
             else
             {
+                const char *begin = "";
+                const char *end = begin;
+                if (client_connection->request != NULL)
+                    client_connection->request->TakeAll(begin, end);
+
+                MallocResponseBuffer buffer;
+                ostream response(&buffer);
+                handler->HandleRequest(begin, end, response);
+                size_t size = 0;
+                char *data = buffer.Release(size);
                 client_connection->code = MHD_HTTP_OK;
-                handler->HandleRequest(client_connection->request.str(), response);
-                client_connection->server->SendResponse(response, client_connection);
+                client_connection->server->SendBuffer(data, size, client_connection);
             }
         }
     }
@@ -175,9 +299,57 @@ int HttpServer::callback(void *cls, MHD_Connection *connection, const char *url,
         client_connection->code = MHD_HTTP_METHOD_NOT_ALLOWED;
         client_connection->server->SendResponse("Not allowed HTTP Method", client_connection);
     }
+    if (client_connection->request != NULL)
+        client_connection->server->ReleaseBuffer(client_connection->request);
     delete client_connection;
     *con_cls = NULL;
 
     return MHD_YES;
 }
 
+void HttpServer::completed(void *cls, MHD_Connection *connection, void **con_cls, enum MHD_RequestTerminationCode toe)
+{
+    (void)cls;
+    (void)connection;
+    (void)toe;
+    //Only set if the request was aborted before the callback could answer it.
+    struct mhd_coninfo* client_connection = static_cast<struct mhd_coninfo*>(*con_cls);
+    if (client_connection == NULL)
+        return;
+    if (client_connection->request != NULL)
+        client_connection->server->ReleaseBuffer(client_connection->request);
+    delete client_connection;
+    *con_cls = NULL;
+}
+
+RequestBuffer *HttpServer::AcquireBuffer()
+{
+    RequestBuffer *buffer = NULL;
+    pthread_mutex_lock(&this->buffers_lock);
+    if (!this->buffers.empty())
+    {
+        buffer = this->buffers.back();
+        this->buffers.pop_back();
+    }
+    pthread_mutex_unlock(&this->buffers_lock);
+    if (buffer == NULL)
+        buffer = new RequestBuffer('\n', BUFFERSIZE);
+    return buffer;
+}
+
+void HttpServer::ReleaseBuffer(RequestBuffer *buffer)
+{
+    buffer->Clear();
+    //Buffers grown by an unusually large request are not kept, one per worker thread is enough.
+    bool keep = false;
+    pthread_mutex_lock(&this->buffers_lock);
+    if (buffer->Capacity() <= MAX_POOLED_BUFFERSIZE && this->buffers.size() < static_cast<size_t>(this->threads))
+    {
+        this->buffers.push_back(buffer);
+        keep = true;
+    }
+    pthread_mutex_unlock(&this->buffers_lock);
+    if (!keep)
+        delete buffer;
+}
+
@@ -26,16 +26,21 @@ typedef intptr_t ssize_t;
 #endif
 
 #include <map>
+#include <vector>
 #include <microhttpd.h>
 #include "../abstractserverconnector.h"
 
 namespace jsonrpc
 {
+    class RequestBuffer;
+
     /**
      * This class provides an embedded HTTP Server, based on libmicrohttpd, to handle incoming Requests and send HTTP 1.1
      * valid responses.
      * Note that this class will always send HTTP-Status 200, even though an JSON-RPC Error might have occurred. Please
      * always check for the JSON-RPC Error Header.
+     * Request bodies are collected in receive buffers that are reused across requests and parsed in place, responses are
+     * serialized into the memory libmicrohttpd sends from.
      */
     class HttpServer: public AbstractServerConnector
     {
@@ -48,6 +53,7 @@ namespace jsonrpc
              * @param sslcert - defines the path to a SSL certificate, if this path is != "", then SSL/HTTPS is used with the given certificate.
              */
             HttpServer(int port, const std::string& sslcert = "", const std::string& sslkey = "", int threads = 50);
+            virtual ~HttpServer();
 
             virtual bool StartListening();
             virtual bool StopListening();
@@ -71,10 +77,22 @@ namespace jsonrpc
 
             std::map<std::string, IClientConnectionHandler*> urlhandler;
 
+            std::vector<RequestBuffer*> buffers;    /*!< Idle receive buffers for request bodies*/
+            pthread_mutex_t buffers_lock;
+
             static int callback(void *cls, struct MHD_Connection *connection, const char *url, const char *method, const char *version, const char *upload_data, size_t *upload_data_size, void **con_cls);
+            static void completed(void *cls, struct MHD_Connection *connection, void **con_cls, enum MHD_RequestTerminationCode toe);
 
             IClientConnectionHandler* GetHandler(const std::string &url);
 
+            /**
+             * @brief Sends a response body allocated with malloc, libmicrohttpd frees it once it has been sent.
+             */
+            bool SendBuffer(char* data, size_t size, void* addInfo);
+
+            RequestBuffer* AcquireBuffer();
+            void ReleaseBuffer(RequestBuffer* buffer);
+
     };
 
 } /* namespace jsonrpc */
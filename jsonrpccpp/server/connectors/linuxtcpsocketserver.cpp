@@ -15,33 +15,203 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sched.h>
 
 #include <sstream>
 #include <iostream>
 #include <string>
+#include <set>
 
 #include <jsonrpccpp/common/specificationparser.h>
+#include <jsonrpccpp/common/cbor.h>
+#include "../requestbuffer.h"
 
 #include <errno.h>
 
 using namespace jsonrpc;
 using namespace std;
 
-#define BUFFER_SIZE 64
+#define BUFFER_SIZE 1024
 #ifndef DELIMITER_CHAR
 #define DELIMITER_CHAR char(0x0A)
 #endif //DELIMITER_CHAR
 
+#define REACTOR_BUFFER_SIZE 4096
+#define REACTOR_MAX_EVENTS 64
+#define REACTOR_TICK_MS 50
+#define REACTOR_DRAIN_TIMEOUT_US 100000
+#define REACTOR_WRITE_TIMEOUT_MS 1000
+#define PUSH_WRITE_TIMEOUT_MS 1000
+
+/**
+ * A client connection in reactor mode. It is owned by its event loop thread: only that thread
+ * registers, reads, closes and deletes it. While busy is set a worker borrows it to write the response.
+ */
+struct LinuxTcpSocketServer::ReactorConnection
+{
+	ReactorConnection() :
+		input(DELIMITER_CHAR, REACTOR_BUFFER_SIZE)
+	{
+	}
+
+	int fd;
+	EventLoop *loop;
+	RequestBuffer input;            /*!< Bytes received and not yet dispatched, a busy worker reads its request in place*/
+	bool stalled;                   /*!< Reading stopped because input could not grow while busy*/
+	bool busy;                      /*!< A worker is executing a request of this connection*/
+	bool answered;                  /*!< The response has been sent, the client is expected to close*/
+	bool peerClosed;                /*!< The client closed its side or the connection failed*/
+	bool onLoop;                    /*!< The loop thread is writing, it must not wait for the socket*/
+	bool broken;                    /*!< A message written by the loop did not fit the socket, the connection is reset*/
+	struct timeval answeredAt;
+};
+
+struct LinuxTcpSocketServer::EventLoop
+{
+	unsigned int index;
+	int epoll_fd;
+	int wakeup_fd;                  /*!< eventfd used to interrupt epoll_wait*/
+	int listen_fd;                  /*!< The listening socket the loop accepts on, -1 if it has none*/
+	int reserve_fd;                 /*!< Kept open to accept and close a connection when descriptors run out, -1 if none*/
+	pthread_t thread;
+	LinuxTcpSocketServer *instance;
+	set<ReactorConnection*> connections; /*!< Connections owned by this loop, only touched by its thread*/
+	pthread_mutex_t lock;           /*!< Protects incoming and finished*/
+	vector<ReactorConnection*> incoming; /*!< Connections accepted by another loop*/
+	vector<ReactorConnection*> finished; /*!< Connections whose request a worker has completed*/
+};
+
+class LinuxTcpSocketServer::ReactorTask : public IThreadPoolTask
+{
+	public:
+		ReactorTask(LinuxTcpSocketServer *instance, ReactorConnection *connection, const char *begin, const char *end) :
+			instance(instance),
+			connection(connection),
+			begin(begin),
+			end(end),
+			priority(instance->GetRequestPriority(begin, end)),
+			queued(RpcMetrics::Start(instance->GetMetrics())),
+			received(RpcMetrics::Now())
+		{
+		}
+
+		priority_t GetPriority() const
+		{
+			return priority;
+		}
+
+		void Run()
+		{
+			RpcMetrics::StopQueue(instance->GetMetrics(), priority, queued);
+			instance->ProcessRequest(begin, end, connection, received);
+			instance->EndRequest(end - begin);
+			instance->FinishRequest(connection);
+			instance->EndPendingRequest();
+		}
+
+	private:
+		LinuxTcpSocketServer *instance;
+		ReactorConnection *connection;
+		const char *begin;
+		const char *end;
+		priority_t priority;
+		unsigned long long queued;
+		unsigned long long received;
+};
+
+static void WakeEventLoop(int wakeup_fd)
+{
+	uint64_t one = 1;
+	ssize_t ret = write(wakeup_fd, &one, sizeof(one));
+	(void)ret;
+}
+
 LinuxTcpSocketServer::LinuxTcpSocketServer(const std::string& ipToBind, const unsigned int &port) :
     AbstractServerConnector(),
     running(false),
 	ipToBind(ipToBind),
-    port(port)
+    port(port),
+	reactor(false),
+	reactor_loops(1),
+	reactor_workers(4),
+	reactor_queue(64),
+	pool(NULL),
+	own_pool(NULL),
+	next_loop(0),
+	keepAlive(false),
+	binaryFraming(false),
+	backlog(5),
+	reusePort(false),
+	pinLoops(false)
 {
+	pthread_mutex_init(&(this->binary_lock), NULL);
 }
 
 LinuxTcpSocketServer::~LinuxTcpSocketServer()
 {
+	if(this->running && this->reactor)
+	{
+		this->StopListening();
+	}
+	pthread_mutex_destroy(&(this->binary_lock));
+}
+
+bool LinuxTcpSocketServer::SetReactorMode(unsigned int loops, unsigned int workers, unsigned int maxQueued)
+{
+	if(this->running)
+	{
+		return false;
+	}
+	this->reactor = true;
+	this->reactor_loops = loops > 0 ? loops : 1;
+	this->reactor_workers = workers > 0 ? workers : 1;
+	this->reactor_queue = maxQueued > 0 ? maxQueued : 1;
+	return true;
+}
+
+bool LinuxTcpSocketServer::SetKeepAlive(bool keepAlive)
+{
+	if(this->running)
+	{
+		return false;
+	}
+	this->keepAlive = keepAlive;
+	return true;
+}
+
+bool LinuxTcpSocketServer::SetBinaryFraming(bool allow)
+{
+	if(this->running)
+	{
+		return false;
+	}
+	this->binaryFraming = allow;
+	return true;
+}
+
+bool LinuxTcpSocketServer::SetListenBacklog(unsigned int backlog)
+{
+	if(this->running)
+	{
+		return false;
+	}
+	this->backlog = backlog > 0 ? backlog : 1;
+	return true;
+}
+
+bool LinuxTcpSocketServer::SetReusePort(bool reusePort, bool pinLoops)
+{
+	if(this->running)
+	{
+		return false;
+	}
+	this->reusePort = reusePort;
+	this->pinLoops = pinLoops;
+	return true;
 }
 
 bool LinuxTcpSocketServer::StartListening()
@@ -50,31 +220,14 @@ bool LinuxTcpSocketServer::StartListening()
 	{
 		//Create and bind socket here.
 		//Then launch the listenning loop.
-		this->socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+		this->socket_fd = this->OpenListeningSocket(this->reactor && this->reusePort);
 		if(this->socket_fd < 0)
 		{
 			return false;
 		}
-
-		fcntl(this->socket_fd, F_SETFL, FNDELAY);
-		int reuseaddr = 1;
-		setsockopt(this->socket_fd, SOL_SOCKET, SO_REUSEADDR, &reuseaddr, sizeof(reuseaddr));
-
-		/* start with a clean address structure */
-		memset(&(this->address), 0, sizeof(struct sockaddr_in));
-
-		this->address.sin_family = AF_INET;
-		inet_aton(this->ipToBind.c_str(), &(this->address.sin_addr));
-		this->address.sin_port = htons(this->port);
-
-		if(bind(this->socket_fd, reinterpret_cast<struct sockaddr *>(&(this->address)), sizeof(struct sockaddr_in)) != 0)
-		{
-			return false;
-		}
-
-		if(listen(this->socket_fd, 5) != 0)
+		if(this->reactor)
 		{
-			return false;
+			return this->StartReactor();
 		}
 		//Launch listening loop there
 		this->running = true;
@@ -94,14 +247,53 @@ bool LinuxTcpSocketServer::StartListening()
 	}
 }
 
+int LinuxTcpSocketServer::OpenListeningSocket(bool reusePort)
+{
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if(fd < 0)
+	{
+		return -1;
+	}
+
+	fcntl(fd, F_SETFL, FNDELAY);
+	int reuseaddr = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuseaddr, sizeof(reuseaddr));
+	if(reusePort && setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &reuseaddr, sizeof(reuseaddr)) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	/* start with a clean address structure */
+	memset(&(this->address), 0, sizeof(struct sockaddr_in));
+
+	this->address.sin_family = AF_INET;
+	inet_aton(this->ipToBind.c_str(), &(this->address.sin_addr));
+	this->address.sin_port = htons(this->port);
+
+	if(bind(fd, reinterpret_cast<struct sockaddr *>(&(this->address)), sizeof(struct sockaddr_in)) != 0 || listen(fd, this->backlog) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
 bool LinuxTcpSocketServer::StopListening()
 {
-	if(this->running)
+	if(this->running && this->reactor)
+	{
+		this->StopReactor();
+		return true;
+	}
+	else if(this->running)
 	{
 		this->running = false;
 		pthread_join(this->listenning_thread, NULL);
 		shutdown(this->socket_fd, 2);
 		close(this->socket_fd);
+		this->ShutdownConnections();
+		this->WaitForPendingRequests();
 		return !(this->running);
 	}
 	else
@@ -112,32 +304,105 @@ bool LinuxTcpSocketServer::StopListening()
 
 bool LinuxTcpSocketServer::SendResponse(const string& response, void* addInfo)
 {
-	bool result = false;
+	if(this->reactor)
+	{
+		ReactorConnection *connection = reinterpret_cast<ReactorConnection*>(addInfo);
+		return this->SendOnConnection(connection, SocketResponseWriter::SendMessage(connection->fd, response, DELIMITER_CHAR, GetWriteTimeout(connection)));
+	}
 	int connection_fd = reinterpret_cast<intptr_t>(addInfo);
+	bool result = SocketResponseWriter::SendMessage(connection_fd, response, DELIMITER_CHAR);
+	if(!this->keepAlive)
+	{
+		CleanClose(connection_fd);
+	}
+	return result;
+}
 
-	string temp = response;
-	if(temp.find(DELIMITER_CHAR) == string::npos)
+ResponseWriter* LinuxTcpSocketServer::OpenResponse(void* addInfo)
+{
+	if(this->reactor)
 	{
-		temp.append(1, DELIMITER_CHAR);
+		return new SocketResponseWriter(reinterpret_cast<ReactorConnection*>(addInfo)->fd, REACTOR_WRITE_TIMEOUT_MS);
 	}
-	if(DELIMITER_CHAR != '\n')
+	return new SocketResponseWriter(reinterpret_cast<intptr_t>(addInfo));
+}
+
+bool LinuxTcpSocketServer::CloseResponse(ResponseWriter* writer, void* addInfo)
+{
+	writer->sputc(DELIMITER_CHAR);
+	bool result = writer->Flush();
+	delete writer;
+	if(!this->reactor && !this->keepAlive)
 	{
-		char eot = DELIMITER_CHAR;
-		string toSend = temp.substr(0, toSend.find_last_of('\n'));
-		toSend += eot;
-		result = this->WriteToSocket(connection_fd, toSend);
+		CleanClose(reinterpret_cast<intptr_t>(addInfo));
 	}
-	else
+	return result;
+}
+
+bool LinuxTcpSocketServer::IsBinaryRequest(void* addInfo)
+{
+	if(this->reactor)
 	{
-		result = this->WriteToSocket(connection_fd, temp);
+		return reinterpret_cast<ReactorConnection*>(addInfo)->input.IsFramed();
+	}
+	pthread_mutex_lock(&(this->binary_lock));
+	bool binary = this->binary_fds.count(reinterpret_cast<intptr_t>(addInfo)) > 0;
+	pthread_mutex_unlock(&(this->binary_lock));
+	return binary;
+}
+
+bool LinuxTcpSocketServer::SendBinaryResponse(const string& payload, void* addInfo)
+{
+	//Binary framing implies keep-alive, the connection is never closed after a response.
+	if(this->reactor)
+	{
+		ReactorConnection *connection = reinterpret_cast<ReactorConnection*>(addInfo);
+		return this->SendOnConnection(connection, SocketResponseWriter::SendFrame(connection->fd, payload, GetWriteTimeout(connection)));
+	}
+	return SocketResponseWriter::SendFrame(reinterpret_cast<intptr_t>(addInfo), payload);
+}
+
+bool LinuxTcpSocketServer::CanPush(void* addInfo)
+{
+	(void)addInfo;
+	return this->keepAlive;
+}
+
+bool LinuxTcpSocketServer::SendPush(const string& message, bool binary, void* addInfo)
+{
+	int fd = this->reactor ? reinterpret_cast<ReactorConnection*>(addInfo)->fd : reinterpret_cast<intptr_t>(addInfo);
+	bool result = binary ? SocketResponseWriter::SendFrame(fd, message, PUSH_WRITE_TIMEOUT_MS)
+	                     : SocketResponseWriter::SendMessage(fd, message, DELIMITER_CHAR, PUSH_WRITE_TIMEOUT_MS);
+	if(!result)
+	{
+		//A client that does not read its notifications is dropped, its reader sees the shutdown and releases the connection.
+		shutdown(fd, SHUT_RDWR);
 	}
-	CleanClose(connection_fd);
 	return result;
 }
 
+bool LinuxTcpSocketServer::IsPeerClosed(void* addInfo)
+{
+	//POLLRDHUP reports the shutdown of the client while its requests are still unread.
+	struct pollfd pfd;
+	pfd.fd = this->reactor ? reinterpret_cast<ReactorConnection*>(addInfo)->fd : reinterpret_cast<intptr_t>(addInfo);
+	pfd.events = POLLRDHUP;
+	pfd.revents = 0;
+	return poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLRDHUP | POLLHUP | POLLERR)) != 0;
+}
+
+void LinuxTcpSocketServer::SetBinaryConnection(int fd, bool binary)
+{
+	pthread_mutex_lock(&(this->binary_lock));
+	if(binary)
+		this->binary_fds.insert(fd);
+	else
+		this->binary_fds.erase(fd);
+	pthread_mutex_unlock(&(this->binary_lock));
+}
+
 void* LinuxTcpSocketServer::LaunchLoop(void *p_data)
 {
-	pthread_detach(pthread_self());
 	LinuxTcpSocketServer *instance = reinterpret_cast<LinuxTcpSocketServer*>(p_data);;
 	instance->ListenLoop();
 	return NULL;
@@ -153,17 +418,27 @@ void LinuxTcpSocketServer::ListenLoop()
 	{
 		if((connection_fd = accept(this->socket_fd, reinterpret_cast<struct sockaddr *>(&(connection_address)),  &address_length)) > 0)
 		{
+			//Only when a client has come, an idle server would ask for TCP_INFO on every poll of the socket.
+			this->SampleAcceptQueue(this->socket_fd);
+			if(!this->AdmitConnection(connection_fd, DELIMITER_CHAR))
+			{
+				continue;
+			}
 			pthread_t client_thread;
 			struct GenerateResponseParameters *params = new struct GenerateResponseParameters();
 			params->instance = this;
 			params->connection_fd = connection_fd;
+			this->BeginConnection(connection_fd);
 			int ret = pthread_create(&client_thread, NULL, LinuxTcpSocketServer::GenerateResponse, params);
 			if(ret != 0)
 			{
 				pthread_detach(client_thread);
 				delete params;
 				params = NULL;
+				this->ReleaseConnection(connection_fd);
 				CleanClose(connection_fd);
+				this->LeaveConnection();
+				this->EndPendingRequest();
 			}
 		}
 		else
@@ -173,6 +448,17 @@ void LinuxTcpSocketServer::ListenLoop()
 	}
 }
 
+void LinuxTcpSocketServer::SampleAcceptQueue(int fd)
+{
+	//For a listening socket TCP_INFO reports the length of the accept queue and the backlog.
+	struct tcp_info info;
+	socklen_t length = sizeof(info);
+	if(getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &length) == 0)
+	{
+		this->RecordAcceptQueue(info.tcpi_unacked, info.tcpi_sacked);
+	}
+}
+
 void* LinuxTcpSocketServer::GenerateResponse(void *p_data)
 {
 	pthread_detach(pthread_self());
@@ -182,51 +468,86 @@ void* LinuxTcpSocketServer::GenerateResponse(void *p_data)
 	delete params;
 	params = NULL;
 	int nbytes;
-	char buffer[BUFFER_SIZE];
-	string request;
-	do
+	RequestBuffer buffer(DELIMITER_CHAR);
+	buffer.SetTimed(instance->GetMetrics() != NULL);
+	const char *begin, *end;
+	while(true)
 	{ //The client sends its json formatted request and a delimiter request.
-		nbytes = recv(connection_fd, buffer, BUFFER_SIZE, 0);
-		if(nbytes == -1)
+		if(!buffer.Next(begin, end))
 		{
-			instance->CleanClose(connection_fd);
-			return NULL;
+			if(buffer.NextFrameSize() > BinaryFraming::MAX_PAYLOAD_SIZE)
+			{
+				//No request is that large, the stream cannot be resynchronized.
+				instance->SetBinaryConnection(connection_fd, false);
+				instance->ReleaseConnection(connection_fd);
+				instance->CloseByReset(connection_fd);
+				instance->LeaveConnection();
+				instance->EndPendingRequest();
+				return NULL;
+			}
+			if(!instance->CanBuffer(buffer.Size()))
+			{
+				//The request would be refused anyway, it is not read to the end.
+				instance->SetBinaryConnection(connection_fd, false);
+				instance->ReleaseConnection(connection_fd);
+				instance->RefuseConnection(connection_fd, DELIMITER_CHAR);
+				close(connection_fd);
+				instance->LeaveConnection();
+				instance->EndPendingRequest();
+				return NULL;
+			}
+			char *space = buffer.Reserve(BUFFER_SIZE);
+			nbytes = recv(connection_fd, space, buffer.Available(), 0);
+			if(nbytes > 0)
+			{
+				buffer.Commit(nbytes);
+			}
+			else if(nbytes == 0 && instance->keepAlive)
+			{
+				//The client closed first, so there is no TIME_WAIT to avoid.
+				instance->SetBinaryConnection(connection_fd, false);
+				instance->ReleaseConnection(connection_fd);
+				close(connection_fd);
+				instance->LeaveConnection();
+				instance->EndPendingRequest();
+				return NULL;
+			}
+			else if(nbytes == 0 || errno != EINTR)
+			{
+				instance->SetBinaryConnection(connection_fd, false);
+				instance->ReleaseConnection(connection_fd);
+				instance->CleanClose(connection_fd);
+				instance->LeaveConnection();
+				instance->EndPendingRequest();
+				return NULL;
+			}
 		}
-		else
+		else if(!instance->keepAlive)
 		{
-			request.append(buffer,nbytes);
+			instance->RecordRead(buffer.GetArrival());
+			instance->ReleaseConnection(connection_fd);
+			instance->OnRequest(begin, end, reinterpret_cast<void*>(connection_fd));
+			instance->LeaveConnection();
+			instance->EndPendingRequest();
+			return NULL;
 		}
-	} while(request.find(DELIMITER_CHAR) == string::npos);
-	instance->OnRequest(request, reinterpret_cast<void*>(connection_fd));
-	return NULL;
-}
-
-
-bool LinuxTcpSocketServer::WriteToSocket(const int& fd, const string& toWrite)
-{
-	bool fullyWritten = false;
-	bool errorOccured = false;
-	string toSend = toWrite;
-	do
-	{
-		ssize_t byteWritten = send(fd, toSend.c_str(), toSend.size(), 0);
-		if(byteWritten < 0)
+		else if(instance->binaryFraming && !buffer.IsFramed() && BinaryFraming::IsPreamble(begin, end))
 		{
-			errorOccured = true;
-			CleanClose(fd);
+			//The client sends no frame before it has read the answer to its preamble.
+			instance->SetBinaryConnection(connection_fd, true);
+			buffer.SetFramed(true);
+			SocketResponseWriter::SendMessage(connection_fd, string(BinaryFraming::PREAMBLE, BinaryFraming::PREAMBLE_SIZE), DELIMITER_CHAR);
 		}
-		else if(static_cast<size_t>(byteWritten) < toSend.size())
+		else
 		{
-			int len = toSend.size() - byteWritten;
-			toSend = toSend.substr(byteWritten, len);
+			//Pipelined requests are answered one after the other, in order.
+			instance->RecordRead(buffer.GetArrival());
+			instance->OnRequestAndWait(begin, end, reinterpret_cast<void*>(connection_fd));
 		}
-		else
-			fullyWritten = true;
-	} while(!fullyWritten && !errorOccured);
-
-	return fullyWritten && !errorOccured;
+	}
 }
 
+
 bool LinuxTcpSocketServer::WaitClientClose(const int& fd, const int &timeout)
 {
 	bool ret = false;
@@ -265,3 +586,477 @@ int LinuxTcpSocketServer::CleanClose(const int& fd)
 		return CloseByReset(fd);
 	}
 }
+
+bool LinuxTcpSocketServer::StartReactor()
+{
+	bool ok = true;
+	if(this->GetExecutor() != NULL)
+	{
+		this->pool = this->GetExecutor();
+	}
+	else
+	{
+		this->own_pool = new ThreadPool(this->reactor_workers, this->reactor_queue);
+		this->pool = this->own_pool;
+		ok = this->pool->Start();
+	}
+	for(unsigned int i = 0; ok && i < this->reactor_loops; i++)
+	{
+		EventLoop *loop = new EventLoop();
+		loop->index = i;
+		loop->instance = this;
+		loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+		loop->wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		//Without SO_REUSEPORT the first loop accepts for all of them.
+		loop->listen_fd = i == 0 ? this->socket_fd : (this->reusePort ? this->OpenListeningSocket(true) : -1);
+		loop->reserve_fd = loop->listen_fd >= 0 ? open("/dev/null", O_RDONLY | O_CLOEXEC) : -1;
+		pthread_mutex_init(&(loop->lock), NULL);
+		this->loops.push_back(loop);
+
+		struct epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN;
+		event.data.ptr = loop;
+		ok = loop->epoll_fd >= 0 && loop->wakeup_fd >= 0 && epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->wakeup_fd, &event) == 0;
+		if(ok && (i == 0 || this->reusePort))
+		{
+			//The data pointer of a listening socket is NULL. Level triggered, so connections left in the backlog
+			//when accepting fails are reported again.
+			memset(&event, 0, sizeof(event));
+			event.events = EPOLLIN;
+			event.data.ptr = NULL;
+			ok = loop->listen_fd >= 0 && epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->listen_fd, &event) == 0;
+		}
+	}
+
+	this->running = ok;
+	unsigned int started = 0;
+	while(ok && started < this->loops.size())
+	{
+		ok = pthread_create(&(this->loops[started]->thread), NULL, LinuxTcpSocketServer::LaunchEventLoop, this->loops[started]) == 0;
+		if(ok)
+			started++;
+	}
+	if(!ok)
+	{
+		this->running = false;
+		for(unsigned int i = 0; i < started; i++)
+		{
+			WakeEventLoop(this->loops[i]->wakeup_fd);
+			pthread_join(this->loops[i]->thread, NULL);
+		}
+		this->CleanupReactor();
+	}
+	return ok;
+}
+
+void LinuxTcpSocketServer::StopReactor()
+{
+	this->running = false;
+	for(size_t i = 0; i < this->loops.size(); i++)
+	{
+		WakeEventLoop(this->loops[i]->wakeup_fd);
+		pthread_join(this->loops[i]->thread, NULL);
+	}
+	this->CleanupReactor();
+}
+
+void LinuxTcpSocketServer::CleanupReactor()
+{
+	//Let the workers finish what is queued, they still write to their connections.
+	if(this->own_pool != NULL)
+	{
+		this->own_pool->Stop();
+		delete this->own_pool;
+		this->own_pool = NULL;
+	}
+	this->WaitForPendingRequests();
+	this->pool = NULL;
+
+	for(size_t i = 0; i < this->loops.size(); i++)
+	{
+		EventLoop *loop = this->loops[i];
+		loop->connections.insert(loop->incoming.begin(), loop->incoming.end());
+		for(set<ReactorConnection*>::iterator it = loop->connections.begin(); it != loop->connections.end(); ++it)
+		{
+			this->RemoveSubscriber(*it);
+			close((*it)->fd);
+			delete *it;
+			this->LeaveConnection();
+		}
+		if(loop->listen_fd >= 0 && loop->listen_fd != this->socket_fd)
+			close(loop->listen_fd);
+		if(loop->reserve_fd >= 0)
+			close(loop->reserve_fd);
+		if(loop->wakeup_fd >= 0)
+			close(loop->wakeup_fd);
+		if(loop->epoll_fd >= 0)
+			close(loop->epoll_fd);
+		pthread_mutex_destroy(&(loop->lock));
+		delete loop;
+	}
+	this->loops.clear();
+	shutdown(this->socket_fd, 2);
+	close(this->socket_fd);
+}
+
+void* LinuxTcpSocketServer::LaunchEventLoop(void *p_data)
+{
+	EventLoop *loop = reinterpret_cast<EventLoop*>(p_data);
+	loop->instance->EventLoopRun(loop);
+	return NULL;
+}
+
+void LinuxTcpSocketServer::EventLoopRun(EventLoop *loop)
+{
+	struct epoll_event events[REACTOR_MAX_EVENTS];
+	vector<ReactorConnection*> incoming;
+	vector<ReactorConnection*> finished;
+	struct timeval lastSweep;
+	gettimeofday(&lastSweep, NULL);
+	if(this->pinLoops)
+	{
+		this->PinEventLoop(loop);
+	}
+
+	while(this->running)
+	{
+		int count = epoll_wait(loop->epoll_fd, events, REACTOR_MAX_EVENTS, REACTOR_TICK_MS);
+		for(int i = 0; i < count; i++)
+		{
+			if(events[i].data.ptr == NULL)
+			{
+				this->AcceptConnections(loop);
+			}
+			else if(events[i].data.ptr == loop)
+			{
+				uint64_t value;
+				ssize_t ret = read(loop->wakeup_fd, &value, sizeof(value));
+				(void)ret;
+			}
+			else
+			{
+				this->ReadConnection(reinterpret_cast<ReactorConnection*>(events[i].data.ptr));
+			}
+		}
+
+		pthread_mutex_lock(&(loop->lock));
+		incoming.swap(loop->incoming);
+		finished.swap(loop->finished);
+		pthread_mutex_unlock(&(loop->lock));
+
+		for(size_t i = 0; i < incoming.size(); i++)
+		{
+			struct epoll_event event;
+			memset(&event, 0, sizeof(event));
+			event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+			event.data.ptr = incoming[i];
+			loop->connections.insert(incoming[i]);
+			if(epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, incoming[i]->fd, &event) != 0)
+			{
+				this->CloseConnection(incoming[i], true);
+			}
+		}
+		incoming.clear();
+
+		for(size_t i = 0; i < finished.size(); i++)
+		{
+			ReactorConnection *connection = finished[i];
+			connection->busy = false;
+			if(connection->broken)
+			{
+				this->CloseConnection(connection, true);
+			}
+			else if(connection->stalled)
+			{
+				//Data is left in the socket, reading it also dispatches the next request.
+				connection->stalled = false;
+				if(!this->keepAlive)
+				{
+					connection->answered = true;
+					gettimeofday(&(connection->answeredAt), NULL);
+				}
+				this->ReadConnection(connection);
+			}
+			else if(this->keepAlive && this->DispatchNext(connection))
+			{
+				//Requests that arrived while the previous one was executed are already buffered.
+				continue;
+			}
+			else if(connection->broken)
+			{
+				this->CloseConnection(connection, true);
+			}
+			else if(connection->peerClosed)
+			{
+				this->CloseConnection(connection, false);
+			}
+			else if(!this->keepAlive)
+			{
+				connection->answered = true;
+				gettimeofday(&(connection->answeredAt), NULL);
+			}
+		}
+		finished.clear();
+
+		struct timeval now;
+		gettimeofday(&now, NULL);
+		if((now.tv_sec - lastSweep.tv_sec) * 1000000 + (now.tv_usec - lastSweep.tv_usec) >= REACTOR_TICK_MS * 1000)
+		{
+			lastSweep = now;
+			this->ExpireDrainingConnections(loop, now);
+		}
+	}
+}
+
+void LinuxTcpSocketServer::PinEventLoop(EventLoop *loop)
+{
+	//Loops are spread over the CPUs the process may use, so a restricted affinity mask is respected.
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0)
+	{
+		return;
+	}
+	unsigned int skip = loop->index % CPU_COUNT(&allowed);
+	for(int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+	{
+		if(CPU_ISSET(cpu, &allowed) && skip-- == 0)
+		{
+			cpu_set_t pinned;
+			CPU_ZERO(&pinned);
+			CPU_SET(cpu, &pinned);
+			pthread_setaffinity_np(pthread_self(), sizeof(pinned), &pinned);
+			return;
+		}
+	}
+}
+
+void LinuxTcpSocketServer::AcceptConnections(EventLoop *loop)
+{
+	this->SampleAcceptQueue(loop->listen_fd);
+	while(true)
+	{
+		int connection_fd = accept4(loop->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if(connection_fd < 0)
+		{
+			if(errno == EINTR || errno == ECONNABORTED)
+				continue;
+			//Out of descriptors the connection stays in the backlog and is reported again, it is closed instead.
+			if((errno == EMFILE || errno == ENFILE) && loop->reserve_fd >= 0)
+			{
+				close(loop->reserve_fd);
+				connection_fd = accept4(loop->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+				if(connection_fd >= 0)
+					close(connection_fd);
+				loop->reserve_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+				if(connection_fd >= 0)
+					continue;
+			}
+			break;
+		}
+		if(!this->AdmitConnection(connection_fd, DELIMITER_CHAR))
+		{
+			continue;
+		}
+		//With SO_REUSEPORT the kernel has already picked the loop.
+		EventLoop *target = this->reusePort ? loop : this->loops[this->next_loop++ % this->loops.size()];
+		ReactorConnection *connection = new ReactorConnection();
+		connection->fd = connection_fd;
+		connection->loop = target;
+		connection->stalled = false;
+		connection->busy = false;
+		connection->answered = false;
+		connection->peerClosed = false;
+		connection->onLoop = false;
+		connection->broken = false;
+		connection->input.SetTimed(this->GetMetrics() != NULL);
+
+		pthread_mutex_lock(&(target->lock));
+		target->incoming.push_back(connection);
+		pthread_mutex_unlock(&(target->lock));
+		if(target != loop)
+		{
+			WakeEventLoop(target->wakeup_fd);
+		}
+	}
+}
+
+void LinuxTcpSocketServer::ReadConnection(ReactorConnection *connection)
+{
+	while(true)
+	{
+		if(connection->input.NextFrameSize() > BinaryFraming::MAX_PAYLOAD_SIZE)
+		{
+			//No request is that large, the connection is closed once it is idle.
+			connection->peerClosed = true;
+			break;
+		}
+		if(!this->CanBuffer(connection->input.Size()))
+		{
+			//Pipelined requests wait in the socket until the buffered ones are done, an unfinished one that large is refused below.
+			connection->stalled = true;
+			break;
+		}
+		//While busy, the worker reads its request from the buffer, so it may only be appended to.
+		char *space = connection->input.Reserve(REACTOR_BUFFER_SIZE, !connection->busy);
+		if(space == NULL)
+		{
+			//Edge triggered, so reading has to resume explicitly once the worker is done.
+			connection->stalled = true;
+			break;
+		}
+		ssize_t nbytes = recv(connection->fd, space, connection->input.Available(), 0);
+		if(nbytes > 0)
+		{
+			//Once answered, anything but the close of the client is ignored.
+			if(!connection->answered)
+				connection->input.Commit(nbytes);
+		}
+		else if(nbytes < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if(nbytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			break;
+		}
+		else
+		{
+			//A failed connection is not answered anymore, a half closed one still gets its pending responses.
+			if(nbytes < 0)
+				connection->input.Clear();
+			connection->peerClosed = true;
+			break;
+		}
+	}
+
+	if(connection->busy)
+	{
+		//The worker reports back through FinishRequest, peerClosed is checked there.
+		return;
+	}
+	bool dispatched = false;
+	if(this->keepAlive || !connection->answered)
+	{
+		dispatched = this->DispatchNext(connection);
+	}
+	if(!dispatched && connection->broken)
+	{
+		this->CloseConnection(connection, true);
+	}
+	else if(!dispatched && connection->stalled)
+	{
+		this->RefuseConnection(connection->fd, DELIMITER_CHAR);
+		this->CloseConnection(connection, false);
+	}
+	else if(!dispatched && connection->peerClosed)
+	{
+		this->CloseConnection(connection, false);
+	}
+}
+
+bool LinuxTcpSocketServer::DispatchNext(ReactorConnection *connection)
+{
+	const char *begin, *end;
+	while(connection->input.Next(begin, end))
+	{
+		if(this->keepAlive && this->binaryFraming && !connection->input.IsFramed() && BinaryFraming::IsPreamble(begin, end))
+		{
+			//The client sends no frame before it has read the answer to its preamble.
+			connection->input.SetFramed(true);
+			if(!SocketResponseWriter::SendMessage(connection->fd, string(BinaryFraming::PREAMBLE, BinaryFraming::PREAMBLE_SIZE), DELIMITER_CHAR, 0))
+			{
+				connection->broken = true;
+				return false;
+			}
+			continue;
+		}
+		this->RecordRead(connection->input.GetArrival());
+		this->DispatchRequest(connection, begin, end);
+		return true;
+	}
+	return false;
+}
+
+void LinuxTcpSocketServer::DispatchRequest(ReactorConnection *connection, const char *begin, const char *end)
+{
+	connection->busy = true;
+	if(!this->AdmitRequest(end - begin))
+	{
+		this->RejectOnLoop(connection, begin, end);
+		return;
+	}
+	ReactorTask *task = new ReactorTask(this, connection, begin, end);
+	this->BeginPendingRequest();
+	if(!this->pool->Submit(task, task->GetPriority()))
+	{
+		delete task;
+		this->EndPendingRequest();
+		this->EndRequest(end - begin);
+		this->RejectOnLoop(connection, begin, end);
+	}
+}
+
+void LinuxTcpSocketServer::RejectOnLoop(ReactorConnection *connection, const char *begin, const char *end)
+{
+	//Refused requests are answered right away and the connection goes on as if a worker had finished them.
+	//A client that does not read would stall the loop and all its connections, an answer that does not fit resets it.
+	connection->onLoop = true;
+	this->RejectRequest(begin, end, connection);
+	connection->onLoop = false;
+	this->FinishRequest(connection);
+}
+
+bool LinuxTcpSocketServer::SendOnConnection(ReactorConnection *connection, bool sent)
+{
+	if(!sent && connection->onLoop)
+		connection->broken = true;
+	return sent;
+}
+
+int LinuxTcpSocketServer::GetWriteTimeout(ReactorConnection *connection)
+{
+	return connection->onLoop ? 0 : REACTOR_WRITE_TIMEOUT_MS;
+}
+
+void LinuxTcpSocketServer::FinishRequest(ReactorConnection *connection)
+{
+	EventLoop *loop = connection->loop;
+	pthread_mutex_lock(&(loop->lock));
+	loop->finished.push_back(connection);
+	pthread_mutex_unlock(&(loop->lock));
+	WakeEventLoop(loop->wakeup_fd);
+}
+
+void LinuxTcpSocketServer::CloseConnection(ReactorConnection *connection, bool reset)
+{
+	EventLoop *loop = connection->loop;
+	this->RemoveSubscriber(connection);
+	epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+	if(reset)
+		CloseByReset(connection->fd);
+	else
+		close(connection->fd);
+	loop->connections.erase(connection);
+	delete connection;
+	this->LeaveConnection();
+}
+
+void LinuxTcpSocketServer::ExpireDrainingConnections(EventLoop *loop, const struct timeval &now)
+{
+	vector<ReactorConnection*> expired;
+	for(set<ReactorConnection*>::iterator it = loop->connections.begin(); it != loop->connections.end(); ++it)
+	{
+		ReactorConnection *connection = *it;
+		if(connection->answered && (now.tv_sec - connection->answeredAt.tv_sec) * 1000000 + (now.tv_usec - connection->answeredAt.tv_usec) >= REACTOR_DRAIN_TIMEOUT_US)
+		{
+			expired.push_back(connection);
+		}
+	}
+	//Same policy as CleanClose: a client that does not close in time gets reset to avoid TIME_WAIT.
+	for(size_t i = 0; i < expired.size(); i++)
+	{
+		this->CloseConnection(expired[i], true);
+	}
+}
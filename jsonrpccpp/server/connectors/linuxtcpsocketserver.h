@@ -20,14 +20,19 @@
 #include <arpa/inet.h>
 #include <pthread.h>
 
+#include <vector>
+#include <set>
+
 #include "../abstractserverconnector.h"
+#include "../threadpool.h"
 
 namespace jsonrpc
 {
 	/**
          * This class is the Linux/UNIX implementation of TCPSocketServer.
          * It uses the POSIX socket API and POSIX thread API to performs its job.
-         * Each client request is handled in a new thread.
+         * By default each client request is handled in a new thread. SetReactorMode() switches to
+         * edge-triggered epoll loops that hand complete requests to a bounded worker pool instead.
          */
     class LinuxTcpSocketServer: public AbstractServerConnector
 	{
@@ -76,6 +81,74 @@ namespace jsonrpc
                          */
 			bool SendResponse(const std::string& response, void* addInfo = NULL);
 
+                        /**
+                         * @brief Selects the epoll based reactor instead of one thread per connection.
+                         * 
+                         * The event loops accept and read connections without spawning threads. Complete requests are
+                         * executed by a fixed pool of workers which also write the responses. Must be called before StartListening.
+                         * If an executor is set, its workers are used and the workers and maxQueued parameters are ignored.
+                         * Requests are queued in the lane of their procedure, see Procedure::SetPriority. Lane limits need an executor,
+                         * see ThreadPool::SetLaneLimit.
+                         * @param loops The number of event loop threads, connections are spread over them round robin, or by the kernel, see SetReusePort
+                         * @param workers The number of threads executing requests
+                         * @param maxQueued The maximum number of complete requests of a lane waiting for a worker. Reading stops while the lane is full.
+                         * @return false if the server is already listening
+                         */
+			bool SetReactorMode(unsigned int loops = 1, unsigned int workers = 4, unsigned int maxQueued = 64);
+
+                        /**
+                         * @brief Keeps client connections open after a response.
+                         * 
+                         * Each connection then carries any number of delimiter terminated requests, which are answered in order.
+                         * Clients may pipeline requests without waiting for the previous response, and may subscribe to notifications
+                         * the server publishes, see AbstractServerConnector::Publish. Must be called before StartListening.
+                         * @param keepAlive true to keep connections open until the client closes them
+                         * @return false if the server is already listening
+                         */
+			bool SetKeepAlive(bool keepAlive);
+
+                        /**
+                         * @brief Lets clients switch their connection to CBOR encoded, length prefixed frames.
+                         * 
+                         * A client asks for it with the preamble described in BinaryFraming, connections of other clients stay in text mode.
+                         * Binary framing only applies to keep-alive connections. A client that subscribes to notifications switches
+                         * before it subscribes, it then receives them as frames. Must be called before StartListening.
+                         * @param allow true to accept the preamble, false to answer it with a parse error
+                         * @return false if the server is already listening
+                         */
+			bool SetBinaryFraming(bool allow);
+
+                        /**
+                         * @brief Sets how many connections the kernel queues until the server accepts them, 5 by default.
+                         * 
+                         * Connections beyond it are dropped by the kernel and retried by the client later, raise it for bursts of clients.
+                         * The kernel caps it at net.core.somaxconn. Its fill level is reported by GetAdmissionStatistics. Must be called before StartListening.
+                         * @return false if the server is already listening
+                         */
+			bool SetListenBacklog(unsigned int backlog);
+
+                        /**
+                         * @brief Gives each event loop of the reactor its own listening socket, bound with SO_REUSEPORT.
+                         * 
+                         * The kernel then spreads new connections over the loops and each loop serves the connections it accepted
+                         * itself, so accepting is no longer done by a single thread. Only applies in reactor mode, see SetReactorMode.
+                         * Other processes of the same user may bind the port too and take a share of the connections.
+                         * Must be called before StartListening.
+                         * @param reusePort true for a listening socket per event loop
+                         * @param pinLoops true to pin event loop i to the i-th CPU the process may run on, with or without reusePort
+                         * @return false if the server is already listening
+                         */
+			bool SetReusePort(bool reusePort, bool pinLoops = true);
+
+		protected:
+			ResponseWriter* OpenResponse(void* addInfo);
+			bool CloseResponse(ResponseWriter* writer, void* addInfo);
+			bool IsBinaryRequest(void* addInfo);
+			bool SendBinaryResponse(const std::string& payload, void* addInfo);
+			bool CanPush(void* addInfo);
+			bool SendPush(const std::string& message, bool binary, void* addInfo);
+			bool IsPeerClosed(void* addInfo);
+
 		private:
 			bool running;                   /*!< A boolean that is used to know the listening state*/
 			std::string ipToBind;           /*!< The ipv4 address on which the server should bind and listen*/
@@ -85,6 +158,27 @@ namespace jsonrpc
 
 			pthread_t listenning_thread;    /*!< The identifier of the listen loop thread*/
 
+			struct ReactorConnection;
+			struct EventLoop;
+			class ReactorTask;
+			friend class ReactorTask;
+
+			bool reactor;                   /*!< True when the epoll reactor is used instead of thread per connection*/
+			unsigned int reactor_loops;     /*!< The number of event loops in reactor mode*/
+			unsigned int reactor_workers;   /*!< The number of worker threads in reactor mode*/
+			unsigned int reactor_queue;     /*!< The maximum number of requests waiting for a worker in reactor mode*/
+			ThreadPool *pool;               /*!< The workers executing requests in reactor mode, the executor if one is set*/
+			ThreadPool *own_pool;           /*!< The pool created by the reactor when no executor is set*/
+			std::vector<EventLoop*> loops;  /*!< The event loops in reactor mode*/
+			unsigned int next_loop;         /*!< The loop the next accepted connection is assigned to*/
+			bool keepAlive;                 /*!< True if connections stay open after a response*/
+			bool binaryFraming;             /*!< True if clients may switch to binary framing*/
+			unsigned int backlog;           /*!< The backlog of the listening socket*/
+			bool reusePort;                 /*!< True if each event loop listens on its own SO_REUSEPORT socket*/
+			bool pinLoops;                  /*!< True if each event loop is pinned to a CPU*/
+			std::set<int> binary_fds;       /*!< The connections using binary framing in thread per connection mode*/
+			pthread_mutex_t binary_lock;    /*!< Protects binary_fds*/
+
                         /**
                          * @brief The static method that is used as listening thread entry point
                          * @param p_data The parameters for the thread entry point method
@@ -94,6 +188,8 @@ namespace jsonrpc
                          * @brief The method that launches the listenning loop
                          */
 			void ListenLoop();                      
+			int OpenListeningSocket(bool reusePort);
+			void SampleAcceptQueue(int fd);
 			struct GenerateResponseParameters
 			{
 				LinuxTcpSocketServer *instance;
@@ -104,15 +200,7 @@ namespace jsonrpc
                          * @param p_data The parameters for the thread entry point method
                          */
 			static void* GenerateResponse(void *p_data);
-                        /**
-                         * @brief A method that write a message to  socket
-                         * 
-                         * Tries to send the full message.
-                         * @param fd The file descriptor of the socket message should be sent
-                         * @param toSend The message to send over socket
-                         * @returns A boolean indicating the success or the failure of the operation
-                         */
-			bool WriteToSocket(const int& fd, const std::string& toSend);
+			void SetBinaryConnection(int fd, bool binary);
                         /**
                          * @brief A method that wait for the client to close the tcp session
                          * 
@@ -141,6 +229,23 @@ namespace jsonrpc
                          * @returns The return value of POSIX close() method
                          */
 			int CleanClose(const int& fd);
+
+			bool StartReactor();
+			void StopReactor();
+			void CleanupReactor();
+			static void* LaunchEventLoop(void *p_data);
+			void EventLoopRun(EventLoop *loop);
+			void PinEventLoop(EventLoop *loop);
+			void AcceptConnections(EventLoop *loop);
+			void ReadConnection(ReactorConnection *connection);
+			bool DispatchNext(ReactorConnection *connection);
+			void DispatchRequest(ReactorConnection *connection, const char *begin, const char *end);
+			void FinishRequest(ReactorConnection *connection);
+			void RejectOnLoop(ReactorConnection *connection, const char *begin, const char *end);
+			bool SendOnConnection(ReactorConnection *connection, bool sent);
+			static int GetWriteTimeout(ReactorConnection *connection);
+			void CloseConnection(ReactorConnection *connection, bool reset);
+			void ExpireDrainingConnections(EventLoop *loop, const struct timeval &now);
 	};
 
 } /* namespace jsonrpc */
@@ -45,6 +45,7 @@ bool TcpSocketServer::StartListening()
 	if(this->realSocket != NULL)
 	{
 		this->realSocket->SetHandler(this->GetHandler());
+		this->realSocket->SetExecutor(this->GetExecutor());
 		return this->realSocket->StartListening();
 	}
 	else
@@ -13,10 +13,14 @@
 #include <iostream>
 #include <sys/types.h>
 #include <jsonrpccpp/common/specificationparser.h>
+#include "../requestbuffer.h"
 #include <cstdio>
 #include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
+#include <errno.h>
 #include <string>
+#include <sys/uio.h>
 
 using namespace jsonrpc;
 using namespace std;
@@ -26,11 +30,92 @@ using namespace std;
 #ifndef DELIMITER_CHAR
 #define DELIMITER_CHAR char(0x0A)
 #endif
+#define PUSH_WRITE_TIMEOUT_MS 1000
+#define MAX_DESCRIPTORS 253	/*!< SCM_MAX_FD, the most descriptors the kernel passes with one message*/
+
+/**
+ * Reads like read() and collects the descriptors passed with the data.
+ * @param truncated - set if the kernel has dropped descriptors that did not fit.
+ */
+static ssize_t ReceiveWithDescriptors(int fd, char *buffer, size_t size, vector<int> &descriptors, bool &truncated)
+{
+	union
+	{
+		char space[CMSG_SPACE(sizeof(int) * MAX_DESCRIPTORS)];
+		struct cmsghdr align;
+	} control;
+	struct iovec io;
+	io.iov_base = buffer;
+	io.iov_len = size;
+	struct msghdr message;
+	memset(&message, 0, sizeof(message));
+	message.msg_iov = &io;
+	message.msg_iovlen = 1;
+	message.msg_control = control.space;
+	message.msg_controllen = sizeof(control.space);
+
+	ssize_t nbytes = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+	if(nbytes < 0)
+		return nbytes;
+	for(struct cmsghdr *header = CMSG_FIRSTHDR(&message); header != NULL; header = CMSG_NXTHDR(&message, header))
+	{
+		if(header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+			continue;
+		size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+		for(size_t i = 0; i < count; i++)
+		{
+			int descriptor;
+			memcpy(&descriptor, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+			descriptors.push_back(descriptor);
+		}
+	}
+	truncated = (message.msg_flags & MSG_CTRUNC) != 0;
+	return nbytes;
+}
 
 UnixDomainSocketServer::UnixDomainSocketServer(const string &socket_path) :
 	running(false),
+	keepAlive(true),
+	backlog(5),
+	maxPayloads(0),
 	socket_path(socket_path.substr(0, PATH_MAX))
 {
+	pthread_mutex_init(&this->payload_lock, NULL);
+}
+
+UnixDomainSocketServer::~UnixDomainSocketServer()
+{
+	pthread_mutex_destroy(&this->payload_lock);
+}
+
+bool UnixDomainSocketServer::SetKeepAlive(bool keepAlive)
+{
+	if(this->running)
+	{
+		return false;
+	}
+	this->keepAlive = keepAlive;
+	return true;
+}
+
+bool UnixDomainSocketServer::SetListenBacklog(unsigned int backlog)
+{
+	if(this->running)
+	{
+		return false;
+	}
+	this->backlog = backlog > 0 ? backlog : 1;
+	return true;
+}
+
+bool UnixDomainSocketServer::SetBulkPayloads(unsigned int maxPayloads)
+{
+	if(this->running)
+	{
+		return false;
+	}
+	this->maxPayloads = maxPayloads;
+	return true;
 }
 
 bool UnixDomainSocketServer::StartListening()
@@ -64,7 +149,7 @@ bool UnixDomainSocketServer::StartListening()
 			return false;
 		}
 
-		if(listen(this->socket_fd, 5) != 0)
+		if(listen(this->socket_fd, this->backlog) != 0)
         {
             return false;
 		}
@@ -94,6 +179,8 @@ bool UnixDomainSocketServer::StopListening()
 		pthread_join(this->listenning_thread, NULL);
 		close(this->socket_fd);
 		unlink(this->socket_path.c_str());
+		this->ShutdownConnections();
+		this->WaitForPendingRequests();
 		return !(this->running);
 	}
 	else
@@ -104,33 +191,75 @@ bool UnixDomainSocketServer::StopListening()
 
 bool UnixDomainSocketServer::SendResponse(const string& response, void* addInfo)
 {
-	bool result = false;
 	int connection_fd = reinterpret_cast<intptr_t>(addInfo);
+	return SocketResponseWriter::SendMessage(connection_fd, response, DELIMITER_CHAR);
+}
 
-	string temp = response;
-	if(temp.find(DELIMITER_CHAR) == string::npos)
-	{
-		temp.append(1, DELIMITER_CHAR);
-	}
-	if(DELIMITER_CHAR != '\n')
-	{
-		char eot = DELIMITER_CHAR;
-		string toSend = temp.substr(0, toSend.find_last_of('\n'));
-		toSend += eot;
-		result = this->WriteToSocket(connection_fd, toSend);
-	}
-	else
+ResponseWriter* UnixDomainSocketServer::OpenResponse(void* addInfo)
+{
+	return new SocketResponseWriter(reinterpret_cast<intptr_t>(addInfo));
+}
+
+bool UnixDomainSocketServer::CloseResponse(ResponseWriter* writer, void* addInfo)
+{
+	(void)addInfo;
+	writer->sputc(DELIMITER_CHAR);
+	bool result = writer->Flush();
+	delete writer;
+	return result;
+}
+
+bool UnixDomainSocketServer::CanPush(void* addInfo)
+{
+	(void)addInfo;
+	return this->keepAlive;
+}
+
+bool UnixDomainSocketServer::SendPush(const string& message, bool binary, void* addInfo)
+{
+	(void)binary;
+	int connection_fd = reinterpret_cast<intptr_t>(addInfo);
+	bool result = SocketResponseWriter::SendMessage(connection_fd, message, DELIMITER_CHAR, PUSH_WRITE_TIMEOUT_MS);
+	if(!result)
 	{
-		result = this->WriteToSocket(connection_fd, temp);
+		//The connection thread sees the shutdown and releases the connection.
+		shutdown(connection_fd, SHUT_RDWR);
 	}
-    // TODO in a real implementation, need to clean up the connection
-	//close(connection_fd);
 	return result;
 }
 
+bool UnixDomainSocketServer::IsPeerClosed(void* addInfo)
+{
+	//POLLRDHUP reports the shutdown of the client while its requests are still unread.
+	struct pollfd pfd;
+	pfd.fd = reinterpret_cast<intptr_t>(addInfo);
+	pfd.events = POLLRDHUP;
+	pfd.revents = 0;
+	return poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLRDHUP | POLLHUP | POLLERR)) != 0;
+}
+
+size_t UnixDomainSocketServer::GetPayloadCount(void* addInfo)
+{
+	pthread_mutex_lock(&this->payload_lock);
+	map<int, vector<BulkPayload*>*>::iterator it = this->payloads.find(reinterpret_cast<intptr_t>(addInfo));
+	size_t count = (it != this->payloads.end()) ? it->second->size() : 0;
+	pthread_mutex_unlock(&this->payload_lock);
+	return count;
+}
+
+const BulkPayload* UnixDomainSocketServer::GetPayload(void* addInfo, size_t index)
+{
+	BulkPayload *payload = NULL;
+	pthread_mutex_lock(&this->payload_lock);
+	map<int, vector<BulkPayload*>*>::iterator it = this->payloads.find(reinterpret_cast<intptr_t>(addInfo));
+	if(it != this->payloads.end() && index < it->second->size())
+		payload = (*it->second)[index];
+	pthread_mutex_unlock(&this->payload_lock);
+	return (payload != NULL && payload->IsSealed()) ? payload : NULL;
+}
+
 void* UnixDomainSocketServer::LaunchLoop(void *p_data)
 {
-	pthread_detach(pthread_self());
 	UnixDomainSocketServer *instance = reinterpret_cast<UnixDomainSocketServer*>(p_data);;
 	instance->ListenLoop();
 	return NULL;
@@ -144,16 +273,25 @@ void UnixDomainSocketServer::ListenLoop()
 	{
 		if((connection_fd = accept(this->socket_fd, reinterpret_cast<struct sockaddr *>(&(this->address)),  &address_length)) > 0)
 		{
+			if(!this->AdmitConnection(connection_fd, DELIMITER_CHAR))
+			{
+				continue;
+			}
 			pthread_t client_thread;
 			struct ClientConnection *params = new struct ClientConnection();
 			params->instance = this;
 			params->connection_fd = connection_fd;
+			this->BeginConnection(connection_fd);
 			int ret = pthread_create(&client_thread, NULL, UnixDomainSocketServer::HandleConnection, params);
 			if(ret != 0)
 			{
 				pthread_detach(client_thread);
 				delete params;
 				params = NULL;
+				this->ReleaseConnection(connection_fd);
+				close(connection_fd);
+				this->LeaveConnection();
+				this->EndPendingRequest();
 			}
 		}
 		else
@@ -172,45 +310,105 @@ void* UnixDomainSocketServer::HandleConnection(void *p_data)
 	delete params;
 	params = NULL;
 
-    do {
-        instance->GenerateResponse(instance, connection_fd);
-    } while (connection_fd >= 0);
-}
-
-void* UnixDomainSocketServer::GenerateResponse(UnixDomainSocketServer *instance, int connection_fd)
-{
 	int nbytes;
-	char buffer[BUFFER_SIZE];
-	string request;
-	do
-	{ //The client sends its json formatted request and a delimiter request.
-		nbytes = read(connection_fd, buffer, BUFFER_SIZE);
-		request.append(buffer,nbytes);
-	} while(request.find(DELIMITER_CHAR) == string::npos);
+	RequestBuffer buffer(DELIMITER_CHAR);
+	buffer.SetTimed(instance->GetMetrics() != NULL);
+	const char *begin, *end;
+	bool open = true;
 
-	instance->OnRequest(request, reinterpret_cast<void*>(connection_fd));
+	//Descriptors arrive with the read that ends in the first bytes sent with them. A client sends a request and its payloads
+	//with one message, so they belong to the request the last byte of that read is part of.
+	vector<pair<unsigned long long, int> > received;
+	vector<int> descriptors;
+	vector<BulkPayload*> request;
+	unsigned long long readBytes = 0;
+	unsigned long long takenBytes = 0;
+	while(open)
+	{ //The client sends its json formatted request and a delimiter request.
+		if(!buffer.Next(begin, end))
+		{
+			if(!instance->CanBuffer(buffer.Size()))
+			{
+				//The request would be refused anyway, it is not read to the end.
+				instance->RefuseConnection(connection_fd, DELIMITER_CHAR);
+				break;
+			}
+			char *space = buffer.Reserve(BUFFER_SIZE);
+			if(instance->maxPayloads > 0)
+			{
+				bool truncated = false;
+				descriptors.clear();
+				nbytes = ReceiveWithDescriptors(connection_fd, space, buffer.Available(), descriptors, truncated);
+				for(size_t i = 0; i < descriptors.size(); i++)
+					received.push_back(make_pair(readBytes + (nbytes > 0 ? nbytes - 1 : 0), descriptors[i]));
+				if(truncated)
+					break;
+			}
+			else
+			{
+				nbytes = read(connection_fd, space, buffer.Available());
+			}
+			if(nbytes > 0)
+			{
+				buffer.Commit(nbytes);
+				readBytes += nbytes;
+			}
+			else if(nbytes == 0 || errno != EINTR)
+				open = false;
+		}
+		else
+		{
+			takenBytes += end - begin;
+			if(!received.empty() && !instance->TakePayloads(connection_fd, received, takenBytes, request))
+				break;
+			//Pipelined requests are answered one after the other, in order.
+			instance->RecordRead(buffer.GetArrival());
+			instance->OnRequestAndWait(begin, end, reinterpret_cast<void*>(connection_fd));
+			instance->ReleasePayloads(connection_fd, request);
+			open = instance->keepAlive;
+		}
+	}
+	for(size_t i = 0; i < received.size(); i++)
+		close(received[i].second);
+	instance->ReleaseConnection(connection_fd);
+	close(connection_fd);
+	instance->LeaveConnection();
+	instance->EndPendingRequest();
 	return NULL;
 }
 
-
-bool UnixDomainSocketServer::WriteToSocket(int fd, const string& toWrite)
+bool UnixDomainSocketServer::TakePayloads(int connection_fd, vector<pair<unsigned long long, int> > &received, unsigned long long taken, vector<BulkPayload*> &request)
 {
-	bool fullyWritten = false;
-	bool errorOccured = false;
-	string toSend = toWrite;
-	do
+	size_t count = 0;
+	while(count < received.size() && received[count].first < taken)
+		count++;
+	if(count == 0)
+		return true;
+	if(count > this->maxPayloads)
+		return false;
+
+	//A descriptor that is no sealed memfd stays in its place, so the others keep their index.
+	for(size_t i = 0; i < count; i++)
 	{
-		ssize_t byteWritten = write(fd, toSend.c_str(), toSend.size());
-		if(byteWritten < 0)
-			errorOccured = true;
-		else if(byteWritten < static_cast<ssize_t>(toSend.size()))
-		{
-			int len = toSend.size() - byteWritten;
-			toSend = toSend.substr(byteWritten + sizeof(char), len);
-		}
-		else
-			fullyWritten = true;
-	} while(!fullyWritten && !errorOccured);
+		BulkPayload *payload = new BulkPayload();
+		payload->Map(received[i].second);
+		request.push_back(payload);
+	}
+	received.erase(received.begin(), received.begin() + count);
+	pthread_mutex_lock(&this->payload_lock);
+	this->payloads[connection_fd] = &request;
+	pthread_mutex_unlock(&this->payload_lock);
+	return true;
+}
 
-	return fullyWritten && !errorOccured;
+void UnixDomainSocketServer::ReleasePayloads(int connection_fd, vector<BulkPayload*> &request)
+{
+	if(request.empty())
+		return;
+	pthread_mutex_lock(&this->payload_lock);
+	this->payloads.erase(connection_fd);
+	pthread_mutex_unlock(&this->payload_lock);
+	for(size_t i = 0; i < request.size(); i++)
+		delete request[i];
+	request.clear();
 }
@@ -18,13 +18,19 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <pthread.h>
+#include <map>
+#include <vector>
 
 #include "../abstractserverconnector.h"
+#include <jsonrpccpp/common/bulkpayload.h>
 
 namespace jsonrpc
 {
 	/**
 	 * This class provides an embedded Unix Domain Socket Server,to handle incoming Requests.
+	 * Each connection is served by its own thread. In keep-alive mode, the default, a connection carries any number of
+	 * delimiter terminated requests which are answered in order, and may subscribe to notifications the server publishes;
+	 * otherwise it is closed after the first response.
 	 */
 	class UnixDomainSocketServer: public AbstractServerConnector
 	{
@@ -34,20 +40,57 @@ namespace jsonrpc
 			 * @param socket_path, a string containing the path to the unix socket
 			 */
 			UnixDomainSocketServer(const std::string& socket_path);
+			virtual ~UnixDomainSocketServer();
 
 			virtual bool StartListening();
 			virtual bool StopListening();
 
 			bool virtual SendResponse(const std::string& response, void* addInfo = NULL);
 
+			/**
+			 * @brief Selects whether connections stay open after a response. Must be called before StartListening.
+			 * @return false if the server is already listening
+			 */
+			bool SetKeepAlive(bool keepAlive);
+
+			/**
+			 * @brief Sets how many connections the kernel queues until the server accepts them, 5 by default. Must be called before StartListening.
+			 * @return false if the server is already listening
+			 */
+			bool SetListenBacklog(unsigned int backlog);
+
+			/**
+			 * @brief Accepts bulk payloads, memfds a client sends along with a request over SCM_RIGHTS, see BulkPayload and
+			 * UnixDomainSocketClient::AttachPayload. Procedures find them with CallContext::GetPayload(). Off by default,
+			 * descriptors sent to the server are closed unread then. Must be called before StartListening.
+			 * @param maxPayloads - the most payloads one request may carry, 0 to turn them off. A connection that sends more is closed.
+			 * @return false if the server is already listening
+			 */
+			bool SetBulkPayloads(unsigned int maxPayloads);
+
+		protected:
+			ResponseWriter* OpenResponse(void* addInfo);
+			bool CloseResponse(ResponseWriter* writer, void* addInfo);
+			bool CanPush(void* addInfo);
+			bool SendPush(const std::string& message, bool binary, void* addInfo);
+			bool IsPeerClosed(void* addInfo);
+			size_t GetPayloadCount(void* addInfo);
+			const BulkPayload* GetPayload(void* addInfo, size_t index);
+
 		private:
 			bool running;
+			bool keepAlive;
+			unsigned int backlog;
+			unsigned int maxPayloads;
 			std::string socket_path;
 			int socket_fd;
 			struct sockaddr_un address;
 
 			pthread_t listenning_thread;
 
+			std::map<int, std::vector<BulkPayload*>*> payloads;	/*!< The payloads of the request a connection is processing, by socket*/
+			pthread_mutex_t payload_lock;						/*!< Protects payloads*/
+
 			static void* LaunchLoop(void *p_data);
 			void ListenLoop();
 			struct ClientConnection
@@ -56,8 +99,8 @@ namespace jsonrpc
 				int connection_fd;
 			};
             static void* HandleConnection(void *p_data);
-			static void* GenerateResponse(UnixDomainSocketServer *, int);
-			bool WriteToSocket(int fd, const std::string& toSend);
+			bool TakePayloads(int connection_fd, std::vector<std::pair<unsigned long long, int> >& received, unsigned long long taken, std::vector<BulkPayload*>& request);
+			void ReleasePayloads(int connection_fd, std::vector<BulkPayload*>& request);
 	};
 
 } /* namespace jsonrpc */
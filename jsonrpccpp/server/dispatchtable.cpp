@@ -0,0 +1,106 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    dispatchtable.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "dispatchtable.h"
+#include <string.h>
+
+#define DISPATCH_INITIAL_SLOTS 16
+
+using namespace jsonrpc;
+using namespace std;
+
+DispatchTable::DispatchTable() :
+    slots(DISPATCH_INITIAL_SLOTS, 0),
+    mask(DISPATCH_INITIAL_SLOTS - 1)
+{
+}
+
+void DispatchTable::Add(const Procedure &procedure, int binding)
+{
+    const string &name = procedure.GetProcedureName();
+    DispatchEntry *existing = this->Find(name);
+    if (existing != NULL)
+    {
+        existing->procedure = procedure;
+        existing->validator.Compile(procedure);
+        existing->binding = binding;
+        return;
+    }
+
+    //Keep the load factor at or below one half, so probe sequences stay short.
+    if ((this->entries.size() + 1) * 2 > this->slots.size())
+        this->Rehash(this->slots.size() * 2);
+
+    DispatchEntry entry;
+    entry.procedure = procedure;
+    entry.validator.Compile(procedure);
+    entry.binding = binding;
+    entry.hash = Hash(name.data(), name.size());
+    entry.metrics = -1;
+    this->entries.push_back(entry);
+
+    unsigned int slot = entry.hash & this->mask;
+    while (this->slots[slot] != 0)
+        slot = (slot + 1) & this->mask;
+    this->slots[slot] = this->entries.size();
+}
+
+DispatchEntry *DispatchTable::Find(const char *name, size_t length)
+{
+    unsigned int hash = Hash(name, length);
+    unsigned int slot = hash & this->mask;
+    while (this->slots[slot] != 0)
+    {
+        DispatchEntry &entry = this->entries[this->slots[slot] - 1];
+        const string &candidate = entry.procedure.GetProcedureName();
+        if (entry.hash == hash && candidate.size() == length && memcmp(candidate.data(), name, length) == 0)
+            return &entry;
+        slot = (slot + 1) & this->mask;
+    }
+    return NULL;
+}
+
+DispatchEntry *DispatchTable::Find(const string &name)
+{
+    return this->Find(name.data(), name.size());
+}
+
+size_t DispatchTable::Size() const
+{
+    return this->entries.size();
+}
+
+DispatchEntry &DispatchTable::At(size_t index)
+{
+    return this->entries[index];
+}
+
+unsigned int DispatchTable::Hash(const char *name, size_t length)
+{
+    //32 bit FNV-1a
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= static_cast<unsigned char>(name[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void DispatchTable::Rehash(size_t capacity)
+{
+    this->slots.assign(capacity, 0);
+    this->mask = capacity - 1;
+    for (size_t i = 0; i < this->entries.size(); i++)
+    {
+        unsigned int slot = this->entries[i].hash & this->mask;
+        while (this->slots[slot] != 0)
+            slot = (slot + 1) & this->mask;
+        this->slots[slot] = i + 1;
+    }
+}
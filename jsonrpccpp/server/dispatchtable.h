@@ -0,0 +1,70 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    dispatchtable.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_DISPATCHTABLE_H_
+#define JSONRPC_CPP_DISPATCHTABLE_H_
+
+#include <string>
+#include <vector>
+#include <jsonrpccpp/common/procedure.h>
+#include "parametervalidator.h"
+
+namespace jsonrpc
+{
+    /**
+     * A registered procedure together with the index of the member pointer that implements it.
+     */
+    struct DispatchEntry
+    {
+        Procedure           procedure;
+        ParameterValidator  validator;  /*!< The parameter check of procedure, compiled by Add()*/
+        int                 binding;    /*!< Index into the method or notification table of the server, -1 if not bound*/
+        unsigned int        hash;       /*!< Hash of the procedure name*/
+        int                 metrics;    /*!< Slot of the procedure in the RpcMetrics of the handler, -1 if none*/
+    };
+
+    /**
+     * Open addressing hash table from procedure names to DispatchEntry, built when procedures are bound.
+     * Lookups take the raw name bytes of the request, so dispatching a call neither copies the name nor walks a tree.
+     * Add() must not run concurrently with Find().
+     */
+    class DispatchTable
+    {
+        public:
+            DispatchTable();
+
+            /**
+             * @brief Registers a procedure, replacing a previous one with the same name.
+             */
+            void Add(const Procedure& procedure, int binding);
+
+            /**
+             * @return the entry for the given name or NULL. The pointer stays valid until the next Add().
+             */
+            DispatchEntry* Find(const char* name, size_t length);
+            DispatchEntry* Find(const std::string& name);
+
+            size_t Size() const;
+
+            /**
+             * @return the entry registered index-th, in the order of Add().
+             */
+            DispatchEntry& At(size_t index);
+
+            static unsigned int Hash(const char* name, size_t length);
+
+        private:
+            std::vector<DispatchEntry>  entries;
+            std::vector<unsigned int>   slots;      /*!< Index into entries plus one, 0 marks a free slot*/
+            unsigned int                mask;
+
+            void Rehash(size_t capacity);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_DISPATCHTABLE_H_ */
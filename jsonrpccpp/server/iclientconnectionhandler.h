@@ -11,15 +11,77 @@
 #define JSONRPC_CPP_ICLIENTCONNECTIONHANDLER_H
 
 #include <string>
+#include <ostream>
+#include <jsonrpccpp/common/jsonparser.h>
+#include <jsonrpccpp/common/specification.h>
 
 namespace jsonrpc
 {
     class Procedure;
+    class ThreadPool;
+    class RpcMetrics;
+    class ResponseCache;
+
+    /**
+     * Timing of JSON-RPC 2.0 batches. When the calls of a batch run in parallel, wallUs drops below callUs.
+     */
+    struct BatchStatistics
+    {
+        unsigned long long  batches;
+        unsigned long long  calls;
+        unsigned long long  wallUs;         /*!< summed time from receiving a batch to having all its responses*/
+        unsigned long long  callUs;         /*!< summed execution time of the individual calls*/
+        unsigned long long  lastWallUs;     /*!< wallUs of the most recent batch*/
+        unsigned long long  lastCallUs;     /*!< callUs of the most recent batch*/
+    };
+
     class IClientConnectionHandler {
         public:
             virtual ~IClientConnectionHandler() {}
 
             virtual void HandleRequest(const std::string& request, std::string& retValue) = 0;
+
+            /**
+             * Handles a request held in [begin, end), e.g. a range of a connector's receive buffer.
+             * Protocol handlers parse it in place, the default copies it into a string.
+             */
+            virtual void HandleRequest(const char* begin, const char* end, std::string& retValue) { this->HandleRequest(std::string(begin, end), retValue); }
+
+            /**
+             * Same as above, but serializes the response into a stream, e.g. one over a ResponseWriter, so it is never held in a string.
+             * Nothing is written if there is no response. The default writes the string produced by the overload above.
+             */
+            virtual void HandleRequest(const char* begin, const char* end, std::ostream& response) { std::string retValue; this->HandleRequest(begin, end, retValue); response << retValue; }
+
+            /**
+             * Handles a request that has already been decoded, e.g. from a binary frame. response stays null if there is no response.
+             * Protocol handlers work on the values directly, the default goes through the text overload.
+             */
+            virtual void HandleJsonRequest(const Json::Value& request, Json::Value& response)
+            {
+                std::string retValue;
+                Json::FastWriter writer;
+                this->HandleRequest(writer.write(request), retValue);
+                response = Json::Value();
+                if (!retValue.empty())
+                {
+                    Json::Reader reader;
+                    reader.parse(retValue, response, false);
+                }
+            }
+
+            /**
+             * Produces the response to a request that will not be executed, e.g. because the server is overloaded.
+             * Protocol handlers answer each method call of the request with an error of the given code, notifications are dropped.
+             * The default leaves retValue empty.
+             */
+            virtual void HandleRejectedRequest(const std::string& request, int code, std::string& retValue) { (void)request; (void)code; (void)retValue; }
+
+            /**
+             * Tells the lane a connector with an executor queues the request in [begin, end), text or CBOR, see Procedure::SetPriority.
+             * It runs in the receiving thread before the request is parsed and must be cheap. The default returns PRIORITY_NORMAL.
+             */
+            virtual priority_t GetRequestPriority(const char* begin, const char* end) { (void)begin; (void)end; return PRIORITY_NORMAL; }
     };
 
     class IProtocolHandler : public IClientConnectionHandler
@@ -27,7 +89,42 @@ namespace jsonrpc
         public:
             virtual ~IProtocolHandler(){}
 
-            virtual void AddProcedure(const Procedure& procedure) = 0;
+            /**
+             * @param binding - an index the IProcedureInvokationHandler resolves the implementation with, -1 if it dispatches by name.
+             */
+            virtual void AddProcedure(const Procedure& procedure, int binding = -1) = 0;
+
+            /**
+             * Runs the calls of a batch concurrently on the given pool, the procedures must then be thread safe.
+             * Serialized procedures still run alone, see Procedure::SetSerialized. NULL runs the calls one by one.
+             * Protocols without batches ignore it.
+             */
+            virtual void SetBatchExecutor(ThreadPool* executor) { (void)executor; }
+
+            /**
+             * @return false if the protocol has no batches.
+             */
+            virtual bool GetBatchStatistics(BatchStatistics& statistics) { (void)statistics; return false; }
+
+            /**
+             * Records request counts and latencies into metrics and answers the method rpc.metrics with a snapshot of them.
+             * NULL stops recording. It must be set before requests arrive, e.g. before StartListening.
+             */
+            virtual void SetMetrics(RpcMetrics* metrics) { (void)metrics; }
+
+            /**
+             * Answers calls of procedures with a cache ttl from cache, see Procedure::SetCacheTtl. NULL executes every call.
+             * It must be set before requests arrive, the cache may be shared by several servers.
+             */
+            virtual void SetResponseCache(ResponseCache* cache) { (void)cache; }
+
+            /**
+             * Adds the methods rpc.subscribe and rpc.unsubscribe. Both take the name of an event, by name as "event" or as the
+             * only positional parameter, and subscribe the connection of the request to the notifications that
+             * AbstractServerConnector::Publish sends for the event, or unsubscribe it. A procedure of the server with the same
+             * name takes precedence. It must be called before requests arrive.
+             */
+            virtual void EnableSubscriptions() {}
     };
 }
 
@@ -10,9 +10,7 @@
 #ifndef JSONRPC_CPP_IPROCEDUREINVOKATIONHANDLER_H
 #define JSONRPC_CPP_IPROCEDUREINVOKATIONHANDLER_H
 
-namespace Json {
-    class Value;
-}
+#include <jsonrpccpp/common/jsontape.h>
 
 namespace jsonrpc {
 
@@ -23,6 +21,38 @@ namespace jsonrpc {
             virtual ~IProcedureInvokationHandler() {}
             virtual void HandleMethodCall(Procedure& proc, const Json::Value& input, Json::Value& output) = 0;
             virtual void HandleNotificationCall(Procedure& proc, const Json::Value& input) = 0;
+
+            /**
+             * Called by the protocol handlers with the binding the procedure was registered with, see IProtocolHandler::AddProcedure.
+             * The default ignores the binding and dispatches by name.
+             */
+            virtual void InvokeMethod(Procedure& proc, int binding, const Json::Value& input, Json::Value& output)
+            {
+                (void)binding;
+                this->HandleMethodCall(proc, input, output);
+            }
+            virtual void InvokeNotification(Procedure& proc, int binding, const Json::Value& input)
+            {
+                (void)binding;
+                this->HandleNotificationCall(proc, input);
+            }
+
+            /**
+             * Called instead of InvokeMethod and InvokeNotification for procedures with lazy parameters, see
+             * Procedure::SetLazyParameters. The defaults decode the parameters and pass them on.
+             */
+            virtual void InvokeLazyMethod(Procedure& proc, int binding, const JsonView& input, Json::Value& output)
+            {
+                Json::Value parameters;
+                input.ToValue(parameters);
+                this->InvokeMethod(proc, binding, parameters, output);
+            }
+            virtual void InvokeLazyNotification(Procedure& proc, int binding, const JsonView& input)
+            {
+                Json::Value parameters;
+                input.ToValue(parameters);
+                this->InvokeNotification(proc, binding, parameters);
+            }
     };
 }
 
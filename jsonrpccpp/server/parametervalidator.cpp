@@ -0,0 +1,176 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    parametervalidator.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "parametervalidator.h"
+#include <string.h>
+#include <algorithm>
+
+using namespace jsonrpc;
+using namespace std;
+
+ParameterValidator::ParameterValidator() :
+    declaration(PARAMS_BY_NAME)
+{
+}
+
+void ParameterValidator::Compile(const Procedure &procedure)
+{
+    this->declaration = procedure.GetParameterDeclarationType();
+    this->named.clear();
+    this->positional.clear();
+
+    const parameterNameList_t &parameters = procedure.GetParameters();
+    for (parameterNameList_t::const_iterator it = parameters.begin(); it != parameters.end(); ++it)
+    {
+        NamedParameter parameter;
+        parameter.name = it->first;
+        parameter.type = it->second;
+        this->named.push_back(parameter);
+    }
+    std::sort(this->named.begin(), this->named.end(), ParameterValidator::NameLess);
+    this->positional = procedure.GetPositionalParameters();
+}
+
+bool ParameterValidator::Validate(const Json::Value &parameters) const
+{
+    if (this->named.empty())
+        return true;
+    if (parameters.isArray() && this->declaration == PARAMS_BY_POSITION)
+        return this->ValidatePositional(parameters);
+    if (parameters.isObject() && this->declaration == PARAMS_BY_NAME)
+        return this->ValidateNamed(parameters);
+    return false;
+}
+
+bool ParameterValidator::Validate(const JsonView &parameters) const
+{
+    if (this->named.empty())
+        return true;
+    if (parameters.IsArray() && this->declaration == PARAMS_BY_POSITION)
+    {
+        if (parameters.Size() != this->positional.size())
+            return false;
+        for (Json::ArrayIndex i = 0; i < this->positional.size(); i++)
+        {
+            if (!HasType(this->positional[i], parameters.At(i)))
+                return false;
+        }
+        return true;
+    }
+    if (parameters.IsObject() && this->declaration == PARAMS_BY_NAME)
+    {
+        //The members of a tape are in the order of the text, so each parameter is looked up on its own.
+        if (parameters.Size() < this->named.size())
+            return false;
+        for (size_t i = 0; i < this->named.size(); i++)
+        {
+            JsonView member = parameters.Get(this->named[i].name);
+            if (member.IsMissing() || !HasType(this->named[i].type, member))
+                return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool ParameterValidator::ValidateNamed(const Json::Value &parameters) const
+{
+    if (parameters.size() < this->named.size())
+        return false;
+
+    Json::Value::const_iterator member = parameters.begin();
+    Json::Value::const_iterator end = parameters.end();
+    for (size_t i = 0; i < this->named.size(); i++)
+    {
+        const NamedParameter &expected = this->named[i];
+        int order = -1;
+        while (member != end)
+        {
+            const char *nameEnd = NULL;
+            const char *name = member.memberName(&nameEnd);
+            order = Compare(name, nameEnd - name, expected.name);
+            if (order >= 0)
+                break;
+            //A member that is not a parameter.
+            ++member;
+        }
+        if (order != 0 || !HasType(expected.type, *member))
+            return false;
+        ++member;
+    }
+    return true;
+}
+
+bool ParameterValidator::ValidatePositional(const Json::Value &parameters) const
+{
+    if (parameters.size() != this->positional.size())
+        return false;
+    for (Json::ArrayIndex i = 0; i < this->positional.size(); i++)
+    {
+        if (!HasType(this->positional[i], parameters[i]))
+            return false;
+    }
+    return true;
+}
+
+bool ParameterValidator::NameLess(const NamedParameter &a, const NamedParameter &b)
+{
+    return Compare(a.name.data(), a.name.size(), b.name) < 0;
+}
+
+int ParameterValidator::Compare(const char *name, size_t length, const string &other)
+{
+    //The order of Json::Value::CZString.
+    size_t common = length < other.size() ? length : other.size();
+    int order = memcmp(name, other.data(), common);
+    if (order != 0)
+        return order;
+    if (length == other.size())
+        return 0;
+    return length < other.size() ? -1 : 1;
+}
+
+bool ParameterValidator::HasType(jsontype_t type, const Json::Value &value)
+{
+    switch (type)
+    {
+        case JSON_STRING:
+            return value.isString();
+        case JSON_BOOLEAN:
+            return value.isBool();
+        case JSON_INTEGER:
+            return value.isIntegral();
+        case JSON_REAL:
+            return value.isDouble();
+        case JSON_OBJECT:
+            return value.isObject();
+        case JSON_ARRAY:
+            return value.isArray();
+    }
+    return true;
+}
+
+bool ParameterValidator::HasType(jsontype_t type, const JsonView &value)
+{
+    switch (type)
+    {
+        case JSON_STRING:
+            return value.IsString();
+        case JSON_BOOLEAN:
+            return value.IsBool();
+        case JSON_INTEGER:
+            return value.IsIntegral();
+        case JSON_REAL:
+            return value.IsNumeric();
+        case JSON_OBJECT:
+            return value.IsObject();
+        case JSON_ARRAY:
+            return value.IsArray();
+    }
+    return true;
+}
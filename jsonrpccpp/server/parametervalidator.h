@@ -0,0 +1,65 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    parametervalidator.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_PARAMETERVALIDATOR_H_
+#define JSONRPC_CPP_PARAMETERVALIDATOR_H_
+
+#include <string>
+#include <vector>
+#include <jsonrpccpp/common/procedure.h>
+#include <jsonrpccpp/common/jsontape.h>
+
+namespace jsonrpc
+{
+    /**
+     * The parameter check of a Procedure, compiled into a flat list of steps when the procedure is registered.
+     *
+     * Named parameters are kept sorted in the order jsoncpp keeps object members, so one merge pass over the params object
+     * finds every parameter without a map lookup and stops at the first missing or mistyped one.
+     * Accepts exactly what Procedure::ValdiateParameters accepts.
+     */
+    class ParameterValidator
+    {
+        public:
+            ParameterValidator();
+
+            void Compile(const Procedure& procedure);
+
+            /**
+             * @param parameters - the params member of a request, null if it has none.
+             */
+            bool Validate(const Json::Value& parameters) const;
+
+            /**
+             * @brief The same check for the parameters of a procedure with lazy parameters, it decodes no more than the
+             * types of the parameters and the numbers among them.
+             */
+            bool Validate(const JsonView& parameters) const;
+
+        private:
+            struct NamedParameter
+            {
+                std::string name;
+                jsontype_t  type;
+            };
+
+            parameterDeclaration_t          declaration;
+            std::vector<NamedParameter>     named;          /*!< Sorted like the members of a Json::Value object*/
+            std::vector<jsontype_t>         positional;
+
+            bool ValidateNamed(const Json::Value& parameters) const;
+            bool ValidatePositional(const Json::Value& parameters) const;
+
+            static int Compare(const char* name, size_t length, const std::string& other);
+            static bool NameLess(const NamedParameter& a, const NamedParameter& b);
+            static bool HasType(jsontype_t type, const Json::Value& value);
+            static bool HasType(jsontype_t type, const JsonView& value);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_PARAMETERVALIDATOR_H_ */
@@ -0,0 +1,187 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    requestbuffer.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "requestbuffer.h"
+#include "rpcmetrics.h"
+#include <jsonrpccpp/common/cbor.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+using namespace jsonrpc;
+
+RequestBuffer::RequestBuffer(char delimiter, size_t capacity) :
+    delimiter(delimiter),
+    data(NULL),
+    capacity(0),
+    start(0),
+    end(0),
+    scanned(0),
+    framed(false),
+    timed(false),
+    pendingSince(0),
+    lastCommit(0),
+    arrival(0)
+{
+    if (capacity > 0)
+    {
+        this->data = static_cast<char*>(malloc(capacity));
+        if (this->data == NULL)
+            throw std::bad_alloc();
+        this->capacity = capacity;
+    }
+}
+
+RequestBuffer::~RequestBuffer()
+{
+    free(this->data);
+}
+
+char *RequestBuffer::Reserve(size_t size, bool move)
+{
+    if (move && this->start == this->end)
+    {
+        //Everything has been returned, start over at the front.
+        this->start = this->end = this->scanned = 0;
+    }
+    if (this->capacity - this->end >= size)
+        return this->data + this->end;
+    if (!move)
+        return NULL;
+
+    //Drop what Next() has returned, then grow if that is not enough.
+    size_t length = this->end - this->start;
+    if (this->start > 0)
+    {
+        memmove(this->data, this->data + this->start, length);
+        this->scanned -= this->start;
+        this->start = 0;
+        this->end = length;
+    }
+    if (this->capacity - this->end < size)
+    {
+        size_t capacity = this->capacity > 0 ? this->capacity : size;
+        while (capacity - this->end < size)
+            capacity *= 2;
+        char *grown = static_cast<char*>(realloc(this->data, capacity));
+        if (grown == NULL)
+            throw std::bad_alloc();
+        this->data = grown;
+        this->capacity = capacity;
+    }
+    return this->data + this->end;
+}
+
+size_t RequestBuffer::Available() const
+{
+    return this->capacity - this->end;
+}
+
+void RequestBuffer::Commit(size_t size)
+{
+    if (this->timed && size > 0)
+    {
+        this->lastCommit = RpcMetrics::Now();
+        if (this->start == this->end)
+            this->pendingSince = this->lastCommit;
+    }
+    this->end += size;
+}
+
+bool RequestBuffer::Next(const char *&begin, const char *&end)
+{
+    if (this->framed)
+    {
+        size_t size = this->NextFrameSize();
+        if (this->end - this->start < BinaryFraming::HEADER_SIZE || this->end - this->start - BinaryFraming::HEADER_SIZE < size)
+            return false;
+        begin = this->data + this->start + BinaryFraming::HEADER_SIZE;
+        end = begin + size;
+        this->start = end - this->data;
+        this->Taken();
+        return true;
+    }
+    if (this->scanned < this->start)
+        this->scanned = this->start;
+    const char *found = static_cast<const char*>(memchr(this->data + this->scanned, this->delimiter, this->end - this->scanned));
+    if (found == NULL)
+    {
+        this->scanned = this->end;
+        return false;
+    }
+    begin = this->data + this->start;
+    end = found + 1;
+    this->start = end - this->data;
+    this->scanned = this->start;
+    this->Taken();
+    return true;
+}
+
+bool RequestBuffer::TakeAll(const char *&begin, const char *&end)
+{
+    if (this->start == this->end)
+        return false;
+    begin = this->data + this->start;
+    end = this->data + this->end;
+    this->start = this->scanned = this->end;
+    this->Taken();
+    return true;
+}
+
+void RequestBuffer::SetTimed(bool timed)
+{
+    this->timed = timed;
+}
+
+unsigned long long RequestBuffer::GetArrival() const
+{
+    return this->timed ? this->arrival : 0;
+}
+
+void RequestBuffer::Taken()
+{
+    if (!this->timed)
+        return;
+    this->arrival = this->pendingSince;
+    //Bytes left behind arrived with the latest receive at the earliest.
+    this->pendingSince = (this->start < this->end) ? this->lastCommit : 0;
+}
+
+void RequestBuffer::SetFramed(bool framed)
+{
+    this->framed = framed;
+    this->scanned = this->start;
+}
+
+bool RequestBuffer::IsFramed() const
+{
+    return this->framed;
+}
+
+size_t RequestBuffer::NextFrameSize() const
+{
+    if (!this->framed || this->end - this->start < BinaryFraming::HEADER_SIZE)
+        return 0;
+    return BinaryFraming::ReadHeader(this->data + this->start);
+}
+
+size_t RequestBuffer::Size() const
+{
+    return this->end - this->start;
+}
+
+size_t RequestBuffer::Capacity() const
+{
+    return this->capacity;
+}
+
+void RequestBuffer::Clear()
+{
+    this->start = this->end = this->scanned = 0;
+    this->pendingSince = 0;
+}
@@ -0,0 +1,102 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    requestbuffer.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_REQUESTBUFFER_H_
+#define JSONRPC_CPP_REQUESTBUFFER_H_
+
+#include <stddef.h>
+
+namespace jsonrpc
+{
+    /**
+     * A growable receive buffer of one connection. Connectors read straight into it and hand out complete,
+     * delimiter terminated messages as ranges of the buffer, so a request reaches the parser without being copied.
+     */
+    class RequestBuffer
+    {
+        public:
+            RequestBuffer(char delimiter, size_t capacity = 4096);
+            ~RequestBuffer();
+
+            /**
+             * @brief Makes room for at least size bytes behind the buffered data.
+             * @param move whether buffered data may be moved. Pass false while a range returned by Next() is still in use.
+             * @return where to receive to, Available() bytes may be written. NULL if move is false and there is not enough room.
+             */
+            char* Reserve(size_t size, bool move = true);
+            size_t Available() const;
+
+            /**
+             * @brief Appends size bytes that have been written to the pointer returned by Reserve().
+             */
+            void Commit(size_t size);
+
+            /**
+             * @brief Takes the next complete message out of the buffer.
+             * @param begin, end set to the message including its delimiter. They stay valid until Reserve() is called with move set.
+             * @return false if no complete message is buffered.
+             */
+            bool Next(const char*& begin, const char*& end);
+
+            /**
+             * @brief Takes everything buffered as one message, for transports that delimit messages themselves, e.g. HTTP bodies.
+             * @param begin, end set to the buffered bytes. They stay valid until Reserve() is called with move set.
+             * @return false if nothing is buffered.
+             */
+            bool TakeAll(const char*& begin, const char*& end);
+
+            /**
+             * @brief Switches between delimiter terminated messages and length prefixed frames, see BinaryFraming.
+             * In framed mode Next() returns the payload of the next frame, without its header.
+             */
+            void SetFramed(bool framed);
+            bool IsFramed() const;
+
+            /**
+             * @return the payload size announced by the next frame, 0 if its header has not been received or the buffer is not framed.
+             */
+            size_t NextFrameSize() const;
+
+            /**
+             * @brief Stamps received data with the time it is committed, for RpcMetrics. Off initially.
+             */
+            void SetTimed(bool timed);
+
+            /**
+             * @return when the first byte of the message last returned by Next() or TakeAll() was committed, 0 if not timed.
+             */
+            unsigned long long GetArrival() const;
+
+            /**
+             * @return the number of buffered bytes not returned by Next() yet.
+             */
+            size_t Size() const;
+            size_t Capacity() const;
+            void Clear();
+
+        private:
+            char    delimiter;
+            char    *data;
+            size_t  capacity;
+            size_t  start;      /*!< Offset of the first byte not returned by Next()*/
+            size_t  end;        /*!< Offset behind the last buffered byte*/
+            size_t  scanned;    /*!< Offset up to which the data has been searched for the delimiter*/
+            bool    framed;
+            bool    timed;
+            unsigned long long  pendingSince;   /*!< Arrival of the first byte not returned yet, 0 if there is none*/
+            unsigned long long  lastCommit;
+            unsigned long long  arrival;        /*!< Arrival of the message returned last*/
+
+            void Taken();
+
+            RequestBuffer(const RequestBuffer&);
+            RequestBuffer& operator=(const RequestBuffer&);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_REQUESTBUFFER_H_ */
@@ -0,0 +1,366 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    responsecache.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "responsecache.h"
+#include "abstractprotocolhandler.h"
+#include "rpcmetrics.h"
+#include <string.h>
+#include <sstream>
+
+#define FNV_OFFSET_BASIS    14695981039346656037ULL
+#define FNV_PRIME           1099511628211ULL
+
+using namespace jsonrpc;
+using namespace std;
+
+struct ResponseCache::Entry
+{
+    unsigned long long          key;
+    string                      procedure;
+    Json::Value                 parameters;
+    Json::Value                 result;
+    string                      text;       /*!< result as WriteResponse serializes it*/
+    unsigned long long          expires;    /*!< RpcMetrics::Now() after which the entry is stale*/
+    size_t                      bytes;
+    list<Entry*>::iterator      position;
+};
+
+static void HashBytes(const void *data, size_t length, unsigned long long &hash)
+{
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+static void HashWord(unsigned long long word, unsigned long long &hash)
+{
+    hash ^= word;
+    hash *= FNV_PRIME;
+}
+
+/**
+ * Value::operator== tells an int from an uint of the same value, which a decoded CBOR request may well contain.
+ */
+static bool IsEqual(const Json::Value &a, const Json::Value &b)
+{
+    if (a.type() != b.type())
+    {
+        if (a.type() == Json::intValue && b.type() == Json::uintValue)
+            return a.asInt64() >= 0 && Json::UInt64(a.asInt64()) == b.asUInt64();
+        if (a.type() == Json::uintValue && b.type() == Json::intValue)
+            return IsEqual(b, a);
+        return false;
+    }
+    if (a.isArray() || a.isObject())
+    {
+        if (a.size() != b.size())
+            return false;
+        //Members are kept sorted by name, so equal objects iterate in the same order.
+        for (Json::Value::const_iterator i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j)
+        {
+            if (a.isObject())
+            {
+                //Names may contain NUL characters, they are compared with their length.
+                const char *endA = NULL;
+                const char *endB = NULL;
+                const char *nameA = i.memberName(&endA);
+                const char *nameB = j.memberName(&endB);
+                if (endA - nameA != endB - nameB || memcmp(nameA, nameB, endA - nameA) != 0)
+                    return false;
+            }
+            if (!IsEqual(*i, *j))
+                return false;
+        }
+        return true;
+    }
+    return a == b;
+}
+
+static size_t GetSize(const Json::Value &value)
+{
+    size_t size = sizeof(Json::Value);
+    if (value.isString())
+    {
+        const char *begin = NULL;
+        const char *end = NULL;
+        value.getString(&begin, &end);
+        size += end - begin;
+    }
+    else if (value.isArray() || value.isObject())
+    {
+        for (Json::Value::const_iterator i = value.begin(); i != value.end(); ++i)
+        {
+            //A member or element costs a map node on top of its value.
+            size += 4 * sizeof(void*) + GetSize(*i);
+            if (value.isObject())
+            {
+                const char *end = NULL;
+                const char *name = i.memberName(&end);
+                size += end - name;
+            }
+        }
+    }
+    return size;
+}
+
+ResponseCache::ResponseCache(size_t maxBytes) :
+    maxBytes(maxBytes),
+    bytes(0),
+    generation(0),
+    cleared(0)
+{
+    pthread_mutex_init(&(this->lock), NULL);
+    memset(&(this->statistics), 0, sizeof(this->statistics));
+}
+
+ResponseCache::~ResponseCache()
+{
+    this->Clear();
+    pthread_mutex_destroy(&(this->lock));
+}
+
+bool ResponseCache::Find(const string &procedure, const Json::Value &parameters, Json::Value *result, string *text, Miss *miss)
+{
+    unsigned long long key = GetKey(procedure, parameters);
+    bool found = false;
+    pthread_mutex_lock(&(this->lock));
+    entryMap_t::iterator position = this->Lookup(key, procedure, parameters);
+    if (position != this->entries.end())
+    {
+        Entry *entry = position->second;
+        if (entry->expires < RpcMetrics::Now())
+        {
+            this->Remove(position);
+        }
+        else
+        {
+            this->order.splice(this->order.begin(), this->order, entry->position);
+            if (result != NULL)
+                *result = entry->result;
+            if (text != NULL)
+                *text = entry->text;
+            this->statistics.hits++;
+            found = true;
+        }
+    }
+    if (!found && miss != NULL)
+    {
+        miss->key = key;
+        miss->generation = this->generation;
+    }
+    pthread_mutex_unlock(&(this->lock));
+    return found;
+}
+
+void ResponseCache::Store(const string &procedure, const Json::Value &parameters, const Json::Value &result, unsigned int ttlMs, const Miss &miss)
+{
+    Entry *entry = new Entry();
+    entry->key = miss.key;
+    entry->procedure = procedure;
+    entry->parameters = parameters;
+    entry->result = result;
+    ostringstream text;
+    AbstractProtocolHandler::WriteResponse(result, text);
+    entry->text = text.str();
+    entry->bytes = sizeof(Entry) + procedure.size() + entry->text.size() + GetSize(parameters) + GetSize(result);
+
+    unsigned long long now = RpcMetrics::Now();
+    entry->expires = now + ttlMs * 1000000ULL;
+
+    pthread_mutex_lock(&(this->lock));
+    this->statistics.misses++;
+    //The call may have read what an invalidation meant to drop, its result is as stale as the entries were.
+    map<string, unsigned long long>::const_iterator invalidated = this->invalidated.find(procedure);
+    if (this->cleared > miss.generation || (invalidated != this->invalidated.end() && invalidated->second > miss.generation))
+    {
+        pthread_mutex_unlock(&(this->lock));
+        delete entry;
+        return;
+    }
+    entryMap_t::iterator existing = this->Lookup(entry->key, procedure, parameters);
+    if (existing != this->entries.end())
+        this->Remove(existing);
+    if (entry->bytes > this->maxBytes)
+    {
+        delete entry;
+    }
+    else
+    {
+        this->Shrink(this->maxBytes - entry->bytes, now);
+        this->entries.insert(make_pair(entry->key, entry));
+        entry->position = this->order.insert(this->order.begin(), entry);
+        this->bytes += entry->bytes;
+    }
+    pthread_mutex_unlock(&(this->lock));
+}
+
+void ResponseCache::Invalidate(const string &procedure)
+{
+    pthread_mutex_lock(&(this->lock));
+    this->invalidated[procedure] = ++this->generation;
+    for (entryMap_t::iterator i = this->entries.begin(); i != this->entries.end();)
+    {
+        entryMap_t::iterator current = i++;
+        if (current->second->procedure == procedure)
+            this->Remove(current);
+    }
+    pthread_mutex_unlock(&(this->lock));
+}
+
+void ResponseCache::Clear()
+{
+    pthread_mutex_lock(&(this->lock));
+    this->cleared = ++this->generation;
+    this->invalidated.clear();
+    while (!this->entries.empty())
+        this->Remove(this->entries.begin());
+    pthread_mutex_unlock(&(this->lock));
+}
+
+void ResponseCache::SetMaxBytes(size_t maxBytes)
+{
+    pthread_mutex_lock(&(this->lock));
+    this->maxBytes = maxBytes;
+    this->Shrink(maxBytes, RpcMetrics::Now());
+    pthread_mutex_unlock(&(this->lock));
+}
+
+void ResponseCache::GetStatistics(CacheStatistics &statistics)
+{
+    pthread_mutex_lock(&(this->lock));
+    statistics = this->statistics;
+    statistics.entries = this->entries.size();
+    statistics.bytes = this->bytes;
+    pthread_mutex_unlock(&(this->lock));
+}
+
+unsigned long long ResponseCache::Hash(const Json::Value &value)
+{
+    unsigned long long hash = FNV_OFFSET_BASIS;
+    HashValue(value, hash);
+    return hash;
+}
+
+unsigned long long ResponseCache::GetKey(const string &procedure, const Json::Value &parameters)
+{
+    unsigned long long hash = FNV_OFFSET_BASIS;
+    HashBytes(procedure.data(), procedure.size() + 1, hash);
+    HashValue(parameters, hash);
+    return hash;
+}
+
+void ResponseCache::HashValue(const Json::Value &value, unsigned long long &hash)
+{
+    //Each value starts with its type, so e.g. [] and {} or "1" and 1 do not collide. Numbers are mixed in a word at a
+    //time, an uint that fits into an int hashes as that int.
+    Json::ValueType type = value.type();
+    switch (type)
+    {
+        case Json::intValue:
+        {
+            HashWord(Json::intValue, hash);
+            HashWord(value.asInt64(), hash);
+            break;
+        }
+        case Json::uintValue:
+        {
+            Json::UInt64 number = value.asUInt64();
+            HashWord(number > Json::UInt64(Json::Value::maxInt64) ? Json::uintValue : Json::intValue, hash);
+            HashWord(number, hash);
+            break;
+        }
+        case Json::realValue:
+        {
+            double number = value.asDouble();
+            unsigned long long word;
+            memcpy(&word, &number, sizeof(word));
+            HashWord(Json::realValue, hash);
+            HashWord(word, hash);
+            break;
+        }
+        case Json::stringValue:
+        {
+            const char *begin = NULL;
+            const char *end = NULL;
+            value.getString(&begin, &end);
+            HashWord(Json::stringValue, hash);
+            HashWord(end - begin, hash);
+            HashBytes(begin, end - begin, hash);
+            break;
+        }
+        case Json::arrayValue:
+        case Json::objectValue:
+        {
+            HashWord(type, hash);
+            HashWord(value.size(), hash);
+            for (Json::Value::const_iterator i = value.begin(); i != value.end(); ++i)
+            {
+                if (type == Json::objectValue)
+                {
+                    const char *end = NULL;
+                    const char *name = i.memberName(&end);
+                    HashWord(end - name, hash);
+                    HashBytes(name, end - name, hash);
+                }
+                HashValue(*i, hash);
+            }
+            break;
+        }
+        default:
+        {
+            HashWord(type, hash);
+            HashWord(value.asBool(), hash);
+            break;
+        }
+    }
+}
+
+ResponseCache::entryMap_t::iterator ResponseCache::Lookup(unsigned long long key, const string &procedure, const Json::Value &parameters)
+{
+    pair<entryMap_t::iterator, entryMap_t::iterator> range = this->entries.equal_range(key);
+    for (entryMap_t::iterator i = range.first; i != range.second; ++i)
+    {
+        if (i->second->procedure == procedure && IsEqual(i->second->parameters, parameters))
+            return i;
+    }
+    return this->entries.end();
+}
+
+void ResponseCache::Remove(entryMap_t::iterator position)
+{
+    Entry *entry = position->second;
+    this->order.erase(entry->position);
+    this->bytes -= entry->bytes;
+    this->entries.erase(position);
+    delete entry;
+}
+
+void ResponseCache::Shrink(size_t limit, unsigned long long now)
+{
+    if (this->bytes <= limit)
+        return;
+    //Expired entries go first, wherever they are in the order.
+    for (entryMap_t::iterator i = this->entries.begin(); i != this->entries.end();)
+    {
+        entryMap_t::iterator current = i++;
+        if (current->second->expires < now)
+            this->Remove(current);
+    }
+    while (this->bytes > limit && !this->order.empty())
+    {
+        Entry *entry = this->order.back();
+        pair<entryMap_t::iterator, entryMap_t::iterator> range = this->entries.equal_range(entry->key);
+        while (range.first->second != entry)
+            ++range.first;
+        this->Remove(range.first);
+        this->statistics.evictions++;
+    }
+}
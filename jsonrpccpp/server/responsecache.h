@@ -0,0 +1,115 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    responsecache.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_RESPONSECACHE_H_
+#define JSONRPC_CPP_RESPONSECACHE_H_
+
+#include <list>
+#include <map>
+#include <string>
+#include <pthread.h>
+#include <jsonrpccpp/common/jsonparser.h>
+
+namespace jsonrpc
+{
+    struct CacheStatistics
+    {
+        unsigned long long  hits;
+        unsigned long long  misses;         /*!< calls of cacheable procedures that were executed*/
+        unsigned long long  evictions;      /*!< entries dropped to stay within the size limit, expired ones are not counted*/
+        unsigned long long  entries;
+        unsigned long long  bytes;          /*!< approximate memory held by the entries*/
+    };
+
+    /**
+     * Results of idempotent procedures, see AbstractServer::SetResponseCache and Procedure::SetCacheTtl.
+     *
+     * An entry is keyed by the procedure name and the parameters of the call. The key hashes the parameters in a
+     * canonical form, so the order of members in the request does not matter and integers are compared by value
+     * whatever their type, a hit also compares the parameters themselves. Each entry keeps the result and its
+     * serialization, a hit of a single request neither runs the procedure nor serializes the result again.
+     * Entries expire after the ttl of their procedure, the least recently used ones are dropped when the cache grows
+     * beyond its size limit. All methods are thread safe.
+     */
+    class ResponseCache
+    {
+        public:
+            /**
+             * What a lookup that found nothing hands on to Store, so that the parameters are not hashed again and a
+             * result that was computed while its procedure was invalidated is not stored.
+             */
+            struct Miss
+            {
+                unsigned long long  key;
+                unsigned long long  generation;     /*!< invalidations before the lookup*/
+            };
+
+            /**
+             * @param maxBytes - the approximate memory the entries may take.
+             */
+            ResponseCache(size_t maxBytes = 4 * 1024 * 1024);
+            ~ResponseCache();
+
+            /**
+             * @brief Looks up the result of a call and counts a hit if it is found.
+             * @param result - set to the result if not NULL.
+             * @param text - set to the serialized result if not NULL.
+             * @param miss - set if nothing is found and not NULL, it is to be captured before the call is executed.
+             * @return false if there is no entry or it has expired.
+             */
+            bool Find(const std::string& procedure, const Json::Value& parameters, Json::Value* result, std::string* text, Miss* miss = NULL);
+
+            /**
+             * @brief Counts a miss and stores the result of a call executed after Find has set miss for ttlMs milliseconds.
+             * The result is dropped if the procedure has been invalidated or the cache cleared since.
+             */
+            void Store(const std::string& procedure, const Json::Value& parameters, const Json::Value& result, unsigned int ttlMs, const Miss& miss);
+
+            /**
+             * @brief Drops all entries of a procedure, e.g. after a call that changes what it returns. Calls of it that
+             * are still running do not store their result.
+             */
+            void Invalidate(const std::string& procedure);
+            void Clear();
+
+            void SetMaxBytes(size_t maxBytes);
+            void GetStatistics(CacheStatistics& statistics);
+
+            /**
+             * @return a 64 bit FNV-1a style hash of a value that does not depend on the order of object members, and that is
+             * the same for integers of equal value regardless of their type.
+             */
+            static unsigned long long Hash(const Json::Value& value);
+
+        private:
+            struct Entry;
+            typedef std::multimap<unsigned long long, Entry*> entryMap_t;
+
+            pthread_mutex_t     lock;           /*!< Protects all members below*/
+            entryMap_t          entries;
+            std::list<Entry*>   order;          /*!< Most recently used first*/
+            size_t              maxBytes;
+            size_t              bytes;
+            CacheStatistics     statistics;
+            unsigned long long  generation;     /*!< Counts the calls of Invalidate and Clear*/
+            unsigned long long  cleared;        /*!< generation of the last Clear*/
+            std::map<std::string, unsigned long long> invalidated;     /*!< generation of the last Invalidate of a procedure*/
+
+            static unsigned long long GetKey(const std::string& procedure, const Json::Value& parameters);
+            static void HashValue(const Json::Value& value, unsigned long long& hash);
+
+            entryMap_t::iterator Lookup(unsigned long long key, const std::string& procedure, const Json::Value& parameters);
+            void Remove(entryMap_t::iterator position);
+            void Shrink(size_t limit, unsigned long long now);
+
+            ResponseCache(const ResponseCache&);
+            ResponseCache& operator=(const ResponseCache&);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_RESPONSECACHE_H_ */
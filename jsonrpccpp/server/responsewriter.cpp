@@ -0,0 +1,225 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    responsewriter.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "responsewriter.h"
+#include <jsonrpccpp/common/cbor.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <new>
+
+using namespace jsonrpc;
+using namespace std;
+
+ResponseWriter::ResponseWriter(size_t chunkSize, unsigned int maxChunks) :
+    chunkSize(chunkSize > 0 ? chunkSize : 1),
+    maxChunks(maxChunks > 0 ? maxChunks : 1),
+    current(0),
+    written(0),
+    failed(false)
+{
+}
+
+ResponseWriter::~ResponseWriter()
+{
+    for (size_t i = 0; i < this->chunks.size(); i++)
+    {
+        free(this->chunks[i]);
+    }
+}
+
+bool ResponseWriter::Flush()
+{
+    if (this->chunks.empty())
+        return !this->failed;
+
+    struct iovec *parts = &this->parts[0];
+    int count = 0;
+    size_t size = 0;
+    for (unsigned int i = 0; i <= this->current; i++)
+    {
+        parts[count].iov_base = this->chunks[i];
+        parts[count].iov_len = (i < this->current) ? this->chunkSize : static_cast<size_t>(this->pptr() - this->pbase());
+        size += parts[count].iov_len;
+        if (parts[count].iov_len > 0)
+            count++;
+    }
+
+    if (!this->failed && count > 0 && !this->WriteChunks(parts, count))
+        this->failed = true;
+    this->written += size;
+    this->current = 0;
+    this->setp(this->chunks[0], this->chunks[0] + this->chunkSize);
+    return !this->failed;
+}
+
+size_t ResponseWriter::GetSize() const
+{
+    if (this->chunks.empty())
+        return this->written;
+    return this->written + this->current * this->chunkSize + (this->pptr() - this->pbase());
+}
+
+bool ResponseWriter::Failed() const
+{
+    return this->failed;
+}
+
+ResponseWriter::int_type ResponseWriter::overflow(int_type c)
+{
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+        return traits_type::not_eof(c);
+    if (!this->NextChunk())
+        return traits_type::eof();
+    *this->pptr() = traits_type::to_char_type(c);
+    this->pbump(1);
+    return c;
+}
+
+streamsize ResponseWriter::xsputn(const char *s, streamsize n)
+{
+    streamsize done = 0;
+    while (done < n)
+    {
+        streamsize room = this->epptr() - this->pptr();
+        if (room == 0)
+        {
+            if (!this->NextChunk())
+                break;
+            continue;
+        }
+        if (room > n - done)
+            room = n - done;
+        memcpy(this->pptr(), s + done, room);
+        this->pbump(static_cast<int>(room));
+        done += room;
+    }
+    return done;
+}
+
+int ResponseWriter::sync()
+{
+    return this->Flush() ? 0 : -1;
+}
+
+bool ResponseWriter::NextChunk()
+{
+    if (this->failed)
+        return false;
+    if (!this->chunks.empty())
+    {
+        if (this->current + 1 == this->maxChunks)
+            return this->Flush();
+        this->current++;
+    }
+    if (this->current == this->chunks.size())
+    {
+        char *chunk = static_cast<char*>(malloc(this->chunkSize));
+        if (chunk == NULL)
+            throw bad_alloc();
+        this->chunks.push_back(chunk);
+        this->parts.resize(this->chunks.size());
+    }
+    this->setp(this->chunks[this->current], this->chunks[this->current] + this->chunkSize);
+    return true;
+}
+
+SocketResponseWriter::SocketResponseWriter(int fd, int timeoutMs) :
+    fd(fd),
+    timeoutMs(timeoutMs)
+{
+}
+
+bool SocketResponseWriter::WriteChunks(struct iovec *chunks, int count)
+{
+    return Send(this->fd, chunks, count, this->timeoutMs);
+}
+
+bool SocketResponseWriter::Send(int fd, struct iovec *chunks, int count, int timeoutMs)
+{
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    int flags = (timeoutMs >= 0) ? MSG_NOSIGNAL | MSG_DONTWAIT : MSG_NOSIGNAL;
+    while (count > 0)
+    {
+        message.msg_iov = chunks;
+        message.msg_iovlen = count;
+        ssize_t byteWritten = sendmsg(fd, &message, flags);
+        if (byteWritten >= 0)
+        {
+            size_t left = byteWritten;
+            while (count > 0 && left >= chunks->iov_len)
+            {
+                left -= chunks->iov_len;
+                chunks++;
+                count--;
+            }
+            if (count > 0)
+            {
+                chunks->iov_base = static_cast<char*>(chunks->iov_base) + left;
+                chunks->iov_len -= left;
+            }
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            struct pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = POLLOUT;
+            pfd.revents = 0;
+            if (poll(&pfd, 1, timeoutMs) <= 0)
+                return false;
+        }
+        else if (errno != EINTR)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SocketResponseWriter::SendMessage(int fd, const string &message, char delimiter, int timeoutMs)
+{
+    struct iovec parts[2];
+    int count = 0;
+    size_t length = message.size();
+    bool terminated = length > 0 && message[length - 1] == delimiter;
+    if (!terminated && length > 0 && message[length - 1] == '\n')
+        length--;
+    if (length > 0)
+    {
+        parts[count].iov_base = const_cast<char*>(message.data());
+        parts[count].iov_len = length;
+        count++;
+    }
+    if (!terminated)
+    {
+        parts[count].iov_base = &delimiter;
+        parts[count].iov_len = 1;
+        count++;
+    }
+    return Send(fd, parts, count, timeoutMs);
+}
+
+bool SocketResponseWriter::SendFrame(int fd, const string &payload, int timeoutMs)
+{
+    char header[BinaryFraming::HEADER_SIZE];
+    struct iovec parts[2];
+    int count = 1;
+    BinaryFraming::WriteHeader(payload.size(), header);
+    parts[0].iov_base = header;
+    parts[0].iov_len = BinaryFraming::HEADER_SIZE;
+    if (!payload.empty())
+    {
+        parts[1].iov_base = const_cast<char*>(payload.data());
+        parts[1].iov_len = payload.size();
+        count++;
+    }
+    return Send(fd, parts, count, timeoutMs);
+}
@@ -0,0 +1,112 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    responsewriter.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_RESPONSEWRITER_H_
+#define JSONRPC_CPP_RESPONSEWRITER_H_
+
+#include <stddef.h>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+
+namespace jsonrpc
+{
+    /**
+     * A stream buffer that collects a response in fixed size chunks. Whenever all chunks are full they are handed to
+     * WriteChunks() at once and reused, so a response of any size is written without ever being held in one string.
+     * Chunks are allocated on demand, a small response only costs one.
+     */
+    class ResponseWriter : public std::streambuf
+    {
+        public:
+            /**
+             * @param chunkSize the size of each chunk in bytes
+             * @param maxChunks the number of chunks filled before they are written out
+             */
+            ResponseWriter(size_t chunkSize = 16384, unsigned int maxChunks = 16);
+            virtual ~ResponseWriter();
+
+            /**
+             * @brief Writes out everything buffered.
+             * @return false if a write has failed. The rest of the response is then dropped.
+             */
+            bool Flush();
+
+            /**
+             * @return the number of bytes of the response so far, written out or buffered.
+             */
+            size_t GetSize() const;
+            bool Failed() const;
+
+        protected:
+            /**
+             * @brief Writes count chunks completely, in order.
+             * @param chunks may be modified, e.g. to keep track of partial writes.
+             */
+            virtual bool WriteChunks(struct iovec* chunks, int count) = 0;
+
+            int_type overflow(int_type c);
+            std::streamsize xsputn(const char* s, std::streamsize n);
+            int sync();
+
+        private:
+            std::vector<char*> chunks;
+            std::vector<struct iovec> parts;
+            size_t          chunkSize;
+            unsigned int    maxChunks;
+            unsigned int    current;    /*!< The chunk being filled*/
+            size_t          written;    /*!< Bytes handed to WriteChunks() so far*/
+            bool            failed;
+
+            bool NextChunk();
+
+            ResponseWriter(const ResponseWriter&);
+            ResponseWriter& operator=(const ResponseWriter&);
+    };
+
+    /**
+     * Writes a response to a connected socket with sendmsg(), which does not raise SIGPIPE if the client has gone.
+     */
+    class SocketResponseWriter : public ResponseWriter
+    {
+        public:
+            /**
+             * @param fd the socket, blocking or not
+             * @param timeoutMs how long to wait for the socket to become writable, -1 to wait forever. With a timeout
+             * a blocking socket is written without blocking, too.
+             */
+            SocketResponseWriter(int fd, int timeoutMs = -1);
+
+            /**
+             * @brief Sends count buffers completely, retrying partial writes.
+             * @param chunks is modified to track partial writes
+             */
+            static bool Send(int fd, struct iovec* chunks, int count, int timeoutMs = -1);
+
+            /**
+             * @brief Sends a complete message terminated by delimiter, which is appended unless the message ends with it.
+             * A trailing newline, as produced by Json::FastWriter, is replaced by the delimiter.
+             */
+            static bool SendMessage(int fd, const std::string& message, char delimiter, int timeoutMs = -1);
+
+            /**
+             * @brief Sends a payload as one length prefixed frame, see BinaryFraming.
+             */
+            static bool SendFrame(int fd, const std::string& payload, int timeoutMs = -1);
+
+        protected:
+            bool WriteChunks(struct iovec* chunks, int count);
+
+        private:
+            int fd;
+            int timeoutMs;
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_RESPONSEWRITER_H_ */
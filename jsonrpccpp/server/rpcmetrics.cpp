@@ -0,0 +1,367 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    rpcmetrics.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "rpcmetrics.h"
+#include <string.h>
+#include <time.h>
+
+#define HISTOGRAM_LINEAR    16      /*!< Durations below this many ns have a bucket each*/
+#define HISTOGRAM_SUB_BITS  3       /*!< Each power of two above is split into 2^HISTOGRAM_SUB_BITS buckets*/
+#define HISTOGRAM_MIN_EXP   4
+#define HISTOGRAM_MAX_EXP   39
+
+using namespace jsonrpc;
+using namespace std;
+
+static const char *PHASE_NAMES[METRICS_PHASES] = {"read", "parse", "validate", "execute", "serialize", "write", "request"};
+static const char *QUEUE_NAMES[PRIORITY_CLASSES] = {SPEC_PRIORITY_HIGH, SPEC_PRIORITY_NORMAL, SPEC_PRIORITY_BULK};
+
+struct RpcMetrics::MethodCounters
+{
+    unsigned long long  calls;
+    unsigned long long  errors;
+    LatencyHistogram    latency;
+};
+
+struct RpcMetrics::Shard
+{
+    RpcMetrics          *owner;
+    bool                active;     /*!< A thread records into it*/
+    LatencyHistogram    phases[METRICS_PHASES];
+    LatencyHistogram    queues[PRIORITY_CLASSES];
+    MethodCounters      *methods[MAX_METHODS];  /*!< Created by the recording thread on the first call of a method*/
+};
+
+LatencyHistogram::LatencyHistogram() :
+    count(0),
+    sum(0),
+    max(0)
+{
+    memset(this->counts, 0, sizeof(this->counts));
+}
+
+void LatencyHistogram::Record(unsigned long long ns)
+{
+    this->counts[GetBucket(ns)]++;
+    this->count++;
+    this->sum += ns;
+    if (ns > this->max)
+        this->max = ns;
+}
+
+void LatencyHistogram::Add(const LatencyHistogram &other)
+{
+    for (int i = 0; i < BUCKETS; i++)
+        this->counts[i] += other.counts[i];
+    this->count += other.count;
+    this->sum += other.sum;
+    if (other.max > this->max)
+        this->max = other.max;
+}
+
+unsigned long long LatencyHistogram::GetCount() const
+{
+    return this->count;
+}
+
+unsigned long long LatencyHistogram::GetSum() const
+{
+    return this->sum;
+}
+
+unsigned long long LatencyHistogram::GetMax() const
+{
+    return this->max;
+}
+
+unsigned long long LatencyHistogram::GetBucketCount(int bucket) const
+{
+    return this->counts[bucket];
+}
+
+unsigned long long LatencyHistogram::GetPercentile(double percentile) const
+{
+    if (this->count == 0)
+        return 0;
+    unsigned long long rank = static_cast<unsigned long long>(percentile / 100.0 * this->count + 0.5);
+    if (rank == 0)
+        rank = 1;
+    unsigned long long seen = 0;
+    for (int i = 0; i < BUCKETS; i++)
+    {
+        seen += this->counts[i];
+        if (seen >= rank)
+            return GetBucketLimit(i) < this->max ? GetBucketLimit(i) : this->max;
+    }
+    return this->max;
+}
+
+int LatencyHistogram::GetBucket(unsigned long long ns)
+{
+    if (ns < HISTOGRAM_LINEAR)
+        return static_cast<int>(ns);
+    int exponent = 63 - __builtin_clzll(ns);
+    if (exponent > HISTOGRAM_MAX_EXP)
+        return BUCKETS - 1;
+    int sub = static_cast<int>(ns >> (exponent - HISTOGRAM_SUB_BITS)) & ((1 << HISTOGRAM_SUB_BITS) - 1);
+    return HISTOGRAM_LINEAR + ((exponent - HISTOGRAM_MIN_EXP) << HISTOGRAM_SUB_BITS) + sub;
+}
+
+unsigned long long LatencyHistogram::GetBucketLimit(int bucket)
+{
+    if (bucket < HISTOGRAM_LINEAR)
+        return bucket;
+    if (bucket >= BUCKETS - 1)
+        return ~0ULL;
+    int exponent = HISTOGRAM_MIN_EXP + ((bucket - HISTOGRAM_LINEAR) >> HISTOGRAM_SUB_BITS);
+    unsigned long long sub = (bucket - HISTOGRAM_LINEAR) & ((1 << HISTOGRAM_SUB_BITS) - 1);
+    unsigned long long width = 1ULL << (exponent - HISTOGRAM_SUB_BITS);
+    return ((1ULL << HISTOGRAM_SUB_BITS) + sub + 1) * width - 1;
+}
+
+void LatencyHistogram::ToJson(Json::Value &target) const
+{
+    target["count"] = Json::Value(static_cast<Json::UInt64>(this->count));
+    target["sum_ns"] = Json::Value(static_cast<Json::UInt64>(this->sum));
+    target["max_ns"] = Json::Value(static_cast<Json::UInt64>(this->max));
+    target["p50_ns"] = Json::Value(static_cast<Json::UInt64>(this->GetPercentile(50)));
+    target["p90_ns"] = Json::Value(static_cast<Json::UInt64>(this->GetPercentile(90)));
+    target["p99_ns"] = Json::Value(static_cast<Json::UInt64>(this->GetPercentile(99)));
+    target["p999_ns"] = Json::Value(static_cast<Json::UInt64>(this->GetPercentile(99.9)));
+}
+
+const char* MetricsSnapshot::GetPhaseName(metricsPhase_t phase)
+{
+    return PHASE_NAMES[phase];
+}
+
+const char* MetricsSnapshot::GetQueueName(priority_t priority)
+{
+    return QUEUE_NAMES[priority];
+}
+
+void MetricsSnapshot::ToJson(Json::Value &target) const
+{
+    target = Json::Value(Json::objectValue);
+    Json::Value &phases = target["phases"];
+    for (int i = 0; i < METRICS_PHASES; i++)
+        this->phases[i].ToJson(phases[PHASE_NAMES[i]]);
+
+    Json::Value &queues = target["queues"];
+    for (int i = 0; i < PRIORITY_CLASSES; i++)
+        this->queues[i].ToJson(queues[QUEUE_NAMES[i]]);
+
+    Json::Value &methods = target["methods"];
+    methods = Json::Value(Json::objectValue);
+    for (size_t i = 0; i < this->methods.size(); i++)
+    {
+        Json::Value &method = methods[this->methods[i].name];
+        method["calls"] = Json::Value(static_cast<Json::UInt64>(this->methods[i].calls));
+        method["errors"] = Json::Value(static_cast<Json::UInt64>(this->methods[i].errors));
+        this->methods[i].latency.ToJson(method["latency"]);
+    }
+}
+
+RpcMetrics::RpcMetrics() :
+    enabled(true)
+{
+    pthread_key_create(&this->key, RpcMetrics::ReleaseShard);
+    pthread_mutex_init(&this->lock, NULL);
+}
+
+RpcMetrics::~RpcMetrics()
+{
+    //No destructor runs for the key after this, threads still holding a shard simply drop it.
+    pthread_key_delete(this->key);
+    for (size_t i = 0; i < this->shards.size(); i++)
+    {
+        for (int j = 0; j < MAX_METHODS; j++)
+            delete this->shards[i]->methods[j];
+        delete this->shards[i];
+    }
+    pthread_mutex_destroy(&this->lock);
+}
+
+void RpcMetrics::SetEnabled(bool enabled)
+{
+    __atomic_store_n(&this->enabled, enabled, __ATOMIC_RELAXED);
+}
+
+bool RpcMetrics::IsEnabled() const
+{
+    return __atomic_load_n(&this->enabled, __ATOMIC_RELAXED);
+}
+
+int RpcMetrics::RegisterMethod(const string &name)
+{
+    pthread_mutex_lock(&this->lock);
+    int slot = -1;
+    map<string, int>::iterator it = this->slots.find(name);
+    if (it != this->slots.end())
+    {
+        slot = it->second;
+    }
+    else if (this->methods.size() < static_cast<size_t>(MAX_METHODS))
+    {
+        slot = this->methods.size();
+        this->slots[name] = slot;
+        this->methods.push_back(name);
+    }
+    pthread_mutex_unlock(&this->lock);
+    return slot;
+}
+
+void RpcMetrics::Record(metricsPhase_t phase, unsigned long long ns)
+{
+    AddSample(this->GetShard()->phases[phase], ns);
+}
+
+void RpcMetrics::RecordQueue(priority_t priority, unsigned long long ns)
+{
+    AddSample(this->GetShard()->queues[priority], ns);
+}
+
+void RpcMetrics::RecordCall(int method, unsigned long long ns, bool failed)
+{
+    Shard *shard = this->GetShard();
+    AddSample(shard->phases[METRICS_EXECUTE], ns);
+    if (method < 0 || method >= MAX_METHODS)
+        return;
+
+    MethodCounters *counters = GetCounters(shard, method);
+    Increment(counters->calls, 1);
+    if (failed)
+        Increment(counters->errors, 1);
+    AddSample(counters->latency, ns);
+}
+
+void RpcMetrics::RecordError(int method)
+{
+    if (method < 0 || method >= MAX_METHODS)
+        return;
+    MethodCounters *counters = GetCounters(this->GetShard(), method);
+    Increment(counters->calls, 1);
+    Increment(counters->errors, 1);
+}
+
+void RpcMetrics::GetSnapshot(MetricsSnapshot &snapshot)
+{
+    for (int i = 0; i < METRICS_PHASES; i++)
+        snapshot.phases[i] = LatencyHistogram();
+    for (int i = 0; i < PRIORITY_CLASSES; i++)
+        snapshot.queues[i] = LatencyHistogram();
+
+    pthread_mutex_lock(&this->lock);
+    snapshot.methods.resize(this->methods.size());
+    for (size_t i = 0; i < this->methods.size(); i++)
+    {
+        snapshot.methods[i].name = this->methods[i];
+        snapshot.methods[i].calls = 0;
+        snapshot.methods[i].errors = 0;
+        snapshot.methods[i].latency = LatencyHistogram();
+    }
+    for (size_t i = 0; i < this->shards.size(); i++)
+    {
+        Shard *shard = this->shards[i];
+        for (int j = 0; j < METRICS_PHASES; j++)
+            Collect(shard->phases[j], snapshot.phases[j]);
+        for (int j = 0; j < PRIORITY_CLASSES; j++)
+            Collect(shard->queues[j], snapshot.queues[j]);
+        for (size_t j = 0; j < this->methods.size(); j++)
+        {
+            MethodCounters *counters = __atomic_load_n(&shard->methods[j], __ATOMIC_ACQUIRE);
+            if (counters == NULL)
+                continue;
+            snapshot.methods[j].calls += __atomic_load_n(&counters->calls, __ATOMIC_RELAXED);
+            snapshot.methods[j].errors += __atomic_load_n(&counters->errors, __ATOMIC_RELAXED);
+            Collect(counters->latency, snapshot.methods[j].latency);
+        }
+    }
+    pthread_mutex_unlock(&this->lock);
+}
+
+unsigned long long RpcMetrics::Now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+RpcMetrics::Shard* RpcMetrics::GetShard()
+{
+    Shard *shard = static_cast<Shard*>(pthread_getspecific(this->key));
+    if (shard != NULL)
+        return shard;
+
+    pthread_mutex_lock(&this->lock);
+    for (size_t i = 0; i < this->shards.size() && shard == NULL; i++)
+    {
+        if (!this->shards[i]->active)
+            shard = this->shards[i];
+    }
+    if (shard == NULL)
+    {
+        shard = new Shard();
+        shard->owner = this;
+        memset(shard->methods, 0, sizeof(shard->methods));
+        this->shards.push_back(shard);
+    }
+    shard->active = true;
+    pthread_mutex_unlock(&this->lock);
+
+    pthread_setspecific(this->key, shard);
+    return shard;
+}
+
+RpcMetrics::MethodCounters* RpcMetrics::GetCounters(Shard *shard, int method)
+{
+    MethodCounters *counters = shard->methods[method];
+    if (counters == NULL)
+    {
+        counters = new MethodCounters();
+        counters->calls = 0;
+        counters->errors = 0;
+        //Published with release semantics, a snapshot never sees the pointer before the zeroed counters.
+        __atomic_store_n(&shard->methods[method], counters, __ATOMIC_RELEASE);
+    }
+    return counters;
+}
+
+void RpcMetrics::ReleaseShard(void *p)
+{
+    Shard *shard = static_cast<Shard*>(p);
+    pthread_mutex_lock(&shard->owner->lock);
+    shard->active = false;
+    pthread_mutex_unlock(&shard->owner->lock);
+}
+
+void RpcMetrics::Increment(unsigned long long &counter, unsigned long long value)
+{
+    //Only the owning thread writes a shard, so a load and a store suffice. Both are atomic, a snapshot never reads half a value.
+    __atomic_store_n(&counter, __atomic_load_n(&counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}
+
+void RpcMetrics::AddSample(LatencyHistogram &histogram, unsigned long long ns)
+{
+    Increment(histogram.counts[LatencyHistogram::GetBucket(ns)], 1);
+    Increment(histogram.count, 1);
+    Increment(histogram.sum, ns);
+    if (ns > __atomic_load_n(&histogram.max, __ATOMIC_RELAXED))
+        __atomic_store_n(&histogram.max, ns, __ATOMIC_RELAXED);
+}
+
+void RpcMetrics::Collect(const LatencyHistogram &source, LatencyHistogram &target)
+{
+    for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
+        target.counts[i] += __atomic_load_n(&source.counts[i], __ATOMIC_RELAXED);
+    target.count += __atomic_load_n(&source.count, __ATOMIC_RELAXED);
+    target.sum += __atomic_load_n(&source.sum, __ATOMIC_RELAXED);
+    unsigned long long max = __atomic_load_n(&source.max, __ATOMIC_RELAXED);
+    if (max > target.max)
+        target.max = max;
+}
@@ -0,0 +1,224 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    rpcmetrics.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_RPCMETRICS_H_
+#define JSONRPC_CPP_RPCMETRICS_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <jsonrpccpp/common/jsonparser.h>
+#include <jsonrpccpp/common/specification.h>
+
+#define METRICS_METHOD_NAME "rpc.metrics"
+
+namespace jsonrpc
+{
+    /**
+     * The phases of handling a request that are timed separately.
+     */
+    typedef enum
+    {
+        METRICS_READ,       /*!< Receiving a request, from its first byte to its last*/
+        METRICS_PARSE,
+        METRICS_VALIDATE,
+        METRICS_EXECUTE,    /*!< Running the procedure*/
+        METRICS_SERIALIZE,  /*!< Writing the response, this includes socket writes if the connector streams it*/
+        METRICS_WRITE,      /*!< Sending the response or what the connector still buffers of it*/
+        METRICS_REQUEST,    /*!< From handing a received request to the protocol handler until its response has been sent*/
+        METRICS_PHASES
+    } metricsPhase_t;
+
+    /**
+     * Counts durations in nanoseconds in log-linear buckets like an HDR histogram: values below 16 ns are exact,
+     * above that each power of two is split into 8 buckets, so any percentile is reported within 12.5%.
+     * Durations above 2^40 ns (18 minutes) are counted in the last bucket.
+     */
+    class LatencyHistogram
+    {
+        public:
+            static const int BUCKETS = 16 + 36 * 8;
+
+            LatencyHistogram();
+
+            void Record(unsigned long long ns);
+            void Add(const LatencyHistogram& other);
+
+            unsigned long long GetCount() const;
+            unsigned long long GetSum() const;
+            unsigned long long GetMax() const;
+            unsigned long long GetBucketCount(int bucket) const;
+
+            /**
+             * @param percentile - between 0 and 100.
+             * @return the upper limit of the bucket holding the percentile, at most GetMax(). 0 if nothing has been recorded.
+             */
+            unsigned long long GetPercentile(double percentile) const;
+
+            static int GetBucket(unsigned long long ns);
+
+            /**
+             * @return the largest duration counted in a bucket.
+             */
+            static unsigned long long GetBucketLimit(int bucket);
+
+            /**
+             * @brief Summarizes the histogram as count, sum_ns, max_ns and the percentiles p50_ns, p90_ns, p99_ns and p999_ns.
+             */
+            void ToJson(Json::Value& target) const;
+
+        private:
+            friend class RpcMetrics;
+
+            unsigned long long counts[BUCKETS];
+            unsigned long long count;
+            unsigned long long sum;
+            unsigned long long max;
+    };
+
+    struct MethodMetrics
+    {
+        std::string         name;
+        unsigned long long  calls;
+        unsigned long long  errors;     /*!< Calls rejected for their parameters or failed with an exception*/
+        LatencyHistogram    latency;    /*!< Execution time of the calls*/
+    };
+
+    struct MetricsSnapshot
+    {
+        LatencyHistogram            phases[METRICS_PHASES];
+        LatencyHistogram            queues[PRIORITY_CLASSES];   /*!< Time requests waited for a worker, by lane*/
+        std::vector<MethodMetrics>  methods;
+
+        /**
+         * @brief Builds the result of the rpc.metrics method, an object with the members phases, queues and methods.
+         */
+        void ToJson(Json::Value& target) const;
+
+        /**
+         * @return the name of a phase in the result of rpc.metrics, e.g. "parse".
+         */
+        static const char* GetPhaseName(metricsPhase_t phase);
+
+        /**
+         * @return the name of a lane in the result of rpc.metrics, e.g. "high".
+         */
+        static const char* GetQueueName(priority_t priority);
+    };
+
+    /**
+     * Collects request counts and latencies of a server, see AbstractServer::SetMetrics.
+     *
+     * Every thread that records gets its own set of counters, which only it writes, so recording takes neither a lock nor
+     * an atomic read-modify-write. A snapshot adds up the counters of all threads. The counters of a thread that has
+     * ended are taken over by the next thread that records, so they are never lost.
+     * Handlers check for a metrics object before they read the clock, a server without one pays a pointer comparison.
+     */
+    class RpcMetrics
+    {
+        public:
+            static const int MAX_METHODS = 1024;
+
+            RpcMetrics();
+
+            /**
+             * Must not be destroyed while a server records into it.
+             */
+            ~RpcMetrics();
+
+            /**
+             * @brief Pauses or resumes recording, e.g. to reduce the overhead of a loaded server. Enabled initially.
+             */
+            void SetEnabled(bool enabled);
+            bool IsEnabled() const;
+
+            /**
+             * @return the slot of a procedure, the same for the same name. -1 if MAX_METHODS procedures are registered.
+             */
+            int RegisterMethod(const std::string& name);
+
+            void Record(metricsPhase_t phase, unsigned long long ns);
+
+            /**
+             * @brief Records the time a request of a lane waited in the queue of an executor.
+             */
+            void RecordQueue(priority_t priority, unsigned long long ns);
+
+            /**
+             * @brief Records the execution of a call as METRICS_EXECUTE and for its method.
+             * @param method - the slot of the procedure, -1 to only record the phase.
+             */
+            void RecordCall(int method, unsigned long long ns, bool failed);
+
+            /**
+             * @brief Counts a call that failed before it was executed.
+             */
+            void RecordError(int method);
+
+            void GetSnapshot(MetricsSnapshot& snapshot);
+
+            /**
+             * @return a monotonic clock in nanoseconds.
+             */
+            static unsigned long long Now();
+
+            /**
+             * @return the current time if metrics is not NULL and enabled, 0 otherwise.
+             */
+            static unsigned long long Start(RpcMetrics* metrics)
+            {
+                return (metrics != NULL && metrics->IsEnabled()) ? Now() : 0;
+            }
+
+            /**
+             * @brief Records the time since started, if Start() has returned a time.
+             */
+            static void Stop(RpcMetrics* metrics, metricsPhase_t phase, unsigned long long started)
+            {
+                if (started != 0)
+                    metrics->Record(phase, Now() - started);
+            }
+
+            static void StopCall(RpcMetrics* metrics, int method, unsigned long long started, bool failed)
+            {
+                if (started != 0)
+                    metrics->RecordCall(method, Now() - started, failed);
+            }
+
+            static void StopQueue(RpcMetrics* metrics, priority_t priority, unsigned long long started)
+            {
+                if (started != 0)
+                    metrics->RecordQueue(priority, Now() - started);
+            }
+
+        private:
+            struct MethodCounters;
+            struct Shard;
+
+            bool enabled;
+            pthread_key_t key;
+            pthread_mutex_t lock;                   /*!< Protects shards, the active flags and methods*/
+            std::vector<Shard*> shards;
+            std::map<std::string, int> slots;
+            std::vector<std::string> methods;       /*!< Names by slot*/
+
+            Shard* GetShard();
+            static MethodCounters* GetCounters(Shard* shard, int method);
+            static void ReleaseShard(void* shard);
+
+            static void Increment(unsigned long long& counter, unsigned long long value);
+            static void AddSample(LatencyHistogram& histogram, unsigned long long ns);
+            static void Collect(const LatencyHistogram& source, LatencyHistogram& target);
+
+            RpcMetrics(const RpcMetrics&);
+            RpcMetrics& operator=(const RpcMetrics&);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_RPCMETRICS_H_ */
@@ -14,17 +14,125 @@ using namespace jsonrpc;
 
 RpcProtocolServer12::RpcProtocolServer12(IProcedureInvokationHandler &handler) :
     rpc1(handler),
-    rpc2(handler)
+    rpc2(handler),
+    metrics(NULL)
 {
 }
 
-void RpcProtocolServer12::AddProcedure(const Procedure &procedure)
+void RpcProtocolServer12::AddProcedure(const Procedure &procedure, int binding)
 {
-    this->rpc1.AddProcedure(procedure);
-    this->rpc2.AddProcedure(procedure);
+    this->rpc1.AddProcedure(procedure, binding);
+    this->rpc2.AddProcedure(procedure, binding);
+}
+
+void RpcProtocolServer12::SetBatchExecutor(ThreadPool *executor)
+{
+    this->rpc2.SetBatchExecutor(executor);
+}
+
+bool RpcProtocolServer12::GetBatchStatistics(BatchStatistics &statistics)
+{
+    return this->rpc2.GetBatchStatistics(statistics);
+}
+
+void RpcProtocolServer12::SetMetrics(RpcMetrics *metrics)
+{
+    this->metrics = metrics;
+    this->rpc1.SetMetrics(metrics);
+    this->rpc2.SetMetrics(metrics);
+}
+
+void RpcProtocolServer12::SetResponseCache(ResponseCache *cache)
+{
+    this->rpc1.SetResponseCache(cache);
+    this->rpc2.SetResponseCache(cache);
+}
+
+void RpcProtocolServer12::EnableSubscriptions()
+{
+    this->rpc1.EnableSubscriptions();
+    this->rpc2.EnableSubscriptions();
+}
+
+priority_t RpcProtocolServer12::GetRequestPriority(const char *begin, const char *end)
+{
+    //Both handlers know the same procedures.
+    return this->rpc2.GetRequestPriority(begin, end);
 }
 
 void RpcProtocolServer12::HandleRequest(const std::string &request, std::string &retValue)
+{
+    this->HandleRequest(request.data(), request.data() + request.size(), retValue);
+}
+
+void RpcProtocolServer12::HandleRequest(const char *begin, const char *end, std::string &retValue)
+{
+    Json::Value req;
+    Json::Value resp;
+    Json::FastWriter w;
+
+    unsigned long long started = RpcMetrics::Start(this->metrics);
+    bool parsed = AbstractProtocolHandler::ParseRequest(begin, end, req);
+    RpcMetrics::Stop(this->metrics, METRICS_PARSE, started);
+    if (parsed && this->GetHandler(req).FindCachedResponse(req, retValue))
+    {
+        retValue += '\n';
+        return;
+    }
+    if (parsed)
+    {
+        this->GetHandler(req).HandleJsonRequest(req, resp);
+        AbstractProtocolHandler::ForgetCacheMiss();
+    }
+    else
+    {
+        this->GetHandler(req).WrapError(Json::nullValue, Errors::ERROR_RPC_JSON_PARSE_ERROR, Errors::GetErrorMessage(Errors::ERROR_RPC_JSON_PARSE_ERROR), resp);
+    }
+    if (resp != Json::nullValue)
+    {
+        started = RpcMetrics::Start(this->metrics);
+        retValue = w.write(resp);
+        RpcMetrics::Stop(this->metrics, METRICS_SERIALIZE, started);
+    }
+}
+
+void RpcProtocolServer12::HandleRequest(const char *begin, const char *end, std::ostream &response)
+{
+    Json::Value req;
+    Json::Value resp;
+
+    unsigned long long started = RpcMetrics::Start(this->metrics);
+    bool parsed = AbstractProtocolHandler::ParseRequest(begin, end, req);
+    RpcMetrics::Stop(this->metrics, METRICS_PARSE, started);
+    std::string cached;
+    if (parsed && this->GetHandler(req).FindCachedResponse(req, cached))
+    {
+        response << cached;
+        return;
+    }
+    if (parsed)
+    {
+        this->GetHandler(req).HandleJsonRequest(req, resp);
+        AbstractProtocolHandler::ForgetCacheMiss();
+    }
+    else
+    {
+        this->GetHandler(req).WrapError(Json::nullValue, Errors::ERROR_RPC_JSON_PARSE_ERROR, Errors::GetErrorMessage(Errors::ERROR_RPC_JSON_PARSE_ERROR), resp);
+    }
+    if (resp != Json::nullValue)
+    {
+        started = RpcMetrics::Start(this->metrics);
+        AbstractProtocolHandler::WriteResponse(resp, response);
+        RpcMetrics::Stop(this->metrics, METRICS_SERIALIZE, started);
+    }
+}
+
+void RpcProtocolServer12::HandleJsonRequest(const Json::Value &request, Json::Value &response)
+{
+    this->GetHandler(request).HandleJsonRequest(request, response);
+}
+
+void RpcProtocolServer12::HandleRejectedRequest(const std::string &request, int code, std::string &retValue)
 {
     Json::Reader reader;
     Json::Value req;
@@ -33,7 +141,7 @@ void RpcProtocolServer12::HandleRequest(const std::string &request, std::string
 
     if (reader.parse(request, req, false))
     {
-        this->GetHandler(req).HandleJsonRequest(req, resp);
+        this->GetHandler(req).RejectJsonRequest(req, code, resp);
     }
     else
     {
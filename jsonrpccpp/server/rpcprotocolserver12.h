@@ -21,12 +21,23 @@ namespace jsonrpc {
         public:
             RpcProtocolServer12(IProcedureInvokationHandler &handler);
 
-            void AddProcedure(const Procedure& procedure);
+            void AddProcedure(const Procedure& procedure, int binding = -1);
             void HandleRequest(const std::string& request, std::string& retValue);
+            void HandleRequest(const char* begin, const char* end, std::string& retValue);
+            void HandleRequest(const char* begin, const char* end, std::ostream& response);
+            void HandleRejectedRequest(const std::string& request, int code, std::string& retValue);
+            void HandleJsonRequest(const Json::Value& request, Json::Value& response);
+            priority_t GetRequestPriority(const char* begin, const char* end);
+            void SetBatchExecutor(ThreadPool* executor);
+            bool GetBatchStatistics(BatchStatistics& statistics);
+            void SetMetrics(RpcMetrics* metrics);
+            void SetResponseCache(ResponseCache* cache);
+            void EnableSubscriptions();
 
         private:
             RpcProtocolServerV1 rpc1;
             RpcProtocolServerV2 rpc2;
+            RpcMetrics *metrics;
 
             AbstractProtocolHandler& GetHandler(const Json::Value& request);
     };
@@ -22,12 +22,13 @@ void RpcProtocolServerV1::HandleJsonRequest(const Json::Value &req, Json::Value
 {
     if (req.isObject())
     {
-        int error = this->ValidateRequest(req);
+        DispatchEntry *entry = NULL;
+        int error = this->ValidateRequest(req, entry);
         if (error == 0)
         {
             try
             {
-                this->ProcessRequest(req, response);
+                this->ProcessRequest(req, *entry, response);
             }
             catch (const JsonRpcException & exc)
             {
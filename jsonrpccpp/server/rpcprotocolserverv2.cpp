@@ -8,15 +8,242 @@
  ************************************************************************/
 
 #include "rpcprotocolserverv2.h"
+#include "callcontext.h"
 #include <jsonrpccpp/common/errors.h>
 #include <iostream>
+#include <string.h>
+#include <time.h>
 
 using namespace std;
 using namespace jsonrpc;
 
+static unsigned long long ElapsedUs(const struct timespec &from, const struct timespec &to)
+{
+    return (to.tv_sec - from.tv_sec) * 1000000ULL + to.tv_nsec / 1000 - from.tv_nsec / 1000;
+}
+
+/**
+ * The calls of one batch. The thread handling the batch and any helper that a worker of the batch executor
+ * runs take the next unclaimed call until a range is exhausted. The handling thread never waits for a helper
+ * that has not started, so a batch cannot dead lock even if it is handled by a worker of the same pool.
+ * Helpers execute their calls in the CallContext of the handling thread, which outlives all of them.
+ * A helper may start only after its range is done and join a later one, serialized calls are therefore never
+ * published as a range but executed by the handling thread itself, see RunSerialized().
+ * The job is deleted by whoever releases it last.
+ */
+class RpcProtocolServerV2::BatchJob
+{
+    public:
+        BatchJob(RpcProtocolServerV2 *server, const Json::Value &requests) :
+            server(server),
+            requests(requests),
+            entries(requests.size(), NULL),
+            errors(requests.size(), 0),
+            responses(requests.size()),
+            durations(requests.size(), 0),
+            next(0),
+            end(0),
+            running(0),
+            references(1),
+            context(CallContext::GetCurrent())
+        {
+            pthread_mutex_init(&this->lock, NULL);
+            pthread_cond_init(&this->idle, NULL);
+            for (unsigned int i = 0; i < requests.size(); i++)
+                this->errors[i] = server->ValidateRequest(requests[i], this->entries[i]);
+        }
+
+        ~BatchJob()
+        {
+            pthread_cond_destroy(&this->idle);
+            pthread_mutex_destroy(&this->lock);
+        }
+
+        size_t Size() const
+        {
+            return this->responses.size();
+        }
+
+        bool IsSerialized(size_t i) const
+        {
+            return this->entries[i] != NULL && this->entries[i]->procedure.IsSerialized();
+        }
+
+        /**
+         * @return the most urgent priority of the calls [begin, end), helpers are queued in its lane.
+         */
+        priority_t GetPriority(size_t begin, size_t end) const
+        {
+            priority_t priority = PRIORITY_BULK;
+            for (size_t i = begin; i < end; i++)
+            {
+                priority_t called = (this->entries[i] != NULL) ? this->entries[i]->procedure.GetPriority() : PRIORITY_NORMAL;
+                if (called < priority)
+                    priority = called;
+            }
+            return priority;
+        }
+
+        /**
+         * Executes the calls [begin, end) and returns when all of them are done.
+         */
+        void Run(size_t begin, size_t end, ThreadPool *executor)
+        {
+            pthread_mutex_lock(&this->lock);
+            this->next = begin;
+            this->end = end;
+            pthread_mutex_unlock(&this->lock);
+
+            if (executor != NULL && end - begin > 1)
+            {
+                size_t helpers = end - begin - 1;
+                if (helpers > executor->GetThreadCount())
+                    helpers = executor->GetThreadCount();
+                priority_t priority = this->GetPriority(begin, end);
+                for (size_t i = 0; i < helpers; i++)
+                {
+                    IThreadPoolTask *helper = this->CreateHelper();
+                    if (!executor->TrySubmit(helper, priority))
+                    {
+                        delete helper;
+                        break;
+                    }
+                }
+            }
+
+            this->Work();
+            pthread_mutex_lock(&this->lock);
+            while (this->running > 0)
+                pthread_cond_wait(&this->idle, &this->lock);
+            pthread_mutex_unlock(&this->lock);
+        }
+
+        /**
+         * Executes the serialized call i on the handling thread, for which the connector knows the connection.
+         * The previous range is exhausted, so no helper can claim the call or run beside it.
+         */
+        void RunSerialized(size_t i)
+        {
+            this->Execute(i);
+        }
+
+        void Work()
+        {
+            CallContext *previous = CallContext::Enter(this->context);
+            pthread_mutex_lock(&this->lock);
+            while (this->next < this->end)
+            {
+                size_t i = this->next++;
+                this->running++;
+                pthread_mutex_unlock(&this->lock);
+                this->Execute(i);
+                pthread_mutex_lock(&this->lock);
+                this->running--;
+            }
+            if (this->running == 0)
+                pthread_cond_broadcast(&this->idle);
+            pthread_mutex_unlock(&this->lock);
+            CallContext::Enter(previous);
+        }
+
+        void Execute(size_t i)
+        {
+            struct timespec start, stop;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            this->server->ExecuteRequest(this->requests[(unsigned int)i], this->entries[i], this->errors[i], this->responses[i]);
+            clock_gettime(CLOCK_MONOTONIC, &stop);
+            this->durations[i] = ElapsedUs(start, stop);
+        }
+
+        void CollectResponses(Json::Value &response, unsigned long long &callUs)
+        {
+            callUs = 0;
+            for (size_t i = 0; i < this->responses.size(); i++)
+            {
+                callUs += this->durations[i];
+                if (this->responses[i] != Json::nullValue)
+                    response.append(this->responses[i]);
+            }
+        }
+
+        void Release()
+        {
+            pthread_mutex_lock(&this->lock);
+            bool last = --this->references == 0;
+            pthread_mutex_unlock(&this->lock);
+            if (last)
+                delete this;
+        }
+
+    private:
+        RpcProtocolServerV2             *server;
+        const Json::Value               &requests;
+        std::vector<DispatchEntry*>     entries;
+        std::vector<int>                errors;
+        std::vector<Json::Value>        responses;
+        std::vector<unsigned long long> durations;
+
+        size_t next;            /*!< The next call to claim*/
+        size_t end;             /*!< The end of the range being executed*/
+        unsigned int running;   /*!< Calls claimed but not finished*/
+        unsigned int references;
+        pthread_mutex_t lock;
+        pthread_cond_t idle;
+        CallContext *context;   /*!< The request of the batch, NULL if not handled by a connector*/
+
+        IThreadPoolTask* CreateHelper();
+};
+
+class RpcProtocolServerV2::BatchHelper : public IThreadPoolTask
+{
+    public:
+        BatchHelper(BatchJob *job) :
+            job(job)
+        {
+        }
+
+        void Run()
+        {
+            job->Work();
+            job->Release();
+        }
+
+    private:
+        BatchJob *job;
+};
+
+IThreadPoolTask *RpcProtocolServerV2::BatchJob::CreateHelper()
+{
+    pthread_mutex_lock(&this->lock);
+    this->references++;
+    pthread_mutex_unlock(&this->lock);
+    return new BatchHelper(this);
+}
+
 RpcProtocolServerV2::RpcProtocolServerV2(IProcedureInvokationHandler &handler) :
-    AbstractProtocolHandler(handler)
+    AbstractProtocolHandler(handler),
+    batchExecutor(NULL)
+{
+    memset(&this->batchStatistics, 0, sizeof(this->batchStatistics));
+    pthread_mutex_init(&this->batchLock, NULL);
+}
+
+RpcProtocolServerV2::~RpcProtocolServerV2()
 {
+    pthread_mutex_destroy(&this->batchLock);
+}
+
+void RpcProtocolServerV2::SetBatchExecutor(ThreadPool *executor)
+{
+    this->batchExecutor = executor;
+}
+
+bool RpcProtocolServerV2::GetBatchStatistics(BatchStatistics &statistics)
+{
+    pthread_mutex_lock(&this->batchLock);
+    statistics = this->batchStatistics;
+    pthread_mutex_unlock(&this->batchLock);
+    return true;
 }
 
 void RpcProtocolServerV2::HandleJsonRequest       (const Json::Value &req, Json::Value &response)
@@ -37,12 +264,17 @@ void RpcProtocolServerV2::HandleJsonRequest       (const Json::Value &req, Json:
 }
 void RpcProtocolServerV2::HandleSingleRequest (const Json::Value &req, Json::Value& response)
 {
-    int error = this->ValidateRequest(req);
+    DispatchEntry *entry = NULL;
+    int error = this->ValidateRequest(req, entry);
+    this->ExecuteRequest(req, entry, error, response);
+}
+void RpcProtocolServerV2::ExecuteRequest      (const Json::Value &req, DispatchEntry *entry, int error, Json::Value& response)
+{
     if (error == 0)
     {
         try
         {
-            this->ProcessRequest(req, response);
+            this->ProcessRequest(req, *entry, response);
         }
         catch (const JsonRpcException & exc)
         {
@@ -60,13 +292,41 @@ void RpcProtocolServerV2::HandleBatchRequest  (const Json::Value &req, Json::Val
         this->WrapError(Json::nullValue, Errors::ERROR_RPC_INVALID_REQUEST, Errors::GetErrorMessage(Errors::ERROR_RPC_INVALID_REQUEST), response);
     else
     {
-        for (unsigned int i = 0; i < req.size(); i++)
+        struct timespec start, stop;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        //Runs of calls between serialized procedures execute in parallel, a serialized procedure runs alone.
+        BatchJob *job = new BatchJob(this, req);
+        size_t begin = 0;
+        while (begin < job->Size())
         {
-            Json::Value result;
-            this->HandleSingleRequest(req[i], result);
-            if (result != Json::nullValue)
-                response.append(result);
+            if (job->IsSerialized(begin))
+            {
+                job->RunSerialized(begin);
+                begin++;
+                continue;
+            }
+            size_t end = begin + 1;
+            while (end < job->Size() && !job->IsSerialized(end))
+                end++;
+            job->Run(begin, end, this->batchExecutor);
+            begin = end;
         }
+
+        unsigned long long callUs = 0;
+        job->CollectResponses(response, callUs);
+        job->Release();
+
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+        unsigned long long wallUs = ElapsedUs(start, stop);
+        pthread_mutex_lock(&this->batchLock);
+        this->batchStatistics.batches++;
+        this->batchStatistics.calls += req.size();
+        this->batchStatistics.wallUs += wallUs;
+        this->batchStatistics.callUs += callUs;
+        this->batchStatistics.lastWallUs = wallUs;
+        this->batchStatistics.lastCallUs = callUs;
+        pthread_mutex_unlock(&this->batchLock);
     }
 }
 bool RpcProtocolServerV2::ValidateRequestFields(const Json::Value &request)
@@ -14,8 +14,11 @@
 #include <vector>
 #include <map>
 
+#include <pthread.h>
+
 #include <jsonrpccpp/common/exception.h>
 #include "abstractprotocolhandler.h"
+#include "threadpool.h"
 
 
 #define KEY_REQUEST_VERSION     "jsonrpc"
@@ -27,6 +30,7 @@ namespace jsonrpc
     {
         public:
             RpcProtocolServerV2(IProcedureInvokationHandler &handler);
+            virtual ~RpcProtocolServerV2();
 
             void HandleJsonRequest(const Json::Value& request, Json::Value& response);
             bool ValidateRequestFields(const Json::Value &val);
@@ -35,9 +39,20 @@ namespace jsonrpc
             void WrapException(const Json::Value& request, const JsonRpcException &exception, Json::Value& result);
             procedure_t GetRequestType(const Json::Value& request);
 
+            void SetBatchExecutor(ThreadPool* executor);
+            bool GetBatchStatistics(BatchStatistics& statistics);
+
         private:
+            class BatchJob;
+            class BatchHelper;
+
+            ThreadPool *batchExecutor;
+            BatchStatistics batchStatistics;
+            pthread_mutex_t batchLock;
+
             void HandleSingleRequest(const Json::Value& request, Json::Value& response);
             void HandleBatchRequest(const Json::Value& requests, Json::Value& response);
+            void ExecuteRequest(const Json::Value& request, DispatchEntry* entry, int error, Json::Value& response);
     };
 
 } /* namespace jsonrpc */
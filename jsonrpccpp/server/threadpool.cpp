@@ -0,0 +1,224 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    threadpool.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "threadpool.h"
+#include <string.h>
+
+using namespace jsonrpc;
+using namespace std;
+
+static unsigned long long ElapsedUs(const struct timespec &from, const struct timespec &to)
+{
+    return (to.tv_sec - from.tv_sec) * 1000000ULL + to.tv_nsec / 1000 - from.tv_nsec / 1000;
+}
+
+ThreadPool::ThreadPool(unsigned int threads, unsigned int maxQueued, queueFullPolicy_t policy) :
+    threads(threads > 0 ? threads : 1),
+    maxQueued(maxQueued > 0 ? maxQueued : 1),
+    policy(policy),
+    running(false)
+{
+    memset(&this->statistics, 0, sizeof(this->statistics));
+    this->statistics.threads = this->threads;
+    this->statistics.maxQueued = this->maxQueued;
+    for (int i = 0; i < PRIORITY_CLASSES; i++)
+        this->statistics.lanes[i].limit = this->threads;
+    pthread_mutex_init(&this->lock, NULL);
+    pthread_cond_init(&this->notEmpty, NULL);
+    pthread_cond_init(&this->notFull, NULL);
+}
+
+ThreadPool::~ThreadPool()
+{
+    this->Stop();
+    pthread_cond_destroy(&this->notFull);
+    pthread_cond_destroy(&this->notEmpty);
+    pthread_mutex_destroy(&this->lock);
+}
+
+bool ThreadPool::Start()
+{
+    pthread_mutex_lock(&this->lock);
+    if (this->running)
+    {
+        pthread_mutex_unlock(&this->lock);
+        return false;
+    }
+    this->running = true;
+    pthread_mutex_unlock(&this->lock);
+
+    for (unsigned int i = 0; i < this->threads; i++)
+    {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, ThreadPool::LaunchWorker, this) != 0)
+        {
+            this->Stop();
+            return false;
+        }
+        this->workers.push_back(worker);
+    }
+    return true;
+}
+
+void ThreadPool::Stop()
+{
+    pthread_mutex_lock(&this->lock);
+    this->running = false;
+    pthread_cond_broadcast(&this->notEmpty);
+    pthread_cond_broadcast(&this->notFull);
+    pthread_mutex_unlock(&this->lock);
+
+    for (size_t i = 0; i < this->workers.size(); i++)
+    {
+        pthread_join(this->workers[i], NULL);
+    }
+    this->workers.clear();
+
+    //Workers drain the queues before leaving, this only catches a failed Start().
+    for (int i = 0; i < PRIORITY_CLASSES; i++)
+    {
+        while (!this->queues[i].empty())
+        {
+            delete this->queues[i].front().task;
+            this->queues[i].pop_front();
+        }
+        this->statistics.lanes[i].queueDepth = 0;
+    }
+    this->statistics.queueDepth = 0;
+}
+
+bool ThreadPool::Submit(IThreadPoolTask *task, priority_t priority)
+{
+    return this->Enqueue(task, priority, false);
+}
+
+bool ThreadPool::TrySubmit(IThreadPoolTask *task, priority_t priority)
+{
+    return this->Enqueue(task, priority, true);
+}
+
+void ThreadPool::SetLaneLimit(priority_t priority, unsigned int limit)
+{
+    pthread_mutex_lock(&this->lock);
+    this->statistics.lanes[priority].limit = (limit > 0 && limit < this->threads) ? limit : this->threads;
+    //Idle workers may now take tasks the old limit held back.
+    pthread_cond_broadcast(&this->notEmpty);
+    pthread_mutex_unlock(&this->lock);
+}
+
+bool ThreadPool::Enqueue(IThreadPoolTask *task, priority_t priority, bool optional)
+{
+    deque<QueuedTask> &queue = this->queues[priority];
+    pthread_mutex_lock(&this->lock);
+    while (this->running && !optional && this->policy == POOL_BLOCK_WHEN_FULL && queue.size() >= this->maxQueued)
+    {
+        pthread_cond_wait(&this->notFull, &this->lock);
+    }
+    if (!this->running || queue.size() >= this->maxQueued)
+    {
+        if (this->running && !optional)
+            this->statistics.rejected++;
+        pthread_mutex_unlock(&this->lock);
+        return false;
+    }
+    QueuedTask queued;
+    queued.task = task;
+    clock_gettime(CLOCK_MONOTONIC, &queued.enqueued);
+    queue.push_back(queued);
+    this->statistics.submitted++;
+    this->statistics.queueDepth++;
+    this->statistics.lanes[priority].submitted++;
+    this->statistics.lanes[priority].queueDepth = queue.size();
+    if (this->statistics.queueDepth > this->statistics.peakQueueDepth)
+        this->statistics.peakQueueDepth = this->statistics.queueDepth;
+    pthread_cond_signal(&this->notEmpty);
+    pthread_mutex_unlock(&this->lock);
+    return true;
+}
+
+unsigned int ThreadPool::GetThreadCount() const
+{
+    return this->threads;
+}
+
+void ThreadPool::GetStatistics(ThreadPoolStatistics &statistics)
+{
+    pthread_mutex_lock(&this->lock);
+    statistics = this->statistics;
+    pthread_mutex_unlock(&this->lock);
+}
+
+void* ThreadPool::LaunchWorker(void *p_data)
+{
+    ThreadPool *instance = reinterpret_cast<ThreadPool*>(p_data);
+    instance->WorkerLoop();
+    return NULL;
+}
+
+int ThreadPool::NextLane() const
+{
+    for (int i = 0; i < PRIORITY_CLASSES; i++)
+    {
+        if (!this->queues[i].empty() && this->statistics.lanes[i].active < this->statistics.lanes[i].limit)
+            return i;
+    }
+    return -1;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    pthread_mutex_lock(&this->lock);
+    while (true)
+    {
+        int lane = this->NextLane();
+        //Once stopped, a worker still waits for tasks that a lane limit holds back.
+        while (lane < 0 && (this->running || this->statistics.queueDepth > 0))
+        {
+            pthread_cond_wait(&this->notEmpty, &this->lock);
+            lane = this->NextLane();
+        }
+        if (lane < 0)
+        {
+            break;
+        }
+        ThreadPoolLaneStatistics &counters = this->statistics.lanes[lane];
+        QueuedTask queued = this->queues[lane].front();
+        this->queues[lane].pop_front();
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        unsigned long long waited = ElapsedUs(queued.enqueued, now);
+        this->statistics.queueDepth--;
+        this->statistics.totalWaitUs += waited;
+        if (waited > this->statistics.maxWaitUs)
+            this->statistics.maxWaitUs = waited;
+        this->statistics.active++;
+        counters.queueDepth = this->queues[lane].size();
+        counters.totalWaitUs += waited;
+        if (waited > counters.maxWaitUs)
+            counters.maxWaitUs = waited;
+        counters.active++;
+        //Submitters of all lanes wait on the same condition.
+        pthread_cond_broadcast(&this->notFull);
+        pthread_mutex_unlock(&this->lock);
+
+        queued.task->Run();
+        delete queued.task;
+
+        pthread_mutex_lock(&this->lock);
+        this->statistics.active--;
+        this->statistics.completed++;
+        counters.active--;
+        counters.completed++;
+        //A task the limit of this lane has held back may now run, and stopped workers must not wait for it forever.
+        if (!this->running)
+            pthread_cond_broadcast(&this->notEmpty);
+        else if (!this->queues[lane].empty())
+            pthread_cond_signal(&this->notEmpty);
+    }
+    pthread_mutex_unlock(&this->lock);
+}
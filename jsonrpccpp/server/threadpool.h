@@ -0,0 +1,150 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    threadpool.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_THREADPOOL_H_
+#define JSONRPC_CPP_THREADPOOL_H_
+
+#include <deque>
+#include <vector>
+#include <pthread.h>
+#include <time.h>
+#include <jsonrpccpp/common/specification.h>
+
+namespace jsonrpc
+{
+    /**
+     * A unit of work that can be handed to a ThreadPool.
+     * The pool takes ownership of submitted tasks and deletes them after Run() returns.
+     */
+    class IThreadPoolTask
+    {
+        public:
+            virtual ~IThreadPoolTask() {}
+            virtual void Run() = 0;
+    };
+
+    /**
+     * Defines what Submit() does when the queue of a ThreadPool is full.
+     */
+    typedef enum {POOL_BLOCK_WHEN_FULL, POOL_REJECT_WHEN_FULL} queueFullPolicy_t;
+
+    /**
+     * Counters of one lane of a ThreadPool, see ThreadPool::SetLaneLimit.
+     */
+    struct ThreadPoolLaneStatistics
+    {
+        unsigned int        limit;              /*!< most tasks of the lane running at once*/
+        unsigned int        queueDepth;         /*!< tasks of the lane currently waiting for a worker*/
+        unsigned int        active;             /*!< tasks of the lane currently running*/
+        unsigned long long  submitted;
+        unsigned long long  completed;
+        unsigned long long  totalWaitUs;        /*!< summed time tasks of the lane spent in the queue*/
+        unsigned long long  maxWaitUs;
+    };
+
+    /**
+     * Counters of a ThreadPool, used to size the pool for a workload.
+     */
+    struct ThreadPoolStatistics
+    {
+        unsigned int        threads;
+        unsigned int        maxQueued;
+        unsigned int        queueDepth;         /*!< tasks currently waiting for a worker*/
+        unsigned int        peakQueueDepth;     /*!< highest queueDepth seen*/
+        unsigned int        active;             /*!< tasks currently running*/
+        unsigned long long  submitted;          /*!< tasks accepted by Submit()*/
+        unsigned long long  rejected;           /*!< tasks refused because the queue was full*/
+        unsigned long long  completed;          /*!< tasks that finished running*/
+        unsigned long long  totalWaitUs;        /*!< summed time completed tasks spent in the queue*/
+        unsigned long long  maxWaitUs;          /*!< longest time a task spent in the queue*/
+        ThreadPoolLaneStatistics lanes[PRIORITY_CLASSES];
+    };
+
+    /**
+     * A fixed set of POSIX worker threads that execute tasks from bounded FIFO queues, one per priority class.
+     * A worker takes the oldest task of the most urgent lane that is below its limit, so a task of a higher class
+     * overtakes queued tasks of lower ones but never interrupts a running one.
+     */
+    class ThreadPool
+    {
+        public:
+            /**
+             * @param threads number of worker threads
+             * @param maxQueued maximum number of tasks waiting for a worker in each lane
+             * @param policy whether Submit() blocks or refuses the task while maxQueued tasks of its lane are waiting
+             */
+            ThreadPool(unsigned int threads, unsigned int maxQueued, queueFullPolicy_t policy = POOL_BLOCK_WHEN_FULL);
+            virtual ~ThreadPool();
+
+            /**
+             * @brief Spawns the worker threads.
+             * @return false if the pool is already running or a thread could not be created.
+             */
+            bool Start();
+
+            /**
+             * @brief Runs all queued tasks to completion and joins the worker threads.
+             */
+            void Stop();
+
+            /**
+             * @brief Queues a task in the lane of its priority. While the lane is full the caller is blocked or the task is refused,
+             * depending on the policy.
+             * @return false if the task was refused or the pool is not running, in which case the caller keeps ownership of the task.
+             */
+            bool Submit(IThreadPoolTask* task, priority_t priority = PRIORITY_NORMAL);
+
+            /**
+             * @brief Queues a task only if that does not block, whatever the policy. A refused task is not counted as rejected.
+             * Meant for optional work that the caller can do itself, e.g. from within a worker of the same pool.
+             */
+            bool TrySubmit(IThreadPoolTask* task, priority_t priority = PRIORITY_NORMAL);
+
+            /**
+             * @brief Bounds the tasks of a lane that run at once, e.g. so that bulk requests always leave workers for urgent ones.
+             * Queued tasks of a lane at its limit wait even if workers are idle. 0 or more than the threads lifts the limit,
+             * which is the default for every lane.
+             */
+            void SetLaneLimit(priority_t priority, unsigned int limit);
+
+            unsigned int GetThreadCount() const;
+
+            void GetStatistics(ThreadPoolStatistics& statistics);
+
+        private:
+            struct QueuedTask
+            {
+                IThreadPoolTask *task;
+                struct timespec enqueued;
+            };
+
+            unsigned int threads;
+            unsigned int maxQueued;
+            queueFullPolicy_t policy;
+            bool running;
+
+            std::deque<QueuedTask> queues[PRIORITY_CLASSES];
+            ThreadPoolStatistics statistics;
+            std::vector<pthread_t> workers;
+
+            pthread_mutex_t lock;
+            pthread_cond_t notEmpty;
+            pthread_cond_t notFull;
+
+            bool Enqueue(IThreadPoolTask* task, priority_t priority, bool optional);
+
+            /**
+             * @return the lane a worker takes its next task from, -1 if no lane with queued tasks is below its limit.
+             */
+            int NextLane() const;
+            static void* LaunchWorker(void *p_data);
+            void WorkerLoop();
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_THREADPOOL_H_ */
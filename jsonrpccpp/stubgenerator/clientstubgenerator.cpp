@@ -0,0 +1,81 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    clientstubgenerator.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "clientstubgenerator.h"
+
+using namespace jsonrpc;
+using namespace std;
+
+ClientStubGenerator::ClientStubGenerator(const string &stubname, const vector<Procedure> &procedures, ostream &out) :
+    StubGenerator(stubname, procedures, out)
+{
+}
+
+void ClientStubGenerator::WriteStub()
+{
+    const string &name = this->GetClassName();
+
+    this->WriteHeaderBegin("jsonrpccpp/client.h");
+    this->WriteLine("class " + name + " : public jsonrpc::Client");
+    this->WriteLine("{");
+    this->Indent();
+    this->WriteLine("public:");
+    this->Indent();
+
+    this->WriteLine(name + "(jsonrpc::IClientConnector &connector, jsonrpc::clientVersion_t type = jsonrpc::JSONRPC_CLIENT_V2) :");
+    this->WriteLine("    jsonrpc::Client(connector, type)");
+    this->WriteLine("{");
+    this->WriteLine("}");
+    for (size_t i = 0; i < this->procedures.size(); i++)
+        this->WriteProcedure(this->procedures[i]);
+
+    this->Unindent();
+    this->Unindent();
+    this->WriteLine("};");
+    this->WriteHeaderEnd();
+}
+
+void ClientStubGenerator::WriteProcedure(const Procedure &procedure)
+{
+    vector<string> names;
+    vector<jsontype_t> types;
+    GetParameters(procedure, names, types);
+
+    this->WriteLine("");
+    this->WriteLine(GetSignature(procedure) + " throw (jsonrpc::JsonRpcException)");
+    this->WriteLine("{");
+    this->Indent();
+    this->WriteLine("Json::Value p;");
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (procedure.GetParameterDeclarationType() == PARAMS_BY_NAME)
+            this->WriteLine("p[" + ToLiteral(names[i]) + "] = " + ToIdentifier(names[i]) + ";");
+        else
+            this->WriteLine("p.append(" + ToIdentifier(names[i]) + ");");
+    }
+
+    const string method = ToLiteral(procedure.GetProcedureName());
+    if (procedure.GetProcedureType() == RPC_NOTIFICATION)
+    {
+        this->WriteLine("this->CallNotification(" + method + ", p);");
+    }
+    else
+    {
+        jsontype_t type = procedure.GetReturnType();
+        this->WriteLine("Json::Value result;");
+        this->WriteLine("this->CallMethod(" + method + ", p, result);");
+        this->WriteLine("if (!result" + GetTypeCheck(type) + ")");
+        this->WriteLine("    throw jsonrpc::JsonRpcException(jsonrpc::Errors::ERROR_CLIENT_INVALID_RESPONSE, result.toStyledString());");
+        if (type == JSON_OBJECT || type == JSON_ARRAY)
+            this->WriteLine("return result;");
+        else
+            this->WriteLine("return result" + GetConversion(type) + ";");
+    }
+    this->Unindent();
+    this->WriteLine("}");
+}
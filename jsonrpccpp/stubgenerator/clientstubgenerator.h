@@ -0,0 +1,33 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    clientstubgenerator.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_CLIENTSTUBGENERATOR_H_
+#define JSONRPC_CPP_CLIENTSTUBGENERATOR_H_
+
+#include "stubgenerator.h"
+
+namespace jsonrpc
+{
+    /**
+     * Generates a Client with a method for every procedure. A result of the wrong type is reported as
+     * ERROR_CLIENT_INVALID_RESPONSE.
+     */
+    class ClientStubGenerator : public StubGenerator
+    {
+        public:
+            ClientStubGenerator(const std::string& stubname, const std::vector<Procedure>& procedures, std::ostream& out);
+
+        protected:
+            virtual void WriteStub();
+
+        private:
+            void WriteProcedure(const Procedure& procedure);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_CLIENTSTUBGENERATOR_H_ */
@@ -0,0 +1,100 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    main.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include <jsonrpccpp/common/specificationparser.h>
+#include "serverstubgenerator.h"
+#include "clientstubgenerator.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace jsonrpc;
+using namespace std;
+
+static void PrintUsage()
+{
+    cerr << "Usage: jsonrpcstub <specfile.json> [--cpp-server=<class>] [--cpp-server-file=<file>]" << endl;
+    cerr << "                   [--cpp-client=<class>] [--cpp-client-file=<file>]" << endl;
+    cerr << endl;
+    cerr << "Generates a typed C++ server and client stub from a procedure specification." << endl;
+    cerr << "Class names may contain namespaces like ns::Stub, the files default to the lower case class name with \".h\" appended." << endl;
+}
+
+static bool GetOption(const string &argument, const string &name, string &value)
+{
+    string prefix = "--" + name + "=";
+    if (argument.compare(0, prefix.size(), prefix) != 0)
+        return false;
+    value = argument.substr(prefix.size());
+    return true;
+}
+
+static bool WriteFile(const stringstream &content, const string &filename)
+{
+    ofstream file(filename.c_str(), ios::out | ios::trunc);
+    file << content.str();
+    file.close();
+    if (!file)
+    {
+        cerr << "jsonrpcstub: could not write " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    string specfile;
+    string serverName, serverFile, clientName, clientFile;
+    for (int i = 1; i < argc; i++)
+    {
+        string argument = argv[i];
+        if (GetOption(argument, "cpp-server", serverName) || GetOption(argument, "cpp-server-file", serverFile) ||
+            GetOption(argument, "cpp-client", clientName) || GetOption(argument, "cpp-client-file", clientFile))
+            continue;
+        if (argument.compare(0, 2, "--") == 0 || !specfile.empty())
+        {
+            PrintUsage();
+            return 1;
+        }
+        specfile = argument;
+    }
+    if (specfile.empty() || (serverName.empty() && clientName.empty()))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    try
+    {
+        vector<Procedure> procedures = SpecificationParser::GetProceduresFromFile(specfile);
+        if (!serverName.empty())
+        {
+            stringstream content;
+            ServerStubGenerator generator(serverName, procedures, content);
+            generator.Generate();
+            if (!WriteFile(content, serverFile.empty() ? StubGenerator::GetFileName(serverName) : serverFile))
+                return 1;
+        }
+        if (!clientName.empty())
+        {
+            stringstream content;
+            ClientStubGenerator generator(clientName, procedures, content);
+            generator.Generate();
+            if (!WriteFile(content, clientFile.empty() ? StubGenerator::GetFileName(clientName) : clientFile))
+                return 1;
+        }
+    }
+    catch (const JsonRpcException &e)
+    {
+        cerr << "jsonrpcstub: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
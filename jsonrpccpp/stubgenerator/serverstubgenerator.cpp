@@ -0,0 +1,165 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    serverstubgenerator.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "serverstubgenerator.h"
+#include <sstream>
+
+using namespace jsonrpc;
+using namespace std;
+
+ServerStubGenerator::ServerStubGenerator(const string &stubname, const vector<Procedure> &procedures, ostream &out) :
+    StubGenerator(stubname, procedures, out)
+{
+}
+
+void ServerStubGenerator::WriteStub()
+{
+    const string &name = this->GetClassName();
+    const string base = "jsonrpc::AbstractServer<" + name + ">";
+
+    this->WriteHeaderBegin("jsonrpccpp/server.h");
+    this->WriteLine("class " + name + " : public " + base);
+    this->WriteLine("{");
+    this->Indent();
+    this->WriteLine("public:");
+    this->Indent();
+
+    this->WriteLine(name + "(jsonrpc::AbstractServerConnector &connector, jsonrpc::serverVersion_t type = jsonrpc::JSONRPC_SERVER_V2) :");
+    this->WriteLine("    " + base + "(connector, type)");
+    this->WriteLine("{");
+    this->Indent();
+    this->WriteLine("//Methods and notifications are numbered independently, in the order they are added here, which InvokeMethod");
+    this->WriteLine("//and InvokeNotification rely on. Keep the order of each kind when editing this list.");
+    for (size_t i = 0; i < this->procedures.size(); i++)
+        this->WriteRegistration(this->procedures[i]);
+    this->Unindent();
+    this->WriteLine("}");
+
+    this->WriteLine("");
+    for (size_t i = 0; i < this->procedures.size(); i++)
+        this->WriteLine("virtual " + GetSignature(this->procedures[i]) + " = 0;");
+
+    this->WriteDispatch(RPC_METHOD);
+    this->WriteDispatch(RPC_NOTIFICATION);
+
+    this->Unindent();
+    this->Unindent();
+    this->WriteLine("};");
+    this->WriteHeaderEnd();
+}
+
+void ServerStubGenerator::WriteRegistration(const Procedure &procedure)
+{
+    string bind = (procedure.GetProcedureType() == RPC_METHOD) ? "this->bindAndAddMethod" : "this->bindAndAddNotification";
+    if (!procedure.IsSerialized() && procedure.GetCacheTtl() == 0 && procedure.GetPriority() == PRIORITY_NORMAL)
+    {
+        this->WriteLine(bind + "(" + GetConstruction(procedure) + ");");
+        return;
+    }
+    this->WriteLine("{");
+    this->Indent();
+    this->WriteLine("jsonrpc::Procedure procedure = " + GetConstruction(procedure) + ";");
+    if (procedure.IsSerialized())
+        this->WriteLine("procedure.SetSerialized(true);");
+    if (procedure.GetCacheTtl() != 0)
+    {
+        stringstream ttl;
+        ttl << procedure.GetCacheTtl();
+        this->WriteLine("procedure.SetCacheTtl(" + ttl.str() + ");");
+    }
+    if (procedure.GetPriority() == PRIORITY_HIGH)
+        this->WriteLine("procedure.SetPriority(jsonrpc::PRIORITY_HIGH);");
+    else if (procedure.GetPriority() == PRIORITY_BULK)
+        this->WriteLine("procedure.SetPriority(jsonrpc::PRIORITY_BULK);");
+    this->WriteLine(bind + "(procedure);");
+    this->Unindent();
+    this->WriteLine("}");
+}
+
+void ServerStubGenerator::WriteDispatch(procedure_t type)
+{
+    const string base = "jsonrpc::AbstractServer<" + this->GetClassName() + ">";
+
+    this->WriteLine("");
+    if (type == RPC_METHOD)
+        this->WriteLine("virtual void InvokeMethod(jsonrpc::Procedure &proc, int binding, const Json::Value &request, Json::Value &response)");
+    else
+        this->WriteLine("virtual void InvokeNotification(jsonrpc::Procedure &proc, int binding, const Json::Value &request)");
+    this->WriteLine("{");
+    this->Indent();
+    this->WriteLine("switch (binding)");
+    this->WriteLine("{");
+    this->Indent();
+
+    int binding = 0;
+    for (size_t i = 0; i < this->procedures.size(); i++)
+    {
+        if (this->procedures[i].GetProcedureType() != type)
+            continue;
+        stringstream label;
+        label << "case " << binding++ << ":";
+        this->WriteLine(label.str());
+        this->WriteLine("{");
+        this->Indent();
+        this->WriteCall(this->procedures[i]);
+        this->WriteLine("break;");
+        this->Unindent();
+        this->WriteLine("}");
+    }
+
+    //Procedures a subclass binds to member pointers come after the generated ones.
+    this->WriteLine("default:");
+    this->Indent();
+    if (type == RPC_METHOD)
+        this->WriteLine(base + "::InvokeMethod(proc, binding, request, response);");
+    else
+        this->WriteLine(base + "::InvokeNotification(proc, binding, request);");
+    this->Unindent();
+    this->Unindent();
+    this->WriteLine("}");
+    this->Unindent();
+    this->WriteLine("}");
+}
+
+void ServerStubGenerator::WriteCall(const Procedure &procedure)
+{
+    vector<string> names;
+    vector<jsontype_t> types;
+    GetParameters(procedure, names, types);
+
+    string rangeCheck;
+    string arguments;
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        string local = "arg_" + ToIdentifier(names[i]);
+        stringstream access;
+        if (procedure.GetParameterDeclarationType() == PARAMS_BY_NAME)
+            access << "request[" << ToLiteral(names[i]) << "]";
+        else
+            access << "request[" << i << "u]";
+        this->WriteLine("const Json::Value &" + local + " = " + access.str() + ";");
+
+        //The validation accepts any integral value, asInt() would throw for one that does not fit.
+        if (types[i] == JSON_INTEGER)
+            rangeCheck += (rangeCheck.empty() ? "!" : " || !") + local + ".isInt()";
+        if (i > 0)
+            arguments += ", ";
+        arguments += local + GetConversion(types[i]);
+    }
+    if (!rangeCheck.empty())
+    {
+        this->WriteLine("if (" + rangeCheck + ")");
+        this->WriteLine("    throw jsonrpc::JsonRpcException(jsonrpc::Errors::ERROR_RPC_INVALID_PARAMS);");
+    }
+
+    string call = "this->" + ToIdentifier(procedure.GetProcedureName()) + "(" + arguments + ");";
+    if (procedure.GetProcedureType() == RPC_METHOD)
+        this->WriteLine("response = " + call);
+    else
+        this->WriteLine(call);
+}
@@ -0,0 +1,38 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    serverstubgenerator.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_SERVERSTUBGENERATOR_H_
+#define JSONRPC_CPP_SERVERSTUBGENERATOR_H_
+
+#include "stubgenerator.h"
+
+namespace jsonrpc
+{
+    /**
+     * Generates an abstract server with a pure virtual method for every procedure.
+     *
+     * The procedures are registered in the constructor of the stub, so the binding the protocol handler passes with
+     * every call is known when the stub is generated. InvokeMethod and InvokeNotification switch over it and pass the
+     * parameters as native values, no member pointer or name lookup is involved once the request is validated.
+     */
+    class ServerStubGenerator : public StubGenerator
+    {
+        public:
+            ServerStubGenerator(const std::string& stubname, const std::vector<Procedure>& procedures, std::ostream& out);
+
+        protected:
+            virtual void WriteStub();
+
+        private:
+            void WriteRegistration(const Procedure& procedure);
+            void WriteDispatch(procedure_t type);
+            void WriteCall(const Procedure& procedure);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_SERVERSTUBGENERATOR_H_ */
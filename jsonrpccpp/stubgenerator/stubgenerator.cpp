@@ -0,0 +1,308 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    stubgenerator.cpp
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#include "stubgenerator.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <set>
+#include <sstream>
+
+using namespace jsonrpc;
+using namespace std;
+
+static const char *KEYWORDS[] = {
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch", "char",
+    "char16_t", "char32_t", "class", "compl", "const", "constexpr", "const_cast", "continue", "decltype", "default",
+    "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+    "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+    "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "return",
+    "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this",
+    "thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual",
+    "void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+    //Names the generated classes use or inherit.
+    "request", "response", "proc", "binding", "p", "result", "CallMethod", "CallNotification", "CallProcedures",
+    "InvokeMethod", "InvokeNotification", "HandleMethodCall", "HandleNotificationCall", "StartListening", "StopListening",
+    NULL
+};
+
+StubGenerator::StubGenerator(const string &stubname, const vector<Procedure> &procedures, ostream &out) :
+    procedures(procedures),
+    out(out),
+    indentation(0)
+{
+    size_t start = 0;
+    size_t pos;
+    while ((pos = stubname.find("::", start)) != string::npos)
+    {
+        this->namespaces.push_back(stubname.substr(start, pos - start));
+        start = pos + 2;
+    }
+    this->classname = stubname.substr(start);
+}
+
+StubGenerator::~StubGenerator()
+{
+}
+
+void StubGenerator::Generate() throw (JsonRpcException)
+{
+    this->CheckIdentifiers();
+    this->WriteStub();
+}
+
+string StubGenerator::GetFileName(const string &stubname)
+{
+    size_t pos = stubname.rfind("::");
+    string result = (pos == string::npos) ? stubname : stubname.substr(pos + 2);
+    for (size_t i = 0; i < result.size(); i++)
+        result[i] = static_cast<char>(tolower(static_cast<unsigned char>(result[i])));
+    return result + ".h";
+}
+
+const string& StubGenerator::GetClassName() const
+{
+    return this->classname;
+}
+
+void StubGenerator::WriteLine(const string &line)
+{
+    if (!line.empty())
+        this->out << string(this->indentation * 4, ' ') << line;
+    this->out << '\n';
+}
+
+void StubGenerator::Indent()
+{
+    this->indentation++;
+}
+
+void StubGenerator::Unindent()
+{
+    this->indentation--;
+}
+
+void StubGenerator::WriteHeaderBegin(const string &include)
+{
+    string guard = "JSONRPC_CPP_STUB_";
+    for (size_t i = 0; i < this->namespaces.size(); i++)
+        guard += this->namespaces[i] + "_";
+    guard += this->classname + "_H_";
+    for (size_t i = 0; i < guard.size(); i++)
+        guard[i] = static_cast<char>(toupper(static_cast<unsigned char>(guard[i])));
+
+    this->WriteLine("/**");
+    this->WriteLine(" * This file is generated by jsonrpcstub, do not change it.");
+    this->WriteLine(" */");
+    this->WriteLine("");
+    this->WriteLine("#ifndef " + guard);
+    this->WriteLine("#define " + guard);
+    this->WriteLine("");
+    this->WriteLine("#include <" + include + ">");
+    this->WriteLine("");
+    for (size_t i = 0; i < this->namespaces.size(); i++)
+    {
+        this->WriteLine("namespace " + this->namespaces[i]);
+        this->WriteLine("{");
+        this->Indent();
+    }
+}
+
+void StubGenerator::WriteHeaderEnd()
+{
+    for (size_t i = 0; i < this->namespaces.size(); i++)
+    {
+        this->Unindent();
+        this->WriteLine("}");
+    }
+    this->WriteLine("");
+    this->WriteLine("#endif");
+}
+
+void StubGenerator::GetParameters(const Procedure &procedure, vector<string> &names, vector<jsontype_t> &types)
+{
+    names.clear();
+    types.clear();
+    if (procedure.GetParameterDeclarationType() == PARAMS_BY_NAME)
+    {
+        const parameterNameList_t &parameters = procedure.GetParameters();
+        for (parameterNameList_t::const_iterator it = parameters.begin(); it != parameters.end(); ++it)
+        {
+            names.push_back(it->first);
+            types.push_back(it->second);
+        }
+    }
+    else
+    {
+        types = procedure.GetPositionalParameters();
+        for (size_t i = 0; i < types.size(); i++)
+        {
+            stringstream name;
+            name << "param" << (i + 1);
+            names.push_back(name.str());
+        }
+    }
+}
+
+string StubGenerator::ToIdentifier(const string &name)
+{
+    string result = name;
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        if (!isalnum(static_cast<unsigned char>(result[i])) && result[i] != '_')
+            result[i] = '_';
+    }
+    if (result.empty() || isdigit(static_cast<unsigned char>(result[0])))
+        result = "_" + result;
+    for (size_t i = 0; KEYWORDS[i] != NULL; i++)
+    {
+        if (result == KEYWORDS[i])
+            return result + "_";
+    }
+    return result;
+}
+
+string StubGenerator::GetNativeType(jsontype_t type)
+{
+    switch (type)
+    {
+        case JSON_STRING:   return "std::string";
+        case JSON_BOOLEAN:  return "bool";
+        case JSON_INTEGER:  return "int";
+        case JSON_REAL:     return "double";
+        default:            return "Json::Value";
+    }
+}
+
+string StubGenerator::GetParameterType(jsontype_t type)
+{
+    switch (type)
+    {
+        case JSON_STRING:   return "const std::string&";
+        case JSON_BOOLEAN:  return "bool";
+        case JSON_INTEGER:  return "int";
+        case JSON_REAL:     return "double";
+        default:            return "const Json::Value&";
+    }
+}
+
+string StubGenerator::GetJsonType(jsontype_t type)
+{
+    switch (type)
+    {
+        case JSON_STRING:   return "jsonrpc::JSON_STRING";
+        case JSON_BOOLEAN:  return "jsonrpc::JSON_BOOLEAN";
+        case JSON_INTEGER:  return "jsonrpc::JSON_INTEGER";
+        case JSON_REAL:     return "jsonrpc::JSON_REAL";
+        case JSON_OBJECT:   return "jsonrpc::JSON_OBJECT";
+        default:            return "jsonrpc::JSON_ARRAY";
+    }
+}
+
+string StubGenerator::GetConversion(jsontype_t type)
+{
+    switch (type)
+    {
+        case JSON_STRING:   return ".asString()";
+        case JSON_BOOLEAN:  return ".asBool()";
+        case JSON_INTEGER:  return ".asInt()";
+        case JSON_REAL:     return ".asDouble()";
+        default:            return "";
+    }
+}
+
+string StubGenerator::GetTypeCheck(jsontype_t type)
+{
+    switch (type)
+    {
+        case JSON_STRING:   return ".isString()";
+        case JSON_BOOLEAN:  return ".isBool()";
+        case JSON_INTEGER:  return ".isInt()";
+        case JSON_REAL:     return ".isDouble()";
+        case JSON_OBJECT:   return ".isObject()";
+        default:            return ".isArray()";
+    }
+}
+
+string StubGenerator::ToLiteral(const string &text)
+{
+    string result = "\"";
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += text[i];
+        }
+        else if (c < 0x20 || c >= 0x7f)
+        {
+            //Octal escapes end after three digits, a following digit cannot extend them like a hex escape.
+            char escape[5];
+            snprintf(escape, sizeof(escape), "\\%03o", c);
+            result += escape;
+        }
+        else
+        {
+            result += text[i];
+        }
+    }
+    return result + "\"";
+}
+
+string StubGenerator::GetSignature(const Procedure &procedure)
+{
+    vector<string> names;
+    vector<jsontype_t> types;
+    GetParameters(procedure, names, types);
+
+    string result = (procedure.GetProcedureType() == RPC_METHOD) ? GetNativeType(procedure.GetReturnType()) : "void";
+    result += " " + ToIdentifier(procedure.GetProcedureName()) + "(";
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (i > 0)
+            result += ", ";
+        result += GetParameterType(types[i]) + " " + ToIdentifier(names[i]);
+    }
+    return result + ")";
+}
+
+string StubGenerator::GetConstruction(const Procedure &procedure)
+{
+    vector<string> names;
+    vector<jsontype_t> types;
+    GetParameters(procedure, names, types);
+
+    string result = "jsonrpc::Procedure(" + ToLiteral(procedure.GetProcedureName()) + ", ";
+    result += (procedure.GetParameterDeclarationType() == PARAMS_BY_NAME) ? "jsonrpc::PARAMS_BY_NAME" : "jsonrpc::PARAMS_BY_POSITION";
+    if (procedure.GetProcedureType() == RPC_METHOD)
+        result += ", " + GetJsonType(procedure.GetReturnType());
+    for (size_t i = 0; i < names.size(); i++)
+        result += ", " + ToLiteral(names[i]) + ", " + GetJsonType(types[i]);
+    return result + ", NULL)";
+}
+
+void StubGenerator::CheckIdentifiers() throw (JsonRpcException)
+{
+    set<string> procedureNames;
+    for (size_t i = 0; i < this->procedures.size(); i++)
+    {
+        const string &name = this->procedures[i].GetProcedureName();
+        if (!procedureNames.insert(ToIdentifier(name)).second)
+            throw JsonRpcException(Errors::ERROR_SERVER_PROCEDURE_SPECIFICATION_SYNTAX, "Procedurename not unique as identifier: " + name);
+
+        vector<string> names;
+        vector<jsontype_t> types;
+        GetParameters(this->procedures[i], names, types);
+        set<string> parameterNames;
+        for (size_t j = 0; j < names.size(); j++)
+        {
+            if (!parameterNames.insert(ToIdentifier(names[j])).second)
+                throw JsonRpcException(Errors::ERROR_SERVER_PROCEDURE_SPECIFICATION_SYNTAX, "Parametername not unique as identifier: " + name + "." + names[j]);
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/*************************************************************************
+ * libjson-rpc-cpp
+ *************************************************************************
+ * @file    stubgenerator.h
+ * @date    17.10.2026
+ * @license See attached LICENSE.txt
+ ************************************************************************/
+
+#ifndef JSONRPC_CPP_STUBGENERATOR_H_
+#define JSONRPC_CPP_STUBGENERATOR_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <jsonrpccpp/common/procedure.h>
+#include <jsonrpccpp/common/exception.h>
+
+namespace jsonrpc
+{
+    /**
+     * Writes one C++ header with a typed stub class for the procedures of a specification.
+     *
+     * Parameters and results of type string, boolean, integer and real are passed as std::string, bool, int and double,
+     * objects and arrays as Json::Value. Procedure and parameter names that are not C++ identifiers are made into one
+     * by replacing the invalid characters with '_'.
+     */
+    class StubGenerator
+    {
+        public:
+            /**
+             * @param stubname - the name of the generated class, it may be qualified by namespaces like ns::Stub.
+             */
+            StubGenerator(const std::string& stubname, const std::vector<Procedure>& procedures, std::ostream& out);
+            virtual ~StubGenerator();
+
+            /**
+             * @throw JsonRpcException if two procedures or two parameters of a procedure get the same identifier.
+             */
+            void Generate() throw (JsonRpcException);
+
+            /**
+             * @return the default file name of a stub, the lower case class name with ".h" appended.
+             */
+            static std::string GetFileName(const std::string& stubname);
+
+        protected:
+            const std::vector<Procedure>& procedures;
+
+            virtual void WriteStub() = 0;
+
+            const std::string& GetClassName() const;
+
+            void WriteLine(const std::string& line);
+            void Indent();
+            void Unindent();
+
+            void WriteHeaderBegin(const std::string& include);
+            void WriteHeaderEnd();
+
+            /**
+             * @brief Collects the parameters of a procedure in the order of the generated signatures.
+             * Named parameters are sorted by name, positional parameters are called param1, param2, ...
+             */
+            static void GetParameters(const Procedure& procedure, std::vector<std::string>& names, std::vector<jsontype_t>& types);
+
+            static std::string ToIdentifier(const std::string& name);
+            static std::string GetNativeType(jsontype_t type);
+            static std::string GetParameterType(jsontype_t type);
+            static std::string GetJsonType(jsontype_t type);
+            static std::string GetConversion(jsontype_t type);
+            static std::string GetTypeCheck(jsontype_t type);
+            static std::string ToLiteral(const std::string& text);
+
+            /**
+             * @return the declaration of a stub method, e.g. "std::string sayHello(const std::string& name)".
+             */
+            static std::string GetSignature(const Procedure& procedure);
+
+            /**
+             * @return an expression constructing procedure, without its serialized flag.
+             */
+            static std::string GetConstruction(const Procedure& procedure);
+
+        private:
+            std::string classname;
+            std::vector<std::string> namespaces;
+            std::ostream &out;
+            int indentation;
+
+            void CheckIdentifiers() throw (JsonRpcException);
+
+            StubGenerator(const StubGenerator&);
+            StubGenerator& operator=(const StubGenerator&);
+    };
+
+} /* namespace jsonrpc */
+#endif /* JSONRPC_CPP_STUBGENERATOR_H_ */